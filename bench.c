@@ -0,0 +1,479 @@
+// Benchmarks for the dynamic buffer hot paths
+//
+// Usage: benchmarks [--format csv|json] [--filter substring] [--min-time ms]
+//
+// Each benchmark is run at several sizes. The iteration count doubles until a
+// run takes at least --min-time (100 ms by default), and one row is printed
+// per benchmark and size:
+//   name,size,iterations,ns_per_op,mb_per_s,atomic_refcount
+//
+// clock_gettime needs POSIX, but strict _POSIX_C_SOURCE would also hide the
+// mmap extensions the library uses, so ask for the default feature set.
+#if !defined(_WIN32) && !defined(_DEFAULT_SOURCE)
+#define _DEFAULT_SOURCE
+#endif
+#ifndef DB_IMPLEMENTATION
+#define DB_IMPLEMENTATION
+#endif
+#include "dynamic_buffer.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Keeps results alive so the compiler can't drop the measured work
+static volatile uint64_t bench_sink;
+
+static double bench_now_ns(void) {
+#ifdef _WIN32
+    LARGE_INTEGER freq, now;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&now);
+    return (double)now.QuadPart * 1e9 / (double)freq.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+#endif
+}
+
+// Timed region of the current run; setup and teardown stay outside it
+static double bench_start_ns;
+static double bench_elapsed_ns;
+
+static void bench_begin(void) {
+    bench_start_ns = bench_now_ns();
+}
+
+static void bench_end(void) {
+    bench_elapsed_ns = bench_now_ns() - bench_start_ns;
+}
+
+// Set when a case can't run (e.g. its input file can't be opened)
+static bool bench_skipped;
+
+static void bench_skip(void) {
+    bench_elapsed_ns = 0;
+    bench_skipped = true;
+}
+
+static db_buffer bench_pattern(size_t size) {
+    uint8_t* bytes = (uint8_t*)malloc(size ? size : 1);
+    for (size_t i = 0; i < size; i++) {
+        bytes[i] = (uint8_t)(i * 131 + 7);
+    }
+    db_buffer buf = db_new_with_data(bytes, size);
+    free(bytes);
+    return buf;
+}
+
+// Benchmarks
+//
+// Each one runs its operation `iterations` times on inputs of `size` bytes
+// between bench_begin() and bench_end(), and returns the number of payload
+// bytes processed per iteration (0 when throughput is not meaningful).
+
+static size_t bench_new_release(size_t size, size_t iterations) {
+    bench_begin();
+    for (size_t i = 0; i < iterations; i++) {
+        db_buffer buf = db_new(size);
+        buf[0] = (char)i;  // Touch the memory like a read would
+        bench_sink += (uint8_t)buf[0];
+        db_release(&buf);
+    }
+    bench_end();
+    return 0;
+}
+
+static size_t bench_pool_acquire_release(size_t size, size_t iterations) {
+    // Same churn as new_release, recycled through a pool
+    db_pool_config config = {size, 1, 4, 4};
+    db_pool pool = db_pool_new(&config);
+    bench_begin();
+    for (size_t i = 0; i < iterations; i++) {
+        db_buffer buf = db_pool_acquire(pool);
+        buf[0] = (char)i;
+        bench_sink += (uint8_t)buf[0];
+        db_release(&buf);
+    }
+    bench_end();
+    db_pool_release(&pool);
+    return 0;
+}
+
+static size_t bench_retain_release(size_t size, size_t iterations) {
+    db_buffer buf = db_new(size);
+    bench_begin();
+    for (size_t i = 0; i < iterations; i++) {
+        db_buffer ref = db_retain(buf);
+        bench_sink += (uint64_t)db_refcount(ref);
+        db_release(&ref);
+    }
+    bench_end();
+    db_release(&buf);
+    return 0;
+}
+
+static size_t bench_slice(size_t size, size_t iterations) {
+    db_buffer buf = bench_pattern(size);
+    bench_begin();
+    for (size_t i = 0; i < iterations; i++) {
+        db_buffer slice = db_slice(buf, size / 4, size / 2);
+        bench_sink += db_size(slice);
+        db_release(&slice);
+    }
+    bench_end();
+    db_release(&buf);
+    return size / 2;
+}
+
+static size_t bench_append(size_t size, size_t iterations) {
+    // Grow a buffer to `size` bytes through 16 immutable appends; each one
+    // copies the buffer so far, so small per-append chunks would go quadratic
+    size_t chunk_size = size / 16 ? size / 16 : 1;
+    db_buffer chunk = bench_pattern(chunk_size);
+    bench_begin();
+    for (size_t i = 0; i < iterations; i++) {
+        db_buffer buf = db_new(0);
+        for (size_t k = 0; k < 16; k++) {
+            db_buffer next = db_append(buf, chunk, chunk_size);
+            db_release(&buf);
+            buf = next;
+        }
+        bench_sink += db_size(buf);
+        db_release(&buf);
+    }
+    bench_end();
+    db_release(&chunk);
+    return chunk_size * 16;
+}
+
+static size_t bench_append_inplace(size_t size, size_t iterations) {
+    static const char chunk[16] = "0123456789abcdef";
+    size_t steps = size / 16 ? size / 16 : 1;
+    bench_begin();
+    for (size_t i = 0; i < iterations; i++) {
+        db_buffer buf = db_new(0);
+        for (size_t k = 0; k < steps; k++) {
+            db_append_inplace(&buf, chunk, sizeof(chunk));
+        }
+        bench_sink += db_size(buf);
+        db_release(&buf);
+    }
+    bench_end();
+    return steps * 16;
+}
+
+static size_t bench_concat_many(size_t size, size_t iterations) {
+    db_buffer parts[8];
+    for (size_t k = 0; k < 8; k++) parts[k] = bench_pattern(size / 8);
+    bench_begin();
+    for (size_t i = 0; i < iterations; i++) {
+        db_buffer joined = db_concat_many(parts, 8);
+        bench_sink += db_size(joined);
+        db_release(&joined);
+    }
+    bench_end();
+    for (size_t k = 0; k < 8; k++) db_release(&parts[k]);
+    return (size / 8) * 8;
+}
+
+#if DB_THREAD_POOL
+// Splits 1 MiB inputs into four chunks
+static size_t bench_concat_many_parallel(size_t size, size_t iterations) {
+    static db_thread_pool pool;
+    if (!pool) pool = db_thread_pool_new(0);
+    db_parallel_config config = {0};
+    config.executor = db_thread_pool_executor(pool);
+    config.threshold = 256 * 1024;
+    config.chunk_size = 256 * 1024;
+    
+    db_buffer parts[8];
+    for (size_t k = 0; k < 8; k++) parts[k] = bench_pattern(size / 8);
+    bench_begin();
+    for (size_t i = 0; i < iterations; i++) {
+        db_buffer joined = db_concat_many_parallel(parts, 8, &config);
+        bench_sink += db_size(joined);
+        db_release(&joined);
+    }
+    bench_end();
+    for (size_t k = 0; k < 8; k++) db_release(&parts[k]);
+    return (size / 8) * 8;
+}
+#endif
+
+#define BENCH_BUILDER(name, width, call)                                  \
+    static size_t name(size_t size, size_t iterations) {                  \
+        size_t count = size / (width) ? size / (width) : 1;               \
+        bench_begin();                                                    \
+        for (size_t i = 0; i < iterations; i++) {                         \
+            db_builder builder = db_builder_new(size);                    \
+            for (size_t k = 0; k < count; k++) call;                      \
+            db_buffer buf = db_builder_finish(&builder);                  \
+            bench_sink += db_size(buf);                                   \
+            db_release(&buf);                                             \
+        }                                                                 \
+        bench_end();                                                      \
+        return count * (width);                                           \
+    }
+
+BENCH_BUILDER(bench_builder_uint8, 1, db_builder_append_uint8(builder, (uint8_t)k))
+BENCH_BUILDER(bench_builder_uint16_le, 2, db_builder_append_uint16_le(builder, (uint16_t)k))
+BENCH_BUILDER(bench_builder_uint32_be, 4, db_builder_append_uint32_be(builder, (uint32_t)k))
+BENCH_BUILDER(bench_builder_uint64_le, 8, db_builder_append_uint64_le(builder, (uint64_t)k))
+BENCH_BUILDER(bench_builder_varint, 2, db_builder_append_varint_u64(builder, (uint64_t)k & 0x3FFF))
+
+#define BENCH_READER(name, width, call)                                   \
+    static size_t name(size_t size, size_t iterations) {                  \
+        size_t count = size / (width);                                    \
+        db_buffer buf = bench_pattern(count * (width));                   \
+        uint64_t sum = 0;                                                 \
+        bench_begin();                                                    \
+        for (size_t i = 0; i < iterations; i++) {                         \
+            db_reader reader = db_reader_new(buf);                        \
+            for (size_t k = 0; k < count; k++) sum += call;               \
+            db_reader_release(&reader);                                   \
+        }                                                                 \
+        bench_end();                                                      \
+        bench_sink += sum;                                                \
+        db_release(&buf);                                                 \
+        return count * (width);                                           \
+    }
+
+BENCH_READER(bench_read_uint8, 1, db_read_uint8(reader))
+BENCH_READER(bench_read_uint16_le, 2, db_read_uint16_le(reader))
+BENCH_READER(bench_read_uint32_be, 4, db_read_uint32_be(reader))
+BENCH_READER(bench_read_uint64_le, 8, db_read_uint64_le(reader))
+
+static size_t bench_read_uint32_be_array(size_t size, size_t iterations) {
+    size_t count = size / 4;
+    db_buffer buf = bench_pattern(count * 4);
+    uint32_t* values = (uint32_t*)malloc(count * sizeof(uint32_t) + 1);
+    bench_begin();
+    for (size_t i = 0; i < iterations; i++) {
+        db_reader reader = db_reader_new(buf);
+        db_read_uint32_be_array(reader, values, count);
+        bench_sink += count ? values[count - 1] : 0;
+        db_reader_release(&reader);
+    }
+    bench_end();
+    free(values);
+    db_release(&buf);
+    return count * 4;
+}
+
+static size_t bench_to_hex(size_t size, size_t iterations) {
+    db_buffer buf = bench_pattern(size);
+    bench_begin();
+    for (size_t i = 0; i < iterations; i++) {
+        db_buffer hex = db_to_hex(buf, false);
+        bench_sink += db_size(hex);
+        db_release(&hex);
+    }
+    bench_end();
+    db_release(&buf);
+    return size;
+}
+
+static size_t bench_to_base64(size_t size, size_t iterations) {
+    db_buffer buf = bench_pattern(size);
+    bench_begin();
+    for (size_t i = 0; i < iterations; i++) {
+        db_buffer text = db_to_base64(buf, DB_BASE64_STANDARD);
+        bench_sink += db_size(text);
+        db_release(&text);
+    }
+    bench_end();
+    db_release(&buf);
+    return size;
+}
+
+static size_t bench_from_base64(size_t size, size_t iterations) {
+    db_buffer buf = bench_pattern(size);
+    db_buffer text = db_to_base64(buf, DB_BASE64_STANDARD);
+    bench_begin();
+    for (size_t i = 0; i < iterations; i++) {
+        db_buffer bytes = db_from_base64(text, db_size(text), DB_BASE64_STANDARD);
+        bench_sink += db_size(bytes);
+        db_release(&bytes);
+    }
+    bench_end();
+    db_release(&text);
+    db_release(&buf);
+    return size;
+}
+
+static size_t bench_from_hex(size_t size, size_t iterations) {
+    db_buffer buf = bench_pattern(size);
+    db_buffer hex = db_to_hex(buf, false);
+    bench_begin();
+    for (size_t i = 0; i < iterations; i++) {
+        db_buffer bytes = db_from_hex(hex, db_size(hex));
+        bench_sink += db_size(bytes);
+        db_release(&bytes);
+    }
+    bench_end();
+    db_release(&hex);
+    db_release(&buf);
+    return size;
+}
+
+static const char* bench_file_path(void) {
+    return "db_bench_input.bin";
+}
+
+static void bench_write_input(size_t size) {
+    db_buffer buf = bench_pattern(size);
+    db_write_file(buf, bench_file_path());
+    db_release(&buf);
+}
+
+static size_t bench_read_file(size_t size, size_t iterations) {
+    bench_write_input(size);
+    bench_begin();
+    for (size_t i = 0; i < iterations; i++) {
+        db_buffer buf = db_read_file(bench_file_path());
+        bench_sink += buf ? db_size(buf) : 0;
+        db_release(&buf);
+    }
+    bench_end();
+    remove(bench_file_path());
+    return size;
+}
+
+#ifndef _WIN32
+static size_t bench_read_fd(size_t size, size_t iterations) {
+    bench_write_input(size);
+    int fd = open(bench_file_path(), O_RDONLY);
+    if (fd < 0) {
+        bench_skip();
+        remove(bench_file_path());
+        return size;
+    }
+    bench_begin();
+    for (size_t i = 0; i < iterations; i++) {
+        lseek(fd, 0, SEEK_SET);
+        db_buffer buf = db_new(0);
+        while (db_read_fd(&buf, fd, 65536) > 0) {
+        }
+        bench_sink += db_size(buf);
+        db_release(&buf);
+    }
+    bench_end();
+    close(fd);
+    remove(bench_file_path());
+    return size;
+}
+#endif
+
+typedef size_t (*bench_fn)(size_t size, size_t iterations);
+
+typedef struct bench_case {
+    const char* name;
+    bench_fn fn;
+} bench_case;
+
+static const bench_case bench_cases[] = {
+    {"new_release", bench_new_release},
+    {"pool_acquire_release", bench_pool_acquire_release},
+    {"retain_release", bench_retain_release},
+    {"slice", bench_slice},
+    {"append", bench_append},
+    {"append_inplace", bench_append_inplace},
+    {"concat_many", bench_concat_many},
+#if DB_THREAD_POOL
+    {"concat_many_parallel", bench_concat_many_parallel},
+#endif
+    {"builder_uint8", bench_builder_uint8},
+    {"builder_uint16_le", bench_builder_uint16_le},
+    {"builder_uint32_be", bench_builder_uint32_be},
+    {"builder_uint64_le", bench_builder_uint64_le},
+    {"builder_varint", bench_builder_varint},
+    {"read_uint8", bench_read_uint8},
+    {"read_uint16_le", bench_read_uint16_le},
+    {"read_uint32_be", bench_read_uint32_be},
+    {"read_uint64_le", bench_read_uint64_le},
+    {"read_uint32_be_array", bench_read_uint32_be_array},
+    {"to_hex", bench_to_hex},
+    {"from_hex", bench_from_hex},
+    {"to_base64", bench_to_base64},
+    {"from_base64", bench_from_base64},
+    {"read_file", bench_read_file},
+#ifndef _WIN32
+    {"read_fd", bench_read_fd},
+#endif
+};
+
+static const size_t bench_sizes[] = {16, 256, 4096, 65536, 1048576};
+
+int main(int argc, char** argv) {
+    bool json = false;
+    const char* filter = NULL;
+    double min_time_ns = 100e6;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+            json = strcmp(argv[++i], "json") == 0;
+        } else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (strcmp(argv[i], "--min-time") == 0 && i + 1 < argc) {
+            min_time_ns = atof(argv[++i]) * 1e6;
+        } else {
+            fprintf(stderr, "usage: %s [--format csv|json] [--filter substring] [--min-time ms]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    if (json) {
+        printf("{\"version\": \"%s\", \"atomic_refcount\": %d, \"results\": [", DB_VERSION_STRING, DB_ATOMIC_REFCOUNT);
+    } else {
+        printf("name,size,iterations,ns_per_op,mb_per_s,atomic_refcount\n");
+    }
+
+    bool first = true;
+    for (size_t c = 0; c < sizeof(bench_cases) / sizeof(bench_cases[0]); c++) {
+        const bench_case* bc = &bench_cases[c];
+        if (filter && !strstr(bc->name, filter)) continue;
+
+        for (size_t s = 0; s < sizeof(bench_sizes) / sizeof(bench_sizes[0]); s++) {
+            size_t size = bench_sizes[s];
+            size_t iterations = 1;
+            size_t bytes = 0;
+            double elapsed = 0;
+
+            // Double the iteration count until one run is long enough to time
+            bench_skipped = false;
+            for (;;) {
+                bytes = bc->fn(size, iterations);
+                elapsed = bench_elapsed_ns;
+                if (bench_skipped || elapsed >= min_time_ns || iterations >= ((size_t)1 << 40)) break;
+                iterations *= 2;
+            }
+
+            // Skipped cases report zero iterations and timings
+            if (bench_skipped) iterations = 0;
+            double ns_per_op = iterations ? elapsed / (double)iterations : 0.0;
+            double mb_per_s = bytes && iterations ? (double)bytes * (double)iterations / (elapsed / 1e9) / 1e6 : 0.0;
+
+            if (json) {
+                printf("%s\n  {\"name\": \"%s\", \"size\": %zu, \"iterations\": %zu, "
+                       "\"ns_per_op\": %.2f, \"mb_per_s\": %.2f}",
+                       first ? "" : ",", bc->name, size, iterations, ns_per_op, mb_per_s);
+            } else {
+                printf("%s,%zu,%zu,%.2f,%.2f,%d\n", bc->name, size, iterations, ns_per_op, mb_per_s,
+                       DB_ATOMIC_REFCOUNT);
+            }
+            first = false;
+            fflush(stdout);
+        }
+    }
+
+    if (json) printf("\n]}\n");
+    return 0;
+}
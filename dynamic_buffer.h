@@ -18,6 +18,14 @@
  * #define DB_FREE free             // custom deallocator
  * #define DB_ASSERT assert         // custom assert macro
  * #define DB_ATOMIC_REFCOUNT 1     // enable atomic reference counting (C11)
+ * #define DB_LOCAL_REFCOUNT 1      // plain refcounts until db_share() (needs DB_ATOMIC_REFCOUNT)
+ * #define DB_THREAD_LOCAL _Thread_local  // thread-local storage specifier
+ * #define DB_CACHE_HASH 1          // cache db_hash() in the buffer header
+ * #define DB_COMPACT_HEADER 1      // 32-bit size/capacity: 16-byte headers, buffers < 4 GiB
+ * #define DB_STATS 1               // per-thread allocation and copy counters
+ * #define DB_THREAD_POOL 1         // built-in pthread pool for the parallel operations
+ * #define DB_NO_SIMD               // disable SSE2/AVX2/NEON kernels
+ * #define DB_IO_URING 1            // io_uring backend (Linux, GNU/POSIX mode)
  *
  * #define DB_IMPLEMENTATION
  * #include "dynamic_buffer.h"
@@ -97,6 +105,7 @@
 typedef long ssize_t;
 #else
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <unistd.h>
 #endif
 
@@ -121,6 +130,19 @@ typedef long ssize_t;
 #define DB_ASSERT assert
 #endif
 
+// Thread-local storage (used for per-thread allocator caches)
+#ifndef DB_THREAD_LOCAL
+#if defined(_MSC_VER)
+#define DB_THREAD_LOCAL __declspec(thread)
+#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+#define DB_THREAD_LOCAL _Thread_local
+#elif defined(__GNUC__)
+#define DB_THREAD_LOCAL __thread
+#else
+#define DB_THREAD_LOCAL
+#endif
+#endif
+
 // Atomic reference counting support (requires C11)
 #ifndef DB_ATOMIC_REFCOUNT
 #define DB_ATOMIC_REFCOUNT 0
@@ -132,15 +154,93 @@ typedef _Atomic int db_refcount_t;
 #define DB_REFCOUNT_INIT(n) ATOMIC_VAR_INIT(n)
 #define DB_REFCOUNT_LOAD(ptr) atomic_load(ptr)
 #define DB_REFCOUNT_INCREMENT(ptr) (atomic_fetch_add(ptr, 1) + 1)
+#define DB_REFCOUNT_RETAIN(ptr) ((void)atomic_fetch_add(ptr, 1))
 #define DB_REFCOUNT_DECREMENT(ptr) (atomic_fetch_sub(ptr, 1) - 1)
 #else
 typedef int db_refcount_t;
 #define DB_REFCOUNT_INIT(n) (n)
 #define DB_REFCOUNT_LOAD(ptr) (*(ptr))
 #define DB_REFCOUNT_INCREMENT(ptr) (++(*(ptr)))
+#define DB_REFCOUNT_RETAIN(ptr) ((void)++(*(ptr)))
 #define DB_REFCOUNT_DECREMENT(ptr) (--(*(ptr)))
 #endif
 
+// Thread-local buffer refcounts: atomic only after db_share()
+#ifndef DB_LOCAL_REFCOUNT
+#define DB_LOCAL_REFCOUNT 0
+#endif
+
+#if !DB_ATOMIC_REFCOUNT
+#undef DB_LOCAL_REFCOUNT
+#define DB_LOCAL_REFCOUNT 0  // Every refcount is already a plain integer
+#endif
+
+// Cached hash support (adds 8 bytes to every buffer header)
+#ifndef DB_CACHE_HASH
+#define DB_CACHE_HASH 0
+#endif
+
+#if DB_CACHE_HASH
+#if DB_ATOMIC_REFCOUNT
+typedef _Atomic uint64_t db_hash_t;
+#define DB_HASH_LOAD(ptr) atomic_load_explicit(ptr, memory_order_relaxed)
+#define DB_HASH_STORE(ptr, value) atomic_store_explicit(ptr, value, memory_order_relaxed)
+#else
+typedef uint64_t db_hash_t;
+#define DB_HASH_LOAD(ptr) (*(ptr))
+#define DB_HASH_STORE(ptr, value) (*(ptr) = (value))
+#endif
+#define DB_HASH_RESET(meta) DB_HASH_STORE(&(meta)->hash, 0)
+#else
+#define DB_HASH_RESET(meta) ((void)0)
+#endif
+
+// Compact buffer headers: 32-bit size and capacity (saves 8 bytes per buffer on LP64)
+#ifndef DB_COMPACT_HEADER
+#define DB_COMPACT_HEADER 0
+#endif
+
+#if DB_COMPACT_HEADER
+typedef uint32_t db_length_t;
+#define DB_MAX_CAPACITY ((size_t)UINT32_MAX)  ///< Largest capacity a buffer can have
+#else
+typedef size_t db_length_t;
+#define DB_MAX_CAPACITY SIZE_MAX              ///< Largest capacity a buffer can have
+#endif
+
+// io_uring backend (Linux only)
+#ifndef DB_IO_URING
+#define DB_IO_URING 0
+#endif
+
+#if DB_IO_URING && !defined(__linux__)
+#undef DB_IO_URING
+#define DB_IO_URING 0
+#endif
+
+// syscall() is only declared in GNU/BSD mode; strict ISO or plain POSIX builds
+// (-std=c11, _POSIX_C_SOURCE alone) go without the backend
+#if DB_IO_URING && !defined(_GNU_SOURCE) && !defined(_DEFAULT_SOURCE) && !defined(_BSD_SOURCE) && \
+    (defined(__STRICT_ANSI__) || defined(_POSIX_C_SOURCE) || defined(_XOPEN_SOURCE) || defined(_POSIX_SOURCE))
+#undef DB_IO_URING
+#define DB_IO_URING 0
+#endif
+
+// Allocation and copy counters (see db_stats_snapshot)
+#ifndef DB_STATS
+#define DB_STATS 0
+#endif
+
+// Built-in pthread pool for the parallel bulk operations (POSIX only)
+#ifndef DB_THREAD_POOL
+#define DB_THREAD_POOL 0
+#endif
+
+#if DB_THREAD_POOL && defined(_WIN32)
+#undef DB_THREAD_POOL
+#define DB_THREAD_POOL 0
+#endif
+
 // Function visibility control
 #ifndef DB_DEF
 #ifdef DB_IMPLEMENTATION
@@ -167,6 +267,9 @@ typedef int db_refcount_t;
  *                                        ^
  *                         db_buffer points here
  *
+ * With DB_COMPACT_HEADER size and capacity are 32-bit, so the header takes
+ * 16 bytes instead of 24 on LP64 and buffers are limited to DB_MAX_CAPACITY.
+ *
  * @note Use directly with memcpy, write, etc. - no conversion needed!
  * @note NULL represents an invalid/empty buffer handle
  */
@@ -182,6 +285,7 @@ typedef char* db_buffer;
  * @brief Create a new empty buffer with specified capacity
  * @param capacity Initial capacity in bytes (0 for minimal allocation)
  * @return New buffer instance (asserts on allocation failure)
+ * @note Capacity is limited to DB_MAX_CAPACITY (4 GiB - 1 with DB_COMPACT_HEADER)
  */
 DB_DEF db_buffer db_new(size_t capacity);
 
@@ -212,6 +316,44 @@ DB_DEF db_buffer db_new_with_data(const void* data, size_t size);
  */
 DB_DEF db_buffer db_new_from_owned_data(void* data, size_t size, size_t capacity);
 
+/**
+ * @brief Number of bytes reserved in front of the data of an external block
+ *
+ * Memory handed to db_new_from_external() must start with this many bytes of
+ * scratch space, followed by the data. The library stores the buffer metadata
+ * there so the returned db_buffer can point straight at the caller's data.
+ */
+#define DB_EXTERNAL_HEADER_SIZE 64
+
+/**
+ * @brief Callback used to free an external block
+ * @param block Start of the block passed to db_new_from_external()
+ * @param user User pointer passed to db_new_from_external()
+ */
+typedef void (*db_free_fn)(void* block, void* user);
+
+/**
+ * @brief Create a buffer that takes ownership of caller-allocated memory (no copy)
+ * @param block Start of the caller's block (must not be NULL). The data lives at
+ *              block + DB_EXTERNAL_HEADER_SIZE; the block must be at least
+ *              DB_EXTERNAL_HEADER_SIZE + capacity bytes long
+ * @param size Number of valid data bytes
+ * @param capacity Number of data bytes available in the block (must be >= size)
+ * @param free_fn Called with (block, user) when the last reference is released
+ *                (can be NULL if the memory must not be freed)
+ * @param user User pointer passed to free_fn
+ * @return New buffer pointing at block + DB_EXTERNAL_HEADER_SIZE
+ * @note Ownership transfer is O(1): the data is neither copied nor moved.
+ *
+ * @par Example:
+ * @code
+ * char* block = malloc(DB_EXTERNAL_HEADER_SIZE + max_out);
+ * size_t out_len = decompress(input, block + DB_EXTERNAL_HEADER_SIZE, max_out);
+ * db_buffer buf = db_new_from_external(block, out_len, max_out, free_block, NULL);
+ * @endcode
+ */
+DB_DEF db_buffer db_new_from_external(void* block, size_t size, size_t capacity, db_free_fn free_fn, void* user);
+
 /**
  * @brief Increase reference count (share ownership)
  * @param buf Buffer to retain (can be NULL)
@@ -225,6 +367,259 @@ DB_DEF db_buffer db_retain(db_buffer buf);
  */
 DB_DEF void db_release(db_buffer* buf_ptr);
 
+/**
+ * @brief Mark a buffer as used by more than one thread
+ * @param buf Buffer to share (must not be NULL)
+ * @return The same buffer for convenience
+ *
+ * With DB_LOCAL_REFCOUNT=1, new buffers count references with plain loads
+ * and stores, which is only safe while the buffer stays on the thread that
+ * created it. db_share() switches the buffer to atomic counting for the rest
+ * of its life. Call it before another thread can see the buffer, for example
+ * `queue_push(db_retain(db_share(buf)))`.
+ *
+ * @note Without DB_LOCAL_REFCOUNT every buffer already uses the build's
+ *       refcount mode, and db_share() does nothing.
+ */
+DB_DEF db_buffer db_share(db_buffer buf);
+
+/**
+ * @brief Check whether a buffer uses atomic reference counting
+ * @param buf Buffer to check (must not be NULL)
+ * @return true if retain/release on buf are safe from any thread
+ */
+DB_DEF bool db_is_shared(db_buffer buf);
+
+/** @} */
+
+/**
+ * @defgroup allocation Custom Allocation
+ * @brief Runtime allocator interface for buffer storage
+ *
+ * Buffers created through the *_ex constructors keep a pointer to their
+ * allocator in front of the metadata and return their block to it when
+ * the last reference is released. Passing NULL selects the default
+ * DB_MALLOC/DB_REALLOC/DB_FREE allocator.
+ *
+ * Buffers derived from an allocator-backed buffer (db_slice, db_append,
+ * db_concat, db_concat_many) are allocated from the source's allocator.
+ * @{
+ */
+
+/**
+ * @brief Allocator callbacks used for buffer storage
+ *
+ * All sizes are the full block sizes requested by the library, so
+ * allocators that need the size on free (size-class pools, arenas)
+ * don't have to store it themselves.
+ */
+typedef struct db_allocator {
+    void* (*alloc)(void* user, size_t size);                                  ///< Allocate a block (NULL on failure)
+    void* (*realloc)(void* user, void* ptr, size_t old_size, size_t new_size); ///< Resize a block (may be NULL)
+    void (*free)(void* user, void* ptr, size_t size);                         ///< Free a block
+    void* user;                                                               ///< User pointer passed to callbacks
+} db_allocator;
+
+/**
+ * @brief Create a new empty buffer using a custom allocator
+ * @param capacity Initial capacity in bytes
+ * @param allocator Allocator to use (NULL for the default allocator)
+ * @return New buffer instance (asserts on allocation failure)
+ * @note The allocator must outlive every buffer allocated from it
+ */
+DB_DEF db_buffer db_new_ex(size_t capacity, const db_allocator* allocator);
+
+/**
+ * @brief Create a new buffer initialized with data using a custom allocator
+ * @param data Pointer to source data (can be NULL if size is 0)
+ * @param size Number of bytes to copy
+ * @param allocator Allocator to use (NULL for the default allocator)
+ * @return New buffer instance (asserts on allocation failure)
+ */
+DB_DEF db_buffer db_new_with_data_ex(const void* data, size_t size, const db_allocator* allocator);
+
+/**
+ * @brief Get the built-in size-class pool allocator for small buffers
+ * @return Shared allocator instance (never NULL)
+ *
+ * Blocks are rounded up to a small set of size classes and recycled through
+ * per-thread free lists, so steady-state allocation of small buffers does not
+ * reach DB_MALLOC/DB_FREE at all. Blocks larger than the biggest class fall
+ * through to DB_MALLOC. Blocks freed on another thread join that thread's
+ * free lists.
+ *
+ * @par Example:
+ * @code
+ * const db_allocator* pool = db_small_pool_allocator();
+ * db_buffer msg = db_new_ex(256, pool);
+ * db_release(&msg);  // block goes back to this thread's free list
+ * @endcode
+ */
+DB_DEF const db_allocator* db_small_pool_allocator(void);
+
+/**
+ * @brief Free all blocks cached by the calling thread's small-pool free lists
+ * @note Call before a thread exits to return its cached blocks to DB_FREE
+ */
+DB_DEF void db_small_pool_trim(void);
+
+/**
+ * @brief Opaque arena handle for request-scoped allocation
+ *
+ * An arena hands out memory by bumping a pointer through large chunks.
+ * Releasing an arena buffer only drops its reference count; the memory
+ * is reclaimed all at once by db_arena_reset() or db_arena_release().
+ */
+typedef struct db_arena_internal* db_arena;
+
+/**
+ * @brief Create a new arena
+ * @param chunk_size Size of each backing chunk in bytes (0 for the 64 KiB default)
+ * @return New arena instance (asserts on allocation failure)
+ *
+ * @par Example:
+ * @code
+ * db_arena arena = db_arena_new(0);
+ * const db_allocator* a = db_arena_allocator(arena);
+ *
+ * db_buffer request = db_new_with_data_ex(bytes, len, a);
+ * db_buffer body = db_slice_from(request, header_len);  // also from the arena
+ * handle(body);
+ * db_release(&body);
+ * db_release(&request);
+ *
+ * db_arena_reset(arena);  // reclaim everything from this request
+ * @endcode
+ */
+DB_DEF db_arena db_arena_new(size_t chunk_size);
+
+/**
+ * @brief Get the allocator that allocates from an arena
+ * @param arena Arena instance (must not be NULL)
+ * @return Allocator to pass to db_new_ex(), db_builder_new_ex(), etc.
+ */
+DB_DEF const db_allocator* db_arena_allocator(db_arena arena);
+
+/**
+ * @brief Reclaim all memory handed out by the arena
+ * @param arena Arena instance (must not be NULL)
+ * @note O(1): chunks are kept for reuse. Only allocations larger than the
+ *       chunk size, which get their own blocks, are freed individually.
+ * @warning Every buffer allocated from the arena becomes invalid, whatever
+ *          its reference count
+ */
+DB_DEF void db_arena_reset(db_arena arena);
+
+/**
+ * @brief Get number of bytes currently handed out by the arena
+ * @param arena Arena instance (must not be NULL)
+ * @return Bytes in use, including buffer metadata
+ */
+DB_DEF size_t db_arena_used(db_arena arena);
+
+/**
+ * @brief Free the arena and all of its memory
+ * @param arena_ptr Pointer to arena variable (will be set to NULL)
+ * @warning Every buffer allocated from the arena becomes invalid
+ */
+DB_DEF void db_arena_release(db_arena* arena_ptr);
+
+/**
+ * @brief Opaque pool of same-capacity buffers that are recycled on release
+ *
+ * Pool buffers are ordinary allocator-backed buffers. When the last
+ * reference is released, db_release() hands the block back to the pool
+ * rather than to DB_FREE, and the next db_pool_acquire() reuses it with
+ * its pages already faulted in.
+ */
+typedef struct db_pool_internal* db_pool;
+
+/**
+ * @brief Pool sizing
+ *
+ * Idle blocks are kept in a shared list of at most high_watermark blocks,
+ * plus up to thread_cache blocks per thread that are reused without taking
+ * the shared list's lock. Blocks released beyond those limits are freed,
+ * so a pool's idle memory stays bounded.
+ */
+typedef struct db_pool_config {
+    size_t buffer_capacity;   ///< Capacity of every pool buffer in bytes (must be > 0)
+    size_t low_watermark;     ///< Blocks allocated and pre-faulted up front; db_pool_trim() keeps this many
+    size_t high_watermark;    ///< Most idle blocks in the shared list (raised to low_watermark if smaller)
+    size_t thread_cache;      ///< Idle blocks kept per thread (0 disables the thread cache)
+} db_pool_config;
+
+/**
+ * @brief Create a buffer pool
+ * @param config Pool sizing (must not be NULL)
+ * @return New pool instance (asserts on allocation failure)
+ * @note The pool must outlive every buffer acquired from it, and every buffer
+ *       derived from those (db_slice, db_append, db_concat, db_concat_many):
+ *       derived buffers are allocated through the pool and freed back to it.
+ *
+ * @par Example:
+ * @code
+ * db_pool_config config = {65536, 8, 64, 4};
+ * db_pool pool = db_pool_new(&config);
+ *
+ * for (;;) {
+ *     db_buffer buf = db_pool_acquire(pool);
+ *     if (db_read_fd(&buf, sock, 65536) <= 0) { db_release(&buf); break; }
+ *     parse(buf);
+ *     db_release(&buf);  // back to the pool, no free()
+ * }
+ * db_pool_release(&pool);
+ * @endcode
+ */
+DB_DEF db_pool db_pool_new(const db_pool_config* config);
+
+/**
+ * @brief Get an empty buffer from the pool
+ * @param pool Pool instance (must not be NULL)
+ * @return Buffer with size 0 and the pool's capacity (asserts on allocation failure)
+ * @note Growing the buffer past its capacity moves it to a non-pool block.
+ *       The pool block is recycled at that point.
+ */
+DB_DEF db_buffer db_pool_acquire(db_pool pool);
+
+/**
+ * @brief Get the allocator behind a pool
+ * @param pool Pool instance (must not be NULL)
+ * @return Allocator for db_new_ex(), db_builder_new_ex(), etc.
+ * @note Only requests for exactly the pool's block size are recycled;
+ *       other sizes go straight to DB_MALLOC/DB_FREE.
+ */
+DB_DEF const db_allocator* db_pool_allocator(db_pool pool);
+
+/**
+ * @brief Get the number of idle blocks available to the calling thread
+ * @param pool Pool instance (must not be NULL)
+ * @return Blocks in the shared list plus the calling thread's cache
+ */
+DB_DEF size_t db_pool_idle(db_pool pool);
+
+/**
+ * @brief Free idle blocks down to the low watermark
+ * @param pool Pool instance (must not be NULL)
+ * @note Also empties the calling thread's cache for this pool
+ */
+DB_DEF void db_pool_trim(db_pool pool);
+
+/**
+ * @brief Free all blocks in the calling thread's pool cache
+ * @note Call before a thread that used a pool exits
+ */
+DB_DEF void db_pool_trim_thread(void);
+
+/**
+ * @brief Free the pool and its idle blocks
+ * @param pool_ptr Pointer to pool variable (will be set to NULL)
+ * @warning Every buffer acquired from the pool must be released first.
+ *          Blocks cached by other threads are freed by db_pool_trim_thread()
+ *          or the next time that thread uses a different pool.
+ */
+DB_DEF void db_pool_release(db_pool* pool_ptr);
+
 /** @} */
 
 /**
@@ -267,6 +662,11 @@ DB_DEF int db_refcount(db_buffer buf);
 /**
  * @defgroup slicing Buffer Slicing
  * @brief Buffer slicing operations (creates independent copies)
+ *
+ * Because metadata lives directly in front of the data, a slice that starts
+ * inside another buffer cannot carry its own header. Partial slices are
+ * therefore copies, while a slice covering the whole buffer shares it.
+ * For zero-copy parsing of sub-ranges use db_reader_new_range().
  * @{
  */
 
@@ -277,6 +677,8 @@ DB_DEF int db_refcount(db_buffer buf);
  * @param length Number of bytes in slice
  * @return New buffer slice or NULL if bounds are invalid
  * @note The slice is an independent copy of the specified data range
+ * @note A slice covering the entire buffer returns a retained reference to
+ *       @p buf instead of a copy (buffers are immutable, so this is safe)
  */
 DB_DEF db_buffer db_slice(db_buffer buf, size_t offset, size_t length);
 
@@ -327,6 +729,30 @@ DB_DEF db_buffer db_slice_to(db_buffer buf, size_t length);
  */
 DB_DEF db_buffer db_append(db_buffer buf, const void* data, size_t size);
 
+/**
+ * @brief Append data to a buffer in place when it is not shared
+ * @param buf_ptr Pointer to buffer (must not be NULL, *buf_ptr must not be NULL)
+ * @param data Data to append (can be NULL if size is 0)
+ * @param size Number of bytes to append
+ * @return 0 on success, -1 on error
+ * @note When the buffer's reference count is 1 it grows in place with
+ *       geometric spare capacity, so repeated appends are amortized O(1).
+ *       A shared buffer is copied first (copy-on-write) and *buf_ptr is
+ *       updated; other holders keep seeing the original contents.
+ * @note *buf_ptr may change after growth - don't keep other copies of the
+ *       handle across this call
+ *
+ * @par Example:
+ * @code
+ * db_buffer log = db_new(0);
+ * for (int i = 0; i < 1000; i++) {
+ *     db_append_inplace(&log, "line\n", 5);
+ * }
+ * db_release(&log);
+ * @endcode
+ */
+DB_DEF int db_append_inplace(db_buffer* buf_ptr, const void* data, size_t size);
+
 
 /** @} */
 
@@ -376,1317 +802,7188 @@ DB_DEF bool db_equals(db_buffer buf1, db_buffer buf2);
  */
 DB_DEF int db_compare(db_buffer buf1, db_buffer buf2);
 
-/** @} */
-
 /**
- * @defgroup io I/O Operations
- * @brief Functions for reading and writing buffers
- * @{
+ * @brief Find the offset of the first differing byte
+ * @param buf1 First buffer
+ * @param buf2 Second buffer
+ * @return Index of the first byte that differs, or the shorter size when one
+ *         buffer is a prefix of the other (so equal buffers return their size)
+ * @note The result is the common prefix length, which is what delta encoding
+ *       and prefix-compressed sorted keys need. Compares 16/32 bytes per step
+ *       with SSE2/AVX2/NEON, 8 bytes per step otherwise.
  */
+DB_DEF size_t db_mismatch(db_buffer buf1, db_buffer buf2);
+
+/** @} */
 
 /**
- * @brief Read data from file descriptor into buffer
- * @param buf_ptr Pointer to buffer (must not be NULL)
- * @param fd File descriptor to read from
- * @param max_bytes Maximum bytes to read (0 for no limit)
- * @return Number of bytes read, or -1 on error
- * @note Buffer will be resized as needed to accommodate data
+ * @defgroup search Searching and Splitting
+ * @brief Byte, substring and delimiter search over buffer contents
+ * @{
  */
-DB_DEF ssize_t db_read_fd(db_buffer* buf_ptr, int fd, size_t max_bytes);
 
 /**
- * @brief Write buffer contents to file descriptor
- * @param buf Source buffer (must not be NULL)
- * @param fd File descriptor to write to
- * @return Number of bytes written, or -1 on error
+ * @brief Returned by the search functions when nothing matches
  */
-DB_DEF ssize_t db_write_fd(db_buffer buf, int fd);
+#define DB_NOT_FOUND SIZE_MAX
 
 /**
- * @brief Read entire file into a new buffer
- * @param filename Path to file to read
- * @return New buffer containing file contents, or NULL if file cannot be read
+ * @brief Find the first occurrence of a byte
+ * @param buf Buffer to search
+ * @param offset Position to start searching from
+ * @param byte Byte to look for
+ * @return Index of the byte, or DB_NOT_FOUND
+ * @note Uses memchr(), which every mainstream C library already vectorizes.
  */
-DB_DEF db_buffer db_read_file(const char* filename);
+DB_DEF size_t db_find_byte(db_buffer buf, size_t offset, uint8_t byte);
 
 /**
- * @brief Write buffer contents to file
- * @param buf Source buffer (must not be NULL)
- * @param filename Path to file to write
- * @return true on success, false on failure
+ * @brief Find the first byte that is any of the given bytes
+ * @param buf Buffer to search
+ * @param offset Position to start searching from
+ * @param set Bytes to look for
+ * @param set_size Number of bytes in set
+ * @return Index of the first matching byte, or DB_NOT_FOUND
+ * @note Sets of up to 16 bytes are matched 16/32 bytes at a time with
+ *       SSE2/AVX2/NEON compares; larger sets use a lookup table.
  */
-DB_DEF bool db_write_file(db_buffer buf, const char* filename);
-
-/** @} */
+DB_DEF size_t db_find_any(db_buffer buf, size_t offset, const void* set, size_t set_size);
 
 /**
- * @defgroup utility Utility Functions
- * @brief Helper and debugging functions
- * @{
+ * @brief Find the first occurrence of a byte sequence
+ * @param buf Buffer to search
+ * @param offset Position to start searching from
+ * @param needle Bytes to look for
+ * @param needle_size Number of bytes in needle (0 matches at offset)
+ * @return Index of the match, or DB_NOT_FOUND
+ * @note Candidate positions are found by comparing the needle's first and
+ *       last bytes against a whole SIMD block at once, so only positions
+ *       matching both are verified with memcmp().
  */
+DB_DEF size_t db_find(db_buffer buf, size_t offset, const void* needle, size_t needle_size);
 
 /**
- * @brief Create a hexadecimal representation of buffer contents
- * @param buf Buffer to convert (must not be NULL)
- * @param uppercase Use uppercase hex digits if true
- * @return New buffer containing hex string (asserts on allocation failure)
+ * @brief Iterator over delimiter-separated pieces of a buffer
+ *
+ * Plain struct; initialize with db_split_init(). The buffer and the
+ * delimiter must stay alive while iterating. n delimiters give n + 1
+ * pieces, so a trailing delimiter yields a final empty piece.
  */
-DB_DEF db_buffer db_to_hex(db_buffer buf, bool uppercase);
+typedef struct db_split {
+    db_buffer buf;          ///< Buffer being split (not retained)
+    const char* delim;      ///< Delimiter bytes
+    size_t delim_size;      ///< Delimiter length (at least 1)
+    size_t position;        ///< Start of the next piece
+    bool done;              ///< Set once the last piece was returned
+} db_split;
 
 /**
- * @brief Create buffer from hexadecimal string
- * @param hex_string Hexadecimal string (must be valid hex)
- * @param length Length of hex string
- * @return New buffer containing decoded bytes, or NULL on invalid hex string (asserts on allocation failure)
+ * @brief Start (or restart) splitting a buffer
+ * @param split Iterator to initialize
+ * @param buf Buffer to split
+ * @param delim Delimiter bytes, e.g. "\r\n"
+ * @param delim_size Delimiter length (must be > 0)
  */
-DB_DEF db_buffer db_from_hex(const char* hex_string, size_t length);
+DB_DEF void db_split_init(db_split* split, db_buffer buf, const void* delim, size_t delim_size);
 
 /**
- * @brief Print buffer information for debugging
- * @param buf Buffer to print (can be NULL)
- * @param label Optional label for the output
+ * @brief Get the next piece
+ * @param split Iterator
+ * @param piece Receives a pointer to the piece inside the buffer (no copy)
+ * @param size Receives the piece length
+ * @return true if a piece was returned, false when the buffer is exhausted
+ * @note The piece starts at (*piece - split->buf), which can be handed to
+ *       db_reader_new_range() or db_slice() when a handle is needed.
  */
-DB_DEF void db_debug_print(db_buffer buf, const char* label);
+DB_DEF bool db_split_next(db_split* split, const char** piece, size_t* size);
 
 /** @} */
 
 /**
- * @defgroup builder Buffer Builder API
- * @brief Functions for building buffers with primitive types
+ * @defgroup hashing Checksums and Hashing
+ * @brief CRC32C checksums and 64-bit hashing of buffer contents
  * @{
  */
 
 /**
- * @brief Opaque builder handle for constructing buffers efficiently
+ * @brief Compute the CRC32C (Castagnoli) checksum of a buffer
+ * @param buf Buffer to checksum
+ * @return CRC32C of the contents (as used by iSCSI, ext4, RocksDB)
+ * @note Uses the SSE4.2 crc32 instruction (selected at runtime on GCC/Clang)
+ *       or the ARMv8 CRC extension when the compiler targets it, and a
+ *       lookup table otherwise.
  */
-typedef struct db_builder_internal* db_builder;
+DB_DEF uint32_t db_crc32c(db_buffer buf);
 
 /**
- * @brief Create a new buffer builder
- * @param initial_capacity Initial capacity in bytes
- * @return New builder instance
- * 
- * @par Example:
- * @code
- * db_builder builder = db_builder_new(64);
- * db_builder_append_uint16_le(builder, 0x1234);
- * db_builder_append_cstring(builder, "Hello");
- * 
- * db_buffer buf = db_builder_finish(&builder);  // builder becomes NULL
- * printf("Built buffer with %zu bytes\n", db_size(buf));
- * db_release(&buf);
- * @endcode
+ * @brief Continue a CRC32C over more data
+ * @param crc Checksum so far (0 to start)
+ * @param data Data to add
+ * @param size Number of bytes
+ * @return Updated checksum; db_crc32c(buf) == db_crc32c_update(0, buf, db_size(buf))
  */
-DB_DEF db_builder db_builder_new(size_t initial_capacity);
+DB_DEF uint32_t db_crc32c_update(uint32_t crc, const void* data, size_t size);
 
 /**
- * @brief Create builder from existing buffer (continues at end)
- * @param buf Buffer to extend
- * @return New builder instance
+ * @brief Compute the XXH64 hash of raw bytes
+ * @param data Data to hash
+ * @param size Number of bytes
+ * @param seed Hash seed
+ * @return 64-bit hash, identical to the reference XXH64()
  */
-DB_DEF db_builder db_builder_from_buffer(db_buffer buf);
+DB_DEF uint64_t db_xxhash64(const void* data, size_t size, uint64_t seed);
 
 /**
- * @brief Increase builder reference count (share ownership)
- * @param builder Builder to retain (must not be NULL)
- * @return The same builder for convenience
+ * @brief Hash a buffer's contents for hash tables
+ * @param buf Buffer to hash
+ * @return XXH64 of the contents with seed 0, except that 0 is mapped to 1
+ * @note With DB_CACHE_HASH=1 the value is stored in the buffer header, so
+ *       later calls are O(1) and db_equals() can reject buffers with
+ *       different cached hashes without comparing bytes. Any in-place
+ *       mutation (builders, db_append_inplace, db_read_fd) drops the cached
+ *       value.
  */
-DB_DEF db_builder db_builder_retain(db_builder builder);
+DB_DEF uint64_t db_hash(db_buffer buf);
 
-/**
- * @brief Decrease builder reference count and potentially free builder
- * @param builder_ptr Pointer to builder variable (will be set to NULL)
- */
-DB_DEF void db_builder_release(db_builder* builder_ptr);
+/** @} */
 
 /**
- * @brief Finalize builder and return the constructed buffer
- * @param builder_ptr Pointer to builder (will be set to NULL)
- * @return Constructed buffer
+ * @defgroup io I/O Operations
+ * @brief Functions for reading and writing buffers
+ * @{
  */
-DB_DEF db_buffer db_builder_finish(db_builder* builder_ptr);
 
 /**
- * @brief Get current write position in builder
- * @param builder Builder instance
- * @return Current position in bytes
- */
-DB_DEF size_t db_builder_size(db_builder builder);
+ * @brief Read data from file descriptor into buffer
+ * @param buf_ptr Pointer to buffer (must not be NULL)
+ * @param fd File descriptor to read from
+ * @param max_bytes Maximum bytes to read (0 for no limit)
+ * @return Number of bytes read, or -1 on error
+ * @note Buffer will be resized as needed to accommodate data
+ * @note Data is read straight into the buffer's spare capacity. If the buffer
+ *       is shared it is copied first (copy-on-write) and *buf_ptr is updated.
+ */
+DB_DEF ssize_t db_read_fd(db_buffer* buf_ptr, int fd, size_t max_bytes);
 
 /**
- * @brief Get current capacity of builder
- * @param builder Builder instance  
- * @return Current capacity in bytes
+ * @brief Write buffer contents to file descriptor
+ * @param buf Source buffer (must not be NULL)
+ * @param fd File descriptor to write to
+ * @return Number of bytes written, or -1 on error
  */
-DB_DEF size_t db_builder_capacity(db_builder builder);
+DB_DEF ssize_t db_write_fd(db_buffer buf, int fd);
 
 /**
- * @brief Clear builder contents
- * @param builder Builder instance
+ * @brief Progress of a vectored write across calls
+ *
+ * Zero-initialize before the first call (DB_WRITE_CURSOR_INIT) and pass the
+ * same cursor again to resume after a partial write.
  */
-DB_DEF void db_builder_clear(db_builder builder);
+typedef struct db_write_cursor {
+    size_t index;    ///< Number of buffers fully sent
+    size_t offset;   ///< Bytes of buffers[index] already sent
+} db_write_cursor;
+
+/** @brief Initializer for a fresh db_write_cursor */
+#define DB_WRITE_CURSOR_INIT {0, 0}
 
 /**
- * @brief Write uint8 value
- * @param builder Builder instance
- * @param value Value to write
- * @return 0 on success, -1 on error
+ * @brief Write an array of buffers with writev(), resuming from a cursor
+ * @param fd File descriptor to write to
+ * @param buffers Array of buffers (entries must not be NULL)
+ * @param count Number of buffers in array
+ * @param cursor Write progress (must not be NULL), advanced by this call
+ * @return Number of bytes written by this call, or -1 on error (errno is set)
+ * @note Keeps issuing writev() batches until everything is sent, the descriptor
+ *       would block (EAGAIN/EWOULDBLOCK) or an error occurs. EINTR is retried.
+ *       Everything has been sent when cursor->index == count.
+ *
+ * @par Example:
+ * @code
+ * db_write_cursor cursor = DB_WRITE_CURSOR_INIT;
+ * while (cursor.index < count) {
+ *     if (db_write_fdv(sock, responses, count, &cursor) < 0) break;
+ *     if (cursor.index < count) wait_writable(sock);
+ * }
+ * @endcode
  */
-DB_DEF int db_builder_append_uint8(db_builder builder, uint8_t value);
+DB_DEF ssize_t db_write_fdv(int fd, const db_buffer* buffers, size_t count, db_write_cursor* cursor);
 
 /**
- * @brief Write uint16 value in little-endian format
- * @param builder Builder instance
- * @param value Value to write
- * @return 0 on success, -1 on error
+ * @brief Read entire file into a new buffer
+ * @param filename Path to file to read
+ * @return New buffer containing file contents, or NULL if file cannot be read
+ * @note For files too large to hold in memory use db_file_stream_open()
  */
-DB_DEF int db_builder_append_uint16_le(db_builder builder, uint16_t value);
+DB_DEF db_buffer db_read_file(const char* filename);
 
 /**
- * @brief Write uint16 value in big-endian format
- * @param builder Builder instance
- * @param value Value to write
- * @return 0 on success, -1 on error
+ * @brief Access pattern hints for memory-mapped buffers
  */
-DB_DEF int db_builder_append_uint16_be(db_builder builder, uint16_t value);
+typedef enum db_map_advice {
+    DB_MAP_NORMAL = 0,     ///< No special treatment
+    DB_MAP_SEQUENTIAL,     ///< Expect sequential reads (aggressive read-ahead)
+    DB_MAP_RANDOM,         ///< Expect random reads (no read-ahead)
+    DB_MAP_WILLNEED        ///< Expect access soon (start paging in now)
+} db_map_advice;
 
 /**
- * @brief Write uint32 value in little-endian format
- * @param builder Builder instance
- * @param value Value to write
- * @return 0 on success, -1 on error
+ * @brief Map an entire file into a new read-only buffer
+ * @param filename Path to file to map
+ * @param advice Access pattern hint for the whole mapping
+ * @return New buffer backed by the file mapping, or NULL if file cannot be read
+ * @note The file is not copied into the heap; pages are loaded on demand and the
+ *       mapping is removed when the last reference is released. The data is
+ *       read-only - writing through the handle faults. Operations that grow the
+ *       buffer (db_append_inplace, builders) work on a heap copy.
+ * @note Where mmap is unavailable (or on Windows, where a view can't be placed
+ *       directly after the metadata) this falls back to db_read_file().
+ * @warning Truncating the file while it is mapped makes access to the lost
+ *          pages fault (SIGBUS)
  */
-DB_DEF int db_builder_append_uint32_le(db_builder builder, uint32_t value);
+DB_DEF db_buffer db_map_file(const char* filename, db_map_advice advice);
 
 /**
- * @brief Write uint32 value in big-endian format
- * @param builder Builder instance
- * @param value Value to write
- * @return 0 on success, -1 on error
+ * @brief Give an access pattern hint for a range of a memory-mapped buffer
+ * @param buf Buffer returned by db_map_file() (must not be NULL)
+ * @param offset Start of the range in bytes
+ * @param length Length of the range in bytes
+ * @param advice Access pattern hint
+ * @return true if the hint was applied, false if buf is not a mapping or the
+ *         range is invalid
  */
-DB_DEF int db_builder_append_uint32_be(db_builder builder, uint32_t value);
+DB_DEF bool db_map_advise(db_buffer buf, size_t offset, size_t length, db_map_advice advice);
 
 /**
- * @brief Write uint64 value in little-endian format
- * @param builder Builder instance
- * @param value Value to write
- * @return 0 on success, -1 on error
+ * @brief Write buffer contents to file
+ * @param buf Source buffer (must not be NULL)
+ * @param filename Path to file to write
+ * @return true on success, false on failure
  */
-DB_DEF int db_builder_append_uint64_le(db_builder builder, uint64_t value);
+DB_DEF bool db_write_file(db_buffer buf, const char* filename);
 
 /**
- * @brief Write uint64 value in big-endian format
- * @param builder Builder instance
- * @param value Value to write
- * @return 0 on success, -1 on error
+ * @brief Options for db_file_stream_open() (zero-initialize for defaults)
  */
-DB_DEF int db_builder_append_uint64_be(db_builder builder, uint64_t value);
+typedef struct db_file_stream_options {
+    size_t chunk_size;         ///< Bytes per chunk (0 for 1 MiB)
+    size_t readahead_chunks;   ///< Chunks hinted ahead with POSIX_FADV_WILLNEED (0 for 4)
+    const void* delimiter;     ///< Record delimiter: chunks end right after its last occurrence (NULL for raw chunks)
+    size_t delimiter_size;     ///< Delimiter length in bytes
+    bool drop_behind;          ///< Tell the kernel to drop consumed pages from the page cache
+    db_pool pool;              ///< Pool to take chunk buffers from (NULL for db_new)
+} db_file_stream_options;
 
 /**
- * @brief Write raw bytes
- * @param builder Builder instance
- * @param data Data to write
- * @param size Number of bytes to write
- * @return 0 on success, -1 on error
+ * @brief Opaque handle for reading a file as a sequence of chunks
+ *
+ * Memory use is bounded by the chunk size rather than the file size, and
+ * offsets are 64-bit, so files of any size can be streamed.
  */
-DB_DEF int db_builder_append(db_builder builder, const void* data, size_t size);
+typedef struct db_file_stream_internal* db_file_stream;
 
 /**
- * @brief Write null-terminated string (without null terminator)
- * @param builder Builder instance
- * @param str String to write
- * @return 0 on success, -1 on error
+ * @brief Open a file for chunked reading
+ * @param filename Path to file to read (must not be NULL)
+ * @param options Stream options (NULL for defaults)
+ * @return New stream, or NULL if the file cannot be opened
+ *
+ * With a delimiter, each chunk ends at a record boundary. The partial record
+ * after the last delimiter is carried into the next chunk. A record longer
+ * than chunk_size makes its chunk grow until the delimiter or EOF.
+ *
+ * @par Example:
+ * @code
+ * db_file_stream_options options = {0};
+ * options.delimiter = "\n";
+ * options.delimiter_size = 1;
+ * options.drop_behind = true;
+ *
+ * db_file_stream lines = db_file_stream_open("huge.log", &options);
+ * db_buffer chunk;
+ * while ((chunk = db_file_stream_next(lines)) != NULL) {
+ *     process_whole_lines(chunk);
+ *     db_release(&chunk);
+ * }
+ * db_file_stream_release(&lines);
+ * @endcode
  */
-DB_DEF int db_builder_append_cstring(db_builder builder, const char* str);
+DB_DEF db_file_stream db_file_stream_open(const char* filename, const db_file_stream_options* options);
 
 /**
- * @brief Append buffer contents
- * @param builder Builder instance
- * @param buf Buffer to append
- * @return 0 on success, -1 on error
+ * @brief Stream an already open file descriptor
+ * @param fd File descriptor positioned where streaming should start
+ * @param options Stream options (NULL for defaults)
+ * @return New stream (asserts on allocation failure)
+ * @note The descriptor is not closed by db_file_stream_release()
  */
-DB_DEF int db_builder_append_buffer(db_builder builder, db_buffer buf);
-
-/** @} */
+DB_DEF db_file_stream db_file_stream_from_fd(int fd, const db_file_stream_options* options);
 
 /**
- * @defgroup reader Buffer Reader API
- * @brief Functions for reading buffers with primitive types and cursor
- * @{
+ * @brief Read the next chunk
+ * @param stream Stream instance (must not be NULL)
+ * @return New buffer with the next chunk, or NULL at end of file or on error
+ * @note Chunks are chunk_size bytes except the last one, and except when a
+ *       delimiter moves the boundary.
  */
+DB_DEF db_buffer db_file_stream_next(db_file_stream stream);
 
 /**
- * @brief Opaque reader handle for parsing buffers
+ * @brief Get the file offset just past the last chunk returned
+ * @param stream Stream instance (must not be NULL)
+ * @return Bytes handed out so far, relative to where the stream started
  */
-typedef struct db_reader_internal* db_reader;
+DB_DEF uint64_t db_file_stream_position(db_file_stream stream);
 
 /**
- * @brief Create a new buffer reader
- * @param buf Buffer to read from
- * @return New reader instance
- * 
- * @par Example:
- * @code
- * db_reader reader = db_reader_new(buffer);
- * uint16_t value = db_read_uint16_le(reader);
- * char data[10];
- * db_read_bytes(reader, data, sizeof(data));
- * db_reader_release(&reader);
- * @endcode
+ * @brief Get the error that ended the stream
+ * @param stream Stream instance (must not be NULL)
+ * @return errno value of the failed read, or 0 if none failed
  */
-DB_DEF db_reader db_reader_new(db_buffer buf);
+DB_DEF int db_file_stream_error(db_file_stream stream);
 
 /**
- * @brief Increase reader reference count (share ownership)
- * @param reader Reader to retain (must not be NULL)
- * @return The same reader for convenience
+ * @brief Close a stream
+ * @param stream_ptr Pointer to stream variable (will be set to NULL)
  */
-DB_DEF db_reader db_reader_retain(db_reader reader);
+DB_DEF void db_file_stream_release(db_file_stream* stream_ptr);
+
+/** @} */
+
+#if DB_IO_URING
 
 /**
- * @brief Decrease reader reference count and potentially free reader
- * @param reader_ptr Pointer to reader variable (will be set to NULL)
+ * @defgroup uring io_uring Backend
+ * @brief Batched asynchronous reads and writes on Linux
+ *
+ * A ring queues read and write requests on db_buffers. It sends them to
+ * the kernel in one io_uring_enter() per batch and returns each completion
+ * with its buffer. Ownership moves with the request: the ring takes the
+ * caller's buffer reference at submission and hands it back in the
+ * completion.
+ *
+ * Rings talk to the kernel with raw system calls, so liburing is not
+ * needed. Only available with DB_IO_URING=1 on Linux in GNU/BSD mode (e.g.
+ * -std=gnu11 or _DEFAULT_SOURCE); strict ISO builds leave it out. Like the
+ * rest of the library, a ring is meant to be used from one thread at a time.
+ * @{
  */
-DB_DEF void db_reader_release(db_reader* reader_ptr);
 
 /**
- * @brief Free reader resources (legacy name, use db_reader_release instead)
- * @param reader_ptr Pointer to reader (will be set to NULL)
+ * @brief Pass as the offset to read or write at the file's current position
  */
-DB_DEF void db_reader_free(db_reader* reader_ptr);
+#define DB_URING_CURRENT_POS ((uint64_t)-1)
 
 /**
- * @brief Get current read position
- * @param reader Reader instance
- * @return Current position in bytes
+ * @brief Opaque io_uring handle
  */
-DB_DEF size_t db_reader_position(db_reader reader);
+typedef struct db_uring_internal* db_uring;
 
 /**
- * @brief Get number of bytes remaining
- * @param reader Reader instance
- * @return Remaining bytes from current position
+ * @brief Kind of a completed request
  */
-DB_DEF size_t db_reader_remaining(db_reader reader);
+typedef enum db_uring_op {
+    DB_URING_READ,     ///< db_uring_read() or db_uring_read_fixed()
+    DB_URING_WRITE     ///< db_uring_write()
+} db_uring_op;
 
 /**
- * @brief Check if reader can read specified number of bytes
- * @param reader Reader instance
- * @param bytes Number of bytes to check
- * @return true if bytes are available
+ * @brief One completed request
  */
-DB_DEF bool db_reader_can_read(db_reader reader, size_t bytes);
+typedef struct db_uring_completion {
+    db_buffer buf;     ///< Request buffer; the caller owns this reference. Reads have grown its size by result
+    void* user;        ///< User pointer given at submission
+    int result;        ///< Bytes transferred, or -errno
+    db_uring_op op;    ///< Request kind
+} db_uring_completion;
 
 /**
- * @brief Seek to specific position
- * @param reader Reader instance
- * @param position Position to seek to
+ * @brief Create an io_uring instance
+ * @param entries Submission queue depth (rounded up to a power of two by the kernel)
+ * @return New ring, or NULL if io_uring is unavailable (old kernel, seccomp policy, ...)
+ * @note At most twice `entries` requests can be in flight at once.
+ *
+ * @par Example:
+ * @code
+ * db_uring ring = db_uring_new(64);
+ * for (int i = 0; i < 16; i++) {
+ *     db_buffer chunk = db_new(65536);
+ *     db_uring_read(ring, fd, &chunk, 65536, (uint64_t)i * 65536, NULL);
+ * }
+ * db_uring_submit(ring);
+ *
+ * db_uring_completion done[16];
+ * size_t n = db_uring_complete(ring, done, 16, 16);
+ * for (size_t i = 0; i < n; i++) {
+ *     if (done[i].result > 0) consume(done[i].buf);
+ *     db_release(&done[i].buf);
+ * }
+ * db_uring_release(&ring);
+ * @endcode
  */
-DB_DEF void db_reader_seek(db_reader reader, size_t position);
+DB_DEF db_uring db_uring_new(unsigned entries);
 
 /**
- * @brief Read uint8 value
- * @param reader Reader instance
- * @return Read value
+ * @brief Register buffers from a pool as io_uring fixed buffers
+ * @param ring Ring instance (must not be NULL, no buffers registered yet)
+ * @param pool Pool to take the buffers from (must not be NULL)
+ * @param count Number of buffers to register
+ * @return 0 on success, -1 on error (errno is set)
+ * @note The ring keeps one reference to each buffer until it is released.
+ *       The kernel pins the pages once, so db_uring_read_fixed() and writes
+ *       of these buffers skip the per-request page mapping.
  */
-DB_DEF uint8_t db_read_uint8(db_reader reader);
+DB_DEF int db_uring_register_pool(db_uring ring, db_pool pool, unsigned count);
 
 /**
- * @brief Read uint16 value in little-endian format
- * @param reader Reader instance
- * @return Read value
+ * @brief Queue a read that appends to a buffer
+ * @param ring Ring instance (must not be NULL)
+ * @param fd File descriptor to read from
+ * @param buf_ptr Pointer to the buffer to append to (must not be NULL; set to NULL on success)
+ * @param max_bytes Maximum bytes to read (must be > 0 and <= UINT32_MAX)
+ * @param offset File offset, or DB_URING_CURRENT_POS
+ * @param user Pointer returned in the completion
+ * @return 0 if queued, -1 if too many requests are in flight (the caller keeps the buffer)
+ * @note Spare capacity for max_bytes is reserved before queuing. A shared
+ *       buffer is copied first, like db_read_fd().
  */
-DB_DEF uint16_t db_read_uint16_le(db_reader reader);
+DB_DEF int db_uring_read(db_uring ring, int fd, db_buffer* buf_ptr, size_t max_bytes, uint64_t offset, void* user);
 
 /**
- * @brief Read uint16 value in big-endian format
- * @param reader Reader instance
- * @return Read value
+ * @brief Queue a read into a free registered buffer
+ * @param ring Ring instance (must not be NULL)
+ * @param fd File descriptor to read from
+ * @param max_bytes Maximum bytes to read (clamped to the pool's buffer capacity)
+ * @param offset File offset, or DB_URING_CURRENT_POS
+ * @param user Pointer returned in the completion
+ * @return 0 if queued, -1 if no registered buffer is free or too many requests are in flight
+ * @note A registered buffer is free again once the caller releases the
+ *       reference it got from the completion.
  */
-DB_DEF uint16_t db_read_uint16_be(db_reader reader);
+DB_DEF int db_uring_read_fixed(db_uring ring, int fd, size_t max_bytes, uint64_t offset, void* user);
 
 /**
- * @brief Read uint32 value in little-endian format
- * @param reader Reader instance
- * @return Read value
+ * @brief Queue a write of a whole buffer
+ * @param ring Ring instance (must not be NULL)
+ * @param fd File descriptor to write to
+ * @param buf_ptr Pointer to the buffer to write (must not be NULL; set to NULL on success)
+ * @param offset File offset, or DB_URING_CURRENT_POS
+ * @param user Pointer returned in the completion
+ * @return 0 if queued, -1 if too many requests are in flight (the caller keeps the buffer)
+ * @note Registered buffers are written with IORING_OP_WRITE_FIXED. Short
+ *       writes show up as a smaller result and are not retried.
  */
-DB_DEF uint32_t db_read_uint32_le(db_reader reader);
+DB_DEF int db_uring_write(db_uring ring, int fd, db_buffer* buf_ptr, uint64_t offset, void* user);
 
 /**
- * @brief Read uint32 value in big-endian format
- * @param reader Reader instance
- * @return Read value
+ * @brief Send all queued requests to the kernel
+ * @param ring Ring instance (must not be NULL)
+ * @return Number of requests submitted, or -1 on error (errno is set)
  */
-DB_DEF uint32_t db_read_uint32_be(db_reader reader);
+DB_DEF int db_uring_submit(db_uring ring);
 
 /**
- * @brief Read uint64 value in little-endian format
- * @param reader Reader instance
- * @return Read value
+ * @brief Collect completed requests
+ * @param ring Ring instance (must not be NULL)
+ * @param out Array receiving completions
+ * @param max Capacity of out
+ * @param min_complete Wait until at least this many are available (capped at the number in flight)
+ * @return Number of completions stored in out
+ * @note Queued requests that were not submitted yet are submitted first.
  */
-DB_DEF uint64_t db_read_uint64_le(db_reader reader);
+DB_DEF size_t db_uring_complete(db_uring ring, db_uring_completion* out, size_t max, unsigned min_complete);
 
 /**
- * @brief Read uint64 value in big-endian format
- * @param reader Reader instance
- * @return Read value
+ * @brief Get the number of requests queued or in flight
+ * @param ring Ring instance (must not be NULL)
+ * @return Requests whose completion has not been collected yet
  */
-DB_DEF uint64_t db_read_uint64_be(db_reader reader);
+DB_DEF unsigned db_uring_pending(db_uring ring);
 
 /**
- * @brief Read raw bytes
- * @param reader Reader instance
- * @param data Output buffer for data
- * @param size Number of bytes to read
+ * @brief Release a ring
+ * @param ring_ptr Pointer to ring variable (will be set to NULL)
+ * @note Requests never submitted are dropped; those in flight are cancelled and
+ *       waited for before their buffers are released. If the ring fails while
+ *       waiting, in-flight buffers are leaked rather than freed under the kernel.
  */
-DB_DEF void db_read_bytes(db_reader reader, void* data, size_t size);
+DB_DEF void db_uring_release(db_uring* ring_ptr);
 
 /** @} */
 
-// Implementation section - only compiled when DB_IMPLEMENTATION is defined
-#ifdef DB_IMPLEMENTATION
+#endif // DB_IO_URING
 
 /**
- * @brief Internal buffer metadata structure
- * @private
- * 
- * This structure is stored at negative offsets before the buffer data.
- * The db_buffer points directly to the data portion.
+ * @defgroup utility Utility Functions
+ * @brief Helper and debugging functions
+ * @{
  */
-typedef struct db_internal {
-    db_refcount_t refcount;    ///< Reference count for memory management
-    size_t size;               ///< Current size of valid data in bytes
-    size_t capacity;           ///< Total allocated capacity in bytes
-} db_internal;
 
 /**
- * @brief Get pointer to metadata for a buffer
- * @param buf Buffer handle (must not be NULL)
- * @return Pointer to metadata structure
+ * @brief Create a hexadecimal representation of buffer contents
+ * @param buf Buffer to convert (must not be NULL)
+ * @param uppercase Use uppercase hex digits if true
+ * @return New buffer containing hex string (asserts on allocation failure)
+ * @note Uses SSE2/AVX2 (selected at runtime) or NEON kernels where available
  */
-static inline db_internal* db_meta(db_buffer buf) {
-    return (db_internal*)((char*)(buf) - sizeof(db_internal));
-}
+DB_DEF db_buffer db_to_hex(db_buffer buf, bool uppercase);
 
 /**
- * @brief Allocate memory for buffer with metadata
- * @private
+ * @brief Create buffer from hexadecimal string
+ * @param hex_string Hexadecimal string (must be valid hex)
+ * @param length Length of hex string
+ * @return New buffer containing decoded bytes, or NULL on invalid hex string (asserts on allocation failure)
+ * @note Accepts upper and lower case digits. SIMD kernels validate every
+ *       character exactly like the scalar path.
  */
-static db_buffer db_alloc(size_t capacity) {
-    // Allocate: metadata + buffer data
-    size_t total_size = sizeof(db_internal) + capacity;
-    
-    // Check for overflow
-    if (total_size < sizeof(db_internal) || total_size < capacity) {
-        return NULL;
-    }
-    
-    void* block = DB_MALLOC(total_size);
-    DB_ASSERT(block && "db_alloc: memory allocation failed");
-    
-    // Initialize metadata
-    db_internal* meta = (db_internal*)block;
-    meta->refcount = DB_REFCOUNT_INIT(1);
-    meta->size = 0;
-    meta->capacity = capacity;
-    
-    // Return pointer to buffer data portion
-    return (db_buffer)((char*)block + sizeof(db_internal));
-}
+DB_DEF db_buffer db_from_hex(const char* hex_string, size_t length);
 
 /**
- * @brief Free buffer memory
- * @private
+ * @brief Base64 alphabets (RFC 4648)
  */
-static void db_dealloc(db_buffer buf) {
-    if (!buf) return;
-    
-    // Get original malloc pointer and free it
-    void* block = (char*)buf - sizeof(db_internal);
-    DB_FREE(block);
-}
+typedef enum db_base64_alphabet {
+    DB_BASE64_STANDARD = 0,  ///< A-Z a-z 0-9 + /, padded with '='
+    DB_BASE64_URL            ///< A-Z a-z 0-9 - _, unpadded (tokens, JWT, URLs)
+} db_base64_alphabet;
 
-// Implementation of public functions
+/**
+ * @brief Create a base64 representation of buffer contents
+ * @param buf Buffer to encode (must not be NULL)
+ * @param alphabet Alphabet to encode with
+ * @return New buffer sized exactly to the encoded text (asserts on allocation failure)
+ * @note Uses AVX2 (selected at runtime) or NEON kernels where available
+ */
+DB_DEF db_buffer db_to_base64(db_buffer buf, db_base64_alphabet alphabet);
 
-db_buffer db_new(size_t capacity) {
-    return db_alloc(capacity);
-}
+/**
+ * @brief Create buffer from base64 text
+ * @param text Base64 text
+ * @param length Length of text
+ * @param alphabet Alphabet the text uses
+ * @return New buffer sized exactly to the decoded bytes, or NULL on invalid
+ *         input (asserts on allocation failure)
+ * @note Padding is optional for both alphabets. Whitespace and characters of
+ *       the other alphabet are rejected, and unused bits in the last
+ *       character are ignored.
+ */
+DB_DEF db_buffer db_from_base64(const char* text, size_t length, db_base64_alphabet alphabet);
 
-db_buffer db_new_with_data(const void* data, size_t size) {
-    DB_ASSERT((data || size == 0) && "db_new_with_data: data cannot be NULL when size > 0");
-    
-    db_buffer buf = db_alloc(size);
-    // db_alloc now asserts on allocation failure
-    
+/**
+ * @brief Print buffer information for debugging
+ * @param buf Buffer to print (can be NULL)
+ * @param label Optional label for the output
+ */
+DB_DEF void db_debug_print(db_buffer buf, const char* label);
+
+/** @} */
+
+/**
+ * @defgroup stats Instrumentation
+ * @brief Opt-in allocation and copy counters
+ *
+ * Counting is compiled in only when DB_STATS is 1. Otherwise the hooks expand
+ * to nothing and db_stats_snapshot() returns zeros. Counters are per thread,
+ * so each thread sees the work it did itself without any synchronization.
+ * @{
+ */
+
+/**
+ * @brief Per-thread counters for buffer storage and copies
+ *
+ * Only storage the library allocates is counted: heap and allocator
+ * buffers. External and file-mapped buffers are never allocated or freed
+ * here. Builder, reader and chain handles are not counted either.
+ */
+typedef struct db_stats {
+    uint64_t allocations;      ///< Buffer blocks allocated
+    uint64_t frees;            ///< Buffer blocks freed
+    uint64_t reallocs;         ///< Buffer blocks resized (growth or shrink-to-fit)
+    uint64_t bytes_copied;     ///< Bytes copied by slice, append, concat, chain flatten and copy-on-write
+    uint64_t cow_copies;       ///< Shared buffers copied before a write
+    int64_t live_bytes;        ///< Capacity allocated minus freed on this thread
+    int64_t peak_live_bytes;   ///< Highest live_bytes since the last reset
+} db_stats;
+
+/**
+ * @brief Get the calling thread's counters
+ * @return Copy of the counters (all zero unless DB_STATS is 1)
+ * @note live_bytes can go negative on a thread that frees buffers
+ *       allocated by another thread.
+ */
+DB_DEF db_stats db_stats_snapshot(void);
+
+/**
+ * @brief Zero the calling thread's counters
+ * @note live_bytes is left alone, since buffers still alive will be freed
+ *       later. peak_live_bytes restarts from the current live_bytes.
+ */
+DB_DEF void db_stats_reset(void);
+
+/** @} */
+
+/**
+ * @defgroup parallel Parallel Bulk Operations
+ * @brief Split large copies, encodings and comparisons across threads
+ *
+ * The work is cut into fixed-size chunks and handed to a db_executor: either
+ * a caller's own thread pool or, with DB_THREAD_POOL=1, the built-in one.
+ * Inputs below the threshold, or calls without an executor, take the serial
+ * path. The result is byte-identical either way.
+ * @{
+ */
+
+/**
+ * @brief Task run by an executor
+ * @param arg Argument given to the executor
+ * @param index Task index in [0, count)
+ */
+typedef void (*db_task_fn)(void* arg, size_t index);
+
+/**
+ * @brief Executor callbacks used by the parallel operations
+ *
+ * run() must call task(arg, i) exactly once for every i < count, on any
+ * threads and in any order, and return only when all of them have
+ * finished. Calling it again from inside a task is not required to work.
+ */
+typedef struct db_executor {
+    void (*run)(void* user, db_task_fn task, void* arg, size_t count); ///< Run count tasks and wait for them
+    void* user;                                                        ///< User pointer passed to run
+} db_executor;
+
+/**
+ * @brief Parallel execution settings (zero-initialize for defaults)
+ */
+typedef struct db_parallel_config {
+    const db_executor* executor; ///< Executor to run chunks on (NULL to always run serially)
+    size_t threshold;            ///< Smallest input in bytes worth splitting (0 for 4 MiB)
+    size_t chunk_size;           ///< Bytes per task (0 for 1 MiB)
+} db_parallel_config;
+
+/**
+ * @brief Concatenate multiple buffers into a new buffer, copying in parallel
+ * @param buffers Array of buffers to concatenate (NULL entries are skipped)
+ * @param count Number of buffers in array
+ * @param config Parallel settings (NULL for serial)
+ * @return New buffer with the same contents db_concat_many() would produce
+ */
+DB_DEF db_buffer db_concat_many_parallel(db_buffer* buffers, size_t count, const db_parallel_config* config);
+
+/**
+ * @brief Convert buffer to hex string, encoding in parallel
+ * @param buf Source buffer (must not be NULL)
+ * @param uppercase Use uppercase hex digits
+ * @param config Parallel settings (NULL for serial)
+ * @return New buffer with the same contents db_to_hex() would produce
+ */
+DB_DEF db_buffer db_to_hex_parallel(db_buffer buf, bool uppercase, const db_parallel_config* config);
+
+/**
+ * @brief Check two buffers for equality, comparing chunks in parallel
+ * @param buf1 First buffer (must not be NULL)
+ * @param buf2 Second buffer (must not be NULL)
+ * @param config Parallel settings (NULL for serial)
+ * @return Same result as db_equals()
+ */
+DB_DEF bool db_equals_parallel(db_buffer buf1, db_buffer buf2, const db_parallel_config* config);
+
+#if DB_THREAD_POOL
+
+/**
+ * @brief Opaque handle for the built-in thread pool
+ */
+typedef struct db_thread_pool_internal* db_thread_pool;
+
+/**
+ * @brief Start a thread pool
+ * @param threads Worker threads to start (0 for one per online CPU, minus the caller)
+ * @return New pool (asserts on allocation or thread creation failure)
+ * @note The calling thread also runs tasks while it waits, so a pool with
+ *       zero workers (single CPU) still makes progress.
+ *
+ * @par Example:
+ * @code
+ * db_thread_pool pool = db_thread_pool_new(0);
+ * db_parallel_config config = {0};
+ * config.executor = db_thread_pool_executor(pool);
+ *
+ * db_buffer merged = db_concat_many_parallel(segments, segment_count, &config);
+ * db_thread_pool_release(&pool);
+ * @endcode
+ */
+DB_DEF db_thread_pool db_thread_pool_new(unsigned threads);
+
+/**
+ * @brief Get the executor that runs tasks on a pool
+ * @param pool Pool instance (must not be NULL)
+ * @return Executor valid until the pool is released
+ * @note Runs from several threads are serialized.
+ */
+DB_DEF const db_executor* db_thread_pool_executor(db_thread_pool pool);
+
+/**
+ * @brief Get the number of worker threads
+ * @param pool Pool instance (must not be NULL)
+ * @return Worker threads, not counting callers (fewer than requested if some
+ *         could not be created)
+ */
+DB_DEF unsigned db_thread_pool_size(db_thread_pool pool);
+
+/**
+ * @brief Stop the workers and free the pool
+ * @param pool_ptr Pointer to pool variable (will be set to NULL)
+ * @note Must not be called while a run is in progress
+ */
+DB_DEF void db_thread_pool_release(db_thread_pool* pool_ptr);
+
+#endif // DB_THREAD_POOL
+
+/** @} */
+
+/**
+ * @defgroup builder Buffer Builder API
+ * @brief Functions for building buffers with primitive types
+ * @{
+ */
+
+/**
+ * @brief Opaque builder handle for constructing buffers efficiently
+ */
+typedef struct db_builder_internal* db_builder;
+
+/**
+ * @brief Growth policy for a builder's backing buffer
+ *
+ * A zero-initialized policy gives the default behaviour: start at 16 bytes,
+ * double on every growth, no step limit, no page rounding, keep slack on finish.
+ */
+typedef struct db_growth_policy {
+    size_t initial_capacity;  ///< Minimum capacity once the builder grows (0 for 16 bytes)
+    double growth_factor;     ///< Capacity multiplier per growth step (<= 1.0 for 2.0)
+    size_t max_growth_step;   ///< Largest increase per growth step in bytes (0 for unlimited)
+    bool round_to_page;       ///< Round allocation blocks up to whole pages
+    bool shrink_on_finish;    ///< Release spare capacity in db_builder_finish()
+} db_growth_policy;
+
+/**
+ * @brief Create a new buffer builder
+ * @param initial_capacity Initial capacity in bytes
+ * @return New builder instance
+ * 
+ * @par Example:
+ * @code
+ * db_builder builder = db_builder_new(64);
+ * db_builder_append_uint16_le(builder, 0x1234);
+ * db_builder_append_cstring(builder, "Hello");
+ * 
+ * db_buffer buf = db_builder_finish(&builder);  // builder becomes NULL
+ * printf("Built buffer with %zu bytes\n", db_size(buf));
+ * db_release(&buf);
+ * @endcode
+ */
+DB_DEF db_builder db_builder_new(size_t initial_capacity);
+
+/**
+ * @brief Create a new buffer builder using a custom allocator for its data
+ * @param initial_capacity Initial capacity in bytes
+ * @param allocator Allocator to use (NULL for the default allocator)
+ * @return New builder instance
+ * @note The finished buffer keeps using the same allocator
+ */
+DB_DEF db_builder db_builder_new_ex(size_t initial_capacity, const db_allocator* allocator);
+
+/**
+ * @brief Create builder from existing buffer (continues at end)
+ * @param buf Buffer to extend
+ * @return New builder instance
+ */
+DB_DEF db_builder db_builder_from_buffer(db_buffer buf);
+
+/**
+ * @brief Create builder that takes over an existing buffer (continues at end)
+ * @param buf_ptr Pointer to buffer variable (will be set to NULL)
+ * @return New builder instance
+ * @note When the caller holds the only reference the buffer is adopted without
+ *       a copy; otherwise it is copied and the caller's reference released.
+ */
+DB_DEF db_builder db_builder_from_buffer_take(db_buffer* buf_ptr);
+
+/**
+ * @brief Set the growth policy used when the builder runs out of capacity
+ * @param builder Builder instance
+ * @param policy Policy to copy into the builder (NULL restores the default)
+ * @note Takes effect on the next growth; the current capacity is left as is.
+ *       A large max_growth_step with a growth_factor close to 1.0 keeps big
+ *       builders from overshooting by up to 2x.
+ */
+DB_DEF void db_builder_set_policy(db_builder builder, const db_growth_policy* policy);
+
+/**
+ * @brief Increase builder reference count (share ownership)
+ * @param builder Builder to retain (must not be NULL)
+ * @return The same builder for convenience
+ */
+DB_DEF db_builder db_builder_retain(db_builder builder);
+
+/**
+ * @brief Decrease builder reference count and potentially free builder
+ * @param builder_ptr Pointer to builder variable (will be set to NULL)
+ */
+DB_DEF void db_builder_release(db_builder* builder_ptr);
+
+/**
+ * @brief Finalize builder and return the constructed buffer
+ * @param builder_ptr Pointer to builder (will be set to NULL)
+ * @return Constructed buffer
+ * @note With db_growth_policy::shrink_on_finish the spare capacity is handed
+ *       back to the allocator first (heap and allocator buffers only).
+ */
+DB_DEF db_buffer db_builder_finish(db_builder* builder_ptr);
+
+/**
+ * @brief Get current write position in builder
+ * @param builder Builder instance
+ * @return Current position in bytes
+ */
+DB_DEF size_t db_builder_size(db_builder builder);
+
+/**
+ * @brief Get current capacity of builder
+ * @param builder Builder instance  
+ * @return Current capacity in bytes
+ */
+DB_DEF size_t db_builder_capacity(db_builder builder);
+
+/**
+ * @brief Clear builder contents
+ * @param builder Builder instance
+ * @note Resets the size in place when the builder owns its buffer uniquely,
+ *       keeping the capacity for reuse without reallocating.
+ */
+DB_DEF void db_builder_clear(db_builder builder);
+
+/**
+ * @brief Write uint8 value
+ * @param builder Builder instance
+ * @param value Value to write
+ * @return 0 on success, -1 on error
+ */
+DB_DEF int db_builder_append_uint8(db_builder builder, uint8_t value);
+
+/**
+ * @brief Write uint16 value in little-endian format
+ * @param builder Builder instance
+ * @param value Value to write
+ * @return 0 on success, -1 on error
+ */
+DB_DEF int db_builder_append_uint16_le(db_builder builder, uint16_t value);
+
+/**
+ * @brief Write uint16 value in big-endian format
+ * @param builder Builder instance
+ * @param value Value to write
+ * @return 0 on success, -1 on error
+ */
+DB_DEF int db_builder_append_uint16_be(db_builder builder, uint16_t value);
+
+/**
+ * @brief Write uint32 value in little-endian format
+ * @param builder Builder instance
+ * @param value Value to write
+ * @return 0 on success, -1 on error
+ */
+DB_DEF int db_builder_append_uint32_le(db_builder builder, uint32_t value);
+
+/**
+ * @brief Write uint32 value in big-endian format
+ * @param builder Builder instance
+ * @param value Value to write
+ * @return 0 on success, -1 on error
+ */
+DB_DEF int db_builder_append_uint32_be(db_builder builder, uint32_t value);
+
+/**
+ * @brief Write uint64 value in little-endian format
+ * @param builder Builder instance
+ * @param value Value to write
+ * @return 0 on success, -1 on error
+ */
+DB_DEF int db_builder_append_uint64_le(db_builder builder, uint64_t value);
+
+/**
+ * @brief Write uint64 value in big-endian format
+ * @param builder Builder instance
+ * @param value Value to write
+ * @return 0 on success, -1 on error
+ */
+DB_DEF int db_builder_append_uint64_be(db_builder builder, uint64_t value);
+
+/**
+ * @brief Write raw bytes
+ * @param builder Builder instance
+ * @param data Data to write
+ * @param size Number of bytes to write
+ * @return 0 on success, -1 on error
+ */
+DB_DEF int db_builder_append(db_builder builder, const void* data, size_t size);
+
+/**
+ * @brief Write null-terminated string (without null terminator)
+ * @param builder Builder instance
+ * @param str String to write
+ * @return 0 on success, -1 on error
+ */
+DB_DEF int db_builder_append_cstring(db_builder builder, const char* str);
+
+/**
+ * @brief Append buffer contents
+ * @param builder Builder instance
+ * @param buf Buffer to append
+ * @return 0 on success, -1 on error
+ */
+DB_DEF int db_builder_append_buffer(db_builder builder, db_buffer buf);
+
+/**
+ * @brief Reserve writable space at the end of the builder
+ * @param builder Builder instance
+ * @param size Number of bytes the caller intends to write
+ * @return Pointer to at least size writable bytes, or NULL on error
+ * @note Write into the returned space, then call db_builder_commit() with the
+ *       number of bytes actually written. The pointer is invalidated by any
+ *       other call that may grow the builder.
+ */
+DB_DEF void* db_builder_reserve(db_builder builder, size_t size);
+
+/**
+ * @brief Commit bytes written into space returned by db_builder_reserve()
+ * @param builder Builder instance
+ * @param size Number of bytes written (may be less than reserved)
+ * @return 0 on success, -1 if size exceeds the spare capacity
+ */
+DB_DEF int db_builder_commit(db_builder builder, size_t size);
+
+/**
+ * @brief Write unsigned LEB128 varint (protobuf wire format)
+ * @param builder Builder instance
+ * @param value Value to write (1 to 10 bytes)
+ * @return 0 on success, -1 on error
+ */
+DB_DEF int db_builder_append_varint_u64(db_builder builder, uint64_t value);
+
+/**
+ * @brief Write signed varint using zigzag encoding (protobuf sint64)
+ * @param builder Builder instance
+ * @param value Value to write; small magnitudes of either sign stay short
+ * @return 0 on success, -1 on error
+ */
+DB_DEF int db_builder_append_varint_s64(db_builder builder, int64_t value);
+
+/**
+ * @brief Partial input carried between db_builder_append_base64() calls
+ *
+ * Initialize with DB_BASE64_STREAM_INIT and finish with
+ * db_builder_flush_base64() to write the final group and padding.
+ */
+typedef struct db_base64_stream {
+    db_base64_alphabet alphabet; ///< Alphabet to encode with
+    uint8_t pending[2];          ///< Input bytes not yet forming a full group
+    uint8_t pending_size;        ///< Number of bytes in pending
+} db_base64_stream;
+
+/** @brief Initializer for a fresh db_base64_stream */
+#define DB_BASE64_STREAM_INIT(alphabet) {(alphabet), {0, 0}, 0}
+
+/**
+ * @brief Append base64-encoded bytes
+ * @param builder Builder instance
+ * @param stream Encoder state, or NULL to encode data as one complete
+ *               standard-alphabet message (padding included)
+ * @param data Bytes to encode
+ * @param size Number of bytes
+ * @return 0 on success, -1 on error
+ * @note Encoding a message in several calls produces the same text as one
+ *       db_to_base64() call once the stream is flushed.
+ *
+ * @par Example:
+ * @code
+ * db_base64_stream stream = DB_BASE64_STREAM_INIT(DB_BASE64_STANDARD);
+ * db_builder_append_cstring(builder, "{\"blob\":\"");
+ * while ((n = read(fd, chunk, sizeof(chunk))) > 0) {
+ *     db_builder_append_base64(builder, &stream, chunk, (size_t)n);
+ * }
+ * db_builder_flush_base64(builder, &stream);
+ * db_builder_append_cstring(builder, "\"}");
+ * @endcode
+ */
+DB_DEF int db_builder_append_base64(db_builder builder, db_base64_stream* stream, const void* data, size_t size);
+
+/**
+ * @brief Write the final partial group of a base64 stream
+ * @param builder Builder instance
+ * @param stream Encoder state (reset for reuse afterwards)
+ * @return 0 on success, -1 on error
+ */
+DB_DEF int db_builder_flush_base64(db_builder builder, db_base64_stream* stream);
+
+/**
+ * @brief Write an array of uint16 values in little-endian format
+ * @param builder Builder instance
+ * @param values Values to write
+ * @param count Number of values
+ * @return 0 on success, -1 on error
+ * @note The *_array functions check capacity once and memcpy when the host
+ *       byte order matches; otherwise the bytes are swapped with SIMD
+ *       (SSE2/AVX2/NEON) where available.
+ */
+DB_DEF int db_builder_append_uint16_le_array(db_builder builder, const uint16_t* values, size_t count);
+
+/**
+ * @brief Write an array of uint16 values in big-endian format
+ * @param builder Builder instance
+ * @param values Values to write
+ * @param count Number of values
+ * @return 0 on success, -1 on error
+ */
+DB_DEF int db_builder_append_uint16_be_array(db_builder builder, const uint16_t* values, size_t count);
+
+/**
+ * @brief Write an array of uint32 values in little-endian format
+ * @param builder Builder instance
+ * @param values Values to write
+ * @param count Number of values
+ * @return 0 on success, -1 on error
+ */
+DB_DEF int db_builder_append_uint32_le_array(db_builder builder, const uint32_t* values, size_t count);
+
+/**
+ * @brief Write an array of uint32 values in big-endian format
+ * @param builder Builder instance
+ * @param values Values to write
+ * @param count Number of values
+ * @return 0 on success, -1 on error
+ */
+DB_DEF int db_builder_append_uint32_be_array(db_builder builder, const uint32_t* values, size_t count);
+
+/**
+ * @brief Write an array of uint64 values in little-endian format
+ * @param builder Builder instance
+ * @param values Values to write
+ * @param count Number of values
+ * @return 0 on success, -1 on error
+ */
+DB_DEF int db_builder_append_uint64_le_array(db_builder builder, const uint64_t* values, size_t count);
+
+/**
+ * @brief Write an array of uint64 values in big-endian format
+ * @param builder Builder instance
+ * @param values Values to write
+ * @param count Number of values
+ * @return 0 on success, -1 on error
+ */
+DB_DEF int db_builder_append_uint64_be_array(db_builder builder, const uint64_t* values, size_t count);
+
+/**
+ * @brief Read from a file descriptor directly into the builder's tail
+ * @param builder Builder instance
+ * @param fd File descriptor to read from
+ * @param max_bytes Maximum bytes to read (0 for spare capacity plus DB_READV_CHUNK_SIZE)
+ * @return Number of bytes read, 0 on end of file, or -1 on error
+ * @note Uses one readv() call that fills the builder's spare capacity first and
+ *       overflows into a DB_READV_CHUNK_SIZE block the builder keeps for later
+ *       calls, so a large read never forces the builder to grow up front.
+ *       Only the overflow part is copied (on Windows a plain read() into the
+ *       tail is used instead).
+ */
+DB_DEF ssize_t db_builder_readv(db_builder builder, int fd, size_t max_bytes);
+
+/** @} */
+
+/**
+ * @defgroup reader Buffer Reader API
+ * @brief Functions for reading buffers with primitive types and cursor
+ * @{
+ */
+
+/**
+ * @brief Opaque reader handle for parsing buffers
+ */
+typedef struct db_reader_internal* db_reader;
+
+/**
+ * @brief Create a new buffer reader
+ * @param buf Buffer to read from
+ * @return New reader instance
+ * 
+ * @par Example:
+ * @code
+ * db_reader reader = db_reader_new(buffer);
+ * uint16_t value = db_read_uint16_le(reader);
+ * char data[10];
+ * db_read_bytes(reader, data, sizeof(data));
+ * db_reader_release(&reader);
+ * @endcode
+ */
+DB_DEF db_reader db_reader_new(db_buffer buf);
+
+/**
+ * @brief Create a reader over a sub-range of a buffer without copying
+ * @param buf Buffer to read from (must not be NULL)
+ * @param offset Starting offset of the range in bytes
+ * @param length Number of bytes in the range
+ * @return New reader instance, or NULL if the range is out of bounds
+ * @note The reader retains @p buf and reads its bytes in place. Positions,
+ *       seeks and remaining counts are relative to the start of the range.
+ *
+ * @par Example:
+ * @code
+ * // Parse length-prefixed frames out of a large receive buffer
+ * size_t offset = 0;
+ * while (offset + 4 <= db_size(recv_buf)) {
+ *     db_reader header = db_reader_new_range(recv_buf, offset, 4);
+ *     uint32_t frame_len = db_read_uint32_be(header);
+ *     db_reader_release(&header);
+ *
+ *     db_reader frame = db_reader_new_range(recv_buf, offset + 4, frame_len);
+ *     if (!frame) break;  // incomplete frame
+ *     handle_frame(frame);
+ *     db_reader_release(&frame);
+ *     offset += 4 + frame_len;
+ * }
+ * @endcode
+ */
+DB_DEF db_reader db_reader_new_range(db_buffer buf, size_t offset, size_t length);
+
+/**
+ * @brief Increase reader reference count (share ownership)
+ * @param reader Reader to retain (must not be NULL)
+ * @return The same reader for convenience
+ */
+DB_DEF db_reader db_reader_retain(db_reader reader);
+
+/**
+ * @brief Decrease reader reference count and potentially free reader
+ * @param reader_ptr Pointer to reader variable (will be set to NULL)
+ */
+DB_DEF void db_reader_release(db_reader* reader_ptr);
+
+/**
+ * @brief Free reader resources (legacy name, use db_reader_release instead)
+ * @param reader_ptr Pointer to reader (will be set to NULL)
+ */
+DB_DEF void db_reader_free(db_reader* reader_ptr);
+
+/**
+ * @brief Get current read position
+ * @param reader Reader instance
+ * @return Current position in bytes
+ */
+DB_DEF size_t db_reader_position(db_reader reader);
+
+/**
+ * @brief Get number of bytes remaining
+ * @param reader Reader instance
+ * @return Remaining bytes from current position
+ */
+DB_DEF size_t db_reader_remaining(db_reader reader);
+
+/**
+ * @brief Check if reader can read specified number of bytes
+ * @param reader Reader instance
+ * @param bytes Number of bytes to check
+ * @return true if bytes are available
+ */
+DB_DEF bool db_reader_can_read(db_reader reader, size_t bytes);
+
+/**
+ * @brief Seek to specific position
+ * @param reader Reader instance
+ * @param position Position to seek to
+ */
+DB_DEF void db_reader_seek(db_reader reader, size_t position);
+
+/**
+ * @brief Look at the next bytes without copying or advancing
+ * @param reader Reader instance
+ * @param size Number of bytes needed
+ * @return Pointer to the next size bytes, or NULL if fewer remain
+ * @note The pointer stays valid for as long as the reader (or another
+ *       reference to its buffer) is alive.
+ */
+DB_DEF const void* db_reader_peek(db_reader reader, size_t size);
+
+/**
+ * @brief Borrow the next bytes in place and advance past them
+ * @param reader Reader instance
+ * @param size Number of bytes to consume
+ * @return Pointer to the consumed bytes, or NULL if fewer remain (nothing consumed)
+ * @note Zero-copy alternative to db_read_bytes() for length-prefixed fields;
+ *       same lifetime rules as db_reader_peek().
+ */
+DB_DEF const void* db_read_borrow(db_reader reader, size_t size);
+
+/**
+ * @brief Read the next bytes as a buffer and advance past them
+ * @param reader Reader instance
+ * @param size Number of bytes to consume
+ * @return Buffer holding the bytes (caller must release), or NULL if fewer remain
+ * @note Follows db_slice(): when the slice spans the whole underlying buffer
+ *       the buffer is shared (retained), otherwise the bytes are copied. Use
+ *       db_read_borrow() when a pointer is enough.
+ */
+DB_DEF db_buffer db_read_slice(db_reader reader, size_t size);
+
+/**
+ * @brief Read uint8 value
+ * @param reader Reader instance
+ * @return Read value
+ */
+DB_DEF uint8_t db_read_uint8(db_reader reader);
+
+/**
+ * @brief Read uint16 value in little-endian format
+ * @param reader Reader instance
+ * @return Read value
+ */
+DB_DEF uint16_t db_read_uint16_le(db_reader reader);
+
+/**
+ * @brief Read uint16 value in big-endian format
+ * @param reader Reader instance
+ * @return Read value
+ */
+DB_DEF uint16_t db_read_uint16_be(db_reader reader);
+
+/**
+ * @brief Read uint32 value in little-endian format
+ * @param reader Reader instance
+ * @return Read value
+ */
+DB_DEF uint32_t db_read_uint32_le(db_reader reader);
+
+/**
+ * @brief Read uint32 value in big-endian format
+ * @param reader Reader instance
+ * @return Read value
+ */
+DB_DEF uint32_t db_read_uint32_be(db_reader reader);
+
+/**
+ * @brief Read uint64 value in little-endian format
+ * @param reader Reader instance
+ * @return Read value
+ */
+DB_DEF uint64_t db_read_uint64_le(db_reader reader);
+
+/**
+ * @brief Read uint64 value in big-endian format
+ * @param reader Reader instance
+ * @return Read value
+ */
+DB_DEF uint64_t db_read_uint64_be(db_reader reader);
+
+/**
+ * @brief Read raw bytes
+ * @param reader Reader instance
+ * @param data Output buffer for data
+ * @param size Number of bytes to read
+ */
+DB_DEF void db_read_bytes(db_reader reader, void* data, size_t size);
+
+/**
+ * @brief Read unsigned LEB128 varint
+ * @param reader Reader instance
+ * @return Decoded value
+ * @note Asserts on truncated or overlong (more than 10 byte) input. When at
+ *       least 10 bytes remain the varint is decoded from one 64-bit load.
+ */
+DB_DEF uint64_t db_read_varint_u64(db_reader reader);
+
+/**
+ * @brief Read zigzag-encoded signed varint
+ * @param reader Reader instance
+ * @return Decoded value
+ */
+DB_DEF int64_t db_read_varint_s64(db_reader reader);
+
+/**
+ * @brief Read up to count unsigned varints into an array
+ * @param reader Reader instance
+ * @param values Output array with room for count values
+ * @param count Number of varints to read
+ * @return Number of varints decoded; less than count if the data ends or a
+ *         malformed varint is found (the reader stops in front of it)
+ * @note Runs of single-byte varints are widened 16 (SSE2) or 8 at a time.
+ */
+DB_DEF size_t db_read_varints_u64(db_reader reader, uint64_t* values, size_t count);
+
+/**
+ * @brief Read an array of little-endian uint16 values
+ * @param reader Reader instance
+ * @param values Output array with room for count values
+ * @param count Number of values to read
+ * @note The *_array functions do a single bounds check and memcpy when the
+ *       host byte order matches; otherwise the bytes are swapped with SIMD
+ *       (SSE2/AVX2/NEON) where available.
+ */
+DB_DEF void db_read_uint16_le_array(db_reader reader, uint16_t* values, size_t count);
+
+/**
+ * @brief Read an array of big-endian uint16 values
+ * @param reader Reader instance
+ * @param values Output array with room for count values
+ * @param count Number of values to read
+ */
+DB_DEF void db_read_uint16_be_array(db_reader reader, uint16_t* values, size_t count);
+
+/**
+ * @brief Read an array of little-endian uint32 values
+ * @param reader Reader instance
+ * @param values Output array with room for count values
+ * @param count Number of values to read
+ */
+DB_DEF void db_read_uint32_le_array(db_reader reader, uint32_t* values, size_t count);
+
+/**
+ * @brief Read an array of big-endian uint32 values
+ * @param reader Reader instance
+ * @param values Output array with room for count values
+ * @param count Number of values to read
+ */
+DB_DEF void db_read_uint32_be_array(db_reader reader, uint32_t* values, size_t count);
+
+/**
+ * @brief Read an array of little-endian uint64 values
+ * @param reader Reader instance
+ * @param values Output array with room for count values
+ * @param count Number of values to read
+ */
+DB_DEF void db_read_uint64_le_array(db_reader reader, uint64_t* values, size_t count);
+
+/**
+ * @brief Read an array of big-endian uint64 values
+ * @param reader Reader instance
+ * @param values Output array with room for count values
+ * @param count Number of values to read
+ */
+DB_DEF void db_read_uint64_be_array(db_reader reader, uint64_t* values, size_t count);
+
+/** @} */
+
+/**
+ * @defgroup cursor Inline Cursor
+ * @brief Unchecked header-inline reads for hot parsing loops
+ *
+ * A db_cursor is a plain struct of three pointers. Its reads are
+ * `static inline` and do no checking, so a loop over records can inline
+ * and vectorize completely. Check the whole record once with
+ * db_cursor_has(), then read its fields without further tests. Reading
+ * past @c end is undefined behaviour.
+ *
+ * @par Example:
+ * @code
+ * db_cursor c = db_reader_cursor(reader);
+ * while (db_cursor_has(&c, 12)) {
+ *     uint32_t id = db_cursor_read_uint32_le(&c);
+ *     uint64_t ts = db_cursor_read_uint64_le(&c);
+ *     ...
+ * }
+ * db_reader_seek(reader, db_cursor_position(&c));  // hand progress back
+ * @endcode
+ * @{
+ */
+
+/**
+ * @brief Unchecked read position over a byte range
+ */
+typedef struct db_cursor {
+    const uint8_t* begin;  ///< Start of the range
+    const uint8_t* cur;    ///< Next byte to read
+    const uint8_t* end;    ///< One past the last readable byte
+} db_cursor;
+
+/**
+ * @brief Create a cursor over the whole buffer
+ * @param buf Buffer to read (must outlive the cursor)
+ * @return Cursor positioned at the start of buf
+ */
+DB_DEF db_cursor db_cursor_from_buffer(db_buffer buf);
+
+/**
+ * @brief Create a cursor over a reader's range, starting at its position
+ * @param reader Reader instance (must outlive the cursor)
+ * @return Cursor whose positions match db_reader_position()
+ * @note The reader does not see the cursor's progress; pass
+ *       db_cursor_position() to db_reader_seek() when done.
+ */
+DB_DEF db_cursor db_reader_cursor(db_reader reader);
+
+/**
+ * @brief Get the cursor position relative to begin
+ */
+static inline size_t db_cursor_position(const db_cursor* c) {
+    return (size_t)(c->cur - c->begin);
+}
+
+/**
+ * @brief Get the number of bytes left
+ */
+static inline size_t db_cursor_remaining(const db_cursor* c) {
+    return (size_t)(c->end - c->cur);
+}
+
+/**
+ * @brief Check that at least size bytes are left
+ */
+static inline bool db_cursor_has(const db_cursor* c, size_t size) {
+    return (size_t)(c->end - c->cur) >= size;
+}
+
+/**
+ * @brief Skip size bytes (unchecked)
+ */
+static inline void db_cursor_skip(db_cursor* c, size_t size) {
+    c->cur += size;
+}
+
+/**
+ * @brief Borrow the next size bytes in place and advance (unchecked)
+ */
+static inline const void* db_cursor_read_ptr(db_cursor* c, size_t size) {
+    const uint8_t* p = c->cur;
+    c->cur += size;
+    return p;
+}
+
+/**
+ * @brief Copy the next size bytes out and advance (unchecked)
+ */
+static inline void db_cursor_read_bytes(db_cursor* c, void* data, size_t size) {
+    memcpy(data, c->cur, size);
+    c->cur += size;
+}
+
+/**
+ * @brief Read uint8 (unchecked)
+ */
+static inline uint8_t db_cursor_read_uint8(db_cursor* c) {
+    return *c->cur++;
+}
+
+// GCC and Clang turn the shift/or forms below into single loads (plus a
+// bswap for big-endian).
+
+/**
+ * @brief Read little-endian uint16 (unchecked)
+ */
+static inline uint16_t db_cursor_read_uint16_le(db_cursor* c) {
+    const uint8_t* p = c->cur;
+    c->cur += 2;
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+/**
+ * @brief Read big-endian uint16 (unchecked)
+ */
+static inline uint16_t db_cursor_read_uint16_be(db_cursor* c) {
+    const uint8_t* p = c->cur;
+    c->cur += 2;
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+/**
+ * @brief Read little-endian uint32 (unchecked)
+ */
+static inline uint32_t db_cursor_read_uint32_le(db_cursor* c) {
+    const uint8_t* p = c->cur;
+    c->cur += 4;
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+ * @brief Read big-endian uint32 (unchecked)
+ */
+static inline uint32_t db_cursor_read_uint32_be(db_cursor* c) {
+    const uint8_t* p = c->cur;
+    c->cur += 4;
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+/**
+ * @brief Read little-endian uint64 (unchecked)
+ */
+static inline uint64_t db_cursor_read_uint64_le(db_cursor* c) {
+    const uint8_t* p = c->cur;
+    c->cur += 8;
+    return (uint64_t)p[0] | ((uint64_t)p[1] << 8) | ((uint64_t)p[2] << 16) | ((uint64_t)p[3] << 24) |
+           ((uint64_t)p[4] << 32) | ((uint64_t)p[5] << 40) | ((uint64_t)p[6] << 48) | ((uint64_t)p[7] << 56);
+}
+
+/**
+ * @brief Read big-endian uint64 (unchecked)
+ */
+static inline uint64_t db_cursor_read_uint64_be(db_cursor* c) {
+    const uint8_t* p = c->cur;
+    c->cur += 8;
+    return ((uint64_t)p[0] << 56) | ((uint64_t)p[1] << 48) | ((uint64_t)p[2] << 40) | ((uint64_t)p[3] << 32) |
+           ((uint64_t)p[4] << 24) | ((uint64_t)p[5] << 16) | ((uint64_t)p[6] << 8) | (uint64_t)p[7];
+}
+
+/** @} */
+
+/**
+ * @defgroup chain Buffer Chains
+ * @brief Scatter/gather lists of buffers that are joined without copying
+ *
+ * A chain holds retained references to a sequence of buffers. Segments can
+ * be added at either end in O(1) and written out with a single writev().
+ * Bytes are only copied when db_chain_flatten() is asked for a contiguous
+ * buffer.
+ * @{
+ */
+
+/**
+ * @brief Opaque chain handle
+ */
+typedef struct db_chain_internal* db_chain;
+
+/**
+ * @brief Create a new empty chain
+ * @return New chain instance (asserts on allocation failure)
+ *
+ * @par Example:
+ * @code
+ * db_chain response = db_chain_new();
+ * db_chain_append(response, cached_body);
+ * db_chain_prepend(response, header);
+ * db_chain_append(response, trailer);
+ * db_chain_write_fd(response, socket_fd);  // one writev, no flatten
+ * db_chain_release(&response);
+ * @endcode
+ */
+DB_DEF db_chain db_chain_new(void);
+
+/**
+ * @brief Increase chain reference count (share ownership)
+ * @param chain Chain to retain (must not be NULL)
+ * @return The same chain for convenience
+ */
+DB_DEF db_chain db_chain_retain(db_chain chain);
+
+/**
+ * @brief Decrease chain reference count and potentially free chain
+ * @param chain_ptr Pointer to chain variable (will be set to NULL)
+ * @note Releases the chain's reference to every segment
+ */
+DB_DEF void db_chain_release(db_chain* chain_ptr);
+
+/**
+ * @brief Add a buffer at the end of the chain
+ * @param chain Chain instance (must not be NULL)
+ * @param buf Buffer to add (must not be NULL, retained by the chain)
+ */
+DB_DEF void db_chain_append(db_chain chain, db_buffer buf);
+
+/**
+ * @brief Add a buffer at the front of the chain
+ * @param chain Chain instance (must not be NULL)
+ * @param buf Buffer to add (must not be NULL, retained by the chain)
+ */
+DB_DEF void db_chain_prepend(db_chain chain, db_buffer buf);
+
+/**
+ * @brief Get the total number of bytes in the chain
+ * @param chain Chain instance (must not be NULL)
+ * @return Sum of all segment sizes
+ */
+DB_DEF size_t db_chain_size(db_chain chain);
+
+/**
+ * @brief Get the number of segments in the chain
+ * @param chain Chain instance (must not be NULL)
+ * @return Number of segments
+ */
+DB_DEF size_t db_chain_count(db_chain chain);
+
+/**
+ * @brief Get a segment by index
+ * @param chain Chain instance (must not be NULL)
+ * @param index Segment index (must be < db_chain_count())
+ * @return Borrowed segment (retain it to keep it beyond the chain's lifetime)
+ */
+DB_DEF db_buffer db_chain_segment(db_chain chain, size_t index);
+
+/**
+ * @brief Get the chain contents as one contiguous buffer
+ * @param chain Chain instance (must not be NULL)
+ * @return New reference to a buffer holding all bytes of the chain
+ * @note Multiple segments are joined once and the chain then holds the joined
+ *       buffer as its only segment, so repeated calls don't copy again.
+ */
+DB_DEF db_buffer db_chain_flatten(db_chain chain);
+
+/**
+ * @brief Write the chain to a file descriptor with one writev() call
+ * @param chain Chain instance (must not be NULL)
+ * @param fd File descriptor to write to
+ * @return Number of bytes written, or -1 on error
+ * @note Like db_write_fd(), a short write returns the partial count
+ */
+DB_DEF ssize_t db_chain_write_fd(db_chain chain, int fd);
+
+/**
+ * @brief Write a chain with writev(), resuming from a cursor
+ * @param chain Chain instance (must not be NULL)
+ * @param fd File descriptor to write to
+ * @param cursor Write progress over the chain's segments (must not be NULL)
+ * @return Number of bytes written by this call, or -1 on error (errno is set)
+ * @note Same semantics as db_write_fdv(). Don't add or remove segments at the
+ *       front of the chain while a write is in progress.
+ */
+DB_DEF ssize_t db_chain_write_fdv(db_chain chain, int fd, db_write_cursor* cursor);
+
+/** @} */
+
+#if DB_ATOMIC_REFCOUNT
+
+/**
+ * @defgroup queue Buffer Queues
+ * @brief Bounded lock-free queues for handing buffers between threads
+ *
+ * Queues move buffer references between threads. A successful push takes
+ * over the caller's reference and a pop hands it to the consumer, so no
+ * retain/release pair is paid per message. Pushing also calls db_share(),
+ * so buffers counted locally under DB_LOCAL_REFCOUNT switch to atomic
+ * counting before the consumer can see them.
+ *
+ * db_spsc allows exactly one producer thread and one consumer thread.
+ * db_mpmc allows any number of both. Neither queue blocks: push reports a
+ * full queue and pop reports an empty one, and the caller decides whether
+ * to spin, yield or park. Only available with DB_ATOMIC_REFCOUNT=1.
+ * @{
+ */
+
+/**
+ * @brief Opaque single-producer/single-consumer queue handle
+ */
+typedef struct db_spsc_internal* db_spsc;
+
+/**
+ * @brief Opaque multi-producer/multi-consumer queue handle
+ */
+typedef struct db_mpmc_internal* db_mpmc;
+
+/**
+ * @brief Create a single-producer/single-consumer queue
+ * @param capacity Minimum number of buffers the queue holds (must be > 0, rounded up to a power of two)
+ * @return New queue instance (asserts on allocation failure)
+ *
+ * @par Example:
+ * @code
+ * // I/O thread
+ * while (!db_spsc_push(queue, packet)) sched_yield();  // packet now belongs to the queue
+ *
+ * // Worker thread
+ * db_buffer packet = db_spsc_pop(queue);
+ * if (packet) {
+ *     handle(packet);
+ *     db_release(&packet);
+ * }
+ * @endcode
+ */
+DB_DEF db_spsc db_spsc_new(size_t capacity);
+
+/**
+ * @brief Increase queue reference count (share ownership)
+ * @param queue Queue to retain (must not be NULL)
+ * @return The same queue for convenience
+ */
+DB_DEF db_spsc db_spsc_retain(db_spsc queue);
+
+/**
+ * @brief Decrease queue reference count and potentially free queue
+ * @param queue_ptr Pointer to queue variable (will be set to NULL)
+ * @note Releases every buffer still in the queue
+ */
+DB_DEF void db_spsc_release(db_spsc* queue_ptr);
+
+/**
+ * @brief Push one buffer (producer thread only)
+ * @param queue Queue instance (must not be NULL)
+ * @param buf Buffer to push (must not be NULL)
+ * @return true if pushed (the queue now owns the caller's reference), false if full
+ */
+DB_DEF bool db_spsc_push(db_spsc queue, db_buffer buf);
+
+/**
+ * @brief Push up to count buffers (producer thread only)
+ * @param queue Queue instance (must not be NULL)
+ * @param buffers Buffers to push in order (none may be NULL)
+ * @param count Number of buffers
+ * @return Number pushed; the queue owns buffers[0..n) and the caller keeps the rest
+ */
+DB_DEF size_t db_spsc_push_batch(db_spsc queue, const db_buffer* buffers, size_t count);
+
+/**
+ * @brief Pop one buffer (consumer thread only)
+ * @param queue Queue instance (must not be NULL)
+ * @return Oldest buffer (the caller owns the reference), or NULL if empty
+ */
+DB_DEF db_buffer db_spsc_pop(db_spsc queue);
+
+/**
+ * @brief Pop up to max buffers (consumer thread only)
+ * @param queue Queue instance (must not be NULL)
+ * @param out Array receiving the buffers in order
+ * @param max Capacity of out
+ * @return Number of buffers stored in out (the caller owns each reference)
+ */
+DB_DEF size_t db_spsc_pop_batch(db_spsc queue, db_buffer* out, size_t max);
+
+/**
+ * @brief Get the number of queued buffers
+ * @param queue Queue instance (must not be NULL)
+ * @return Number of buffers; only a snapshot while other threads are active
+ */
+DB_DEF size_t db_spsc_size(db_spsc queue);
+
+/**
+ * @brief Get the queue capacity
+ * @param queue Queue instance (must not be NULL)
+ * @return Maximum number of buffers the queue holds
+ */
+DB_DEF size_t db_spsc_capacity(db_spsc queue);
+
+/**
+ * @brief Create a multi-producer/multi-consumer queue
+ * @param capacity Minimum number of buffers the queue holds (must be > 0, rounded up to a power of two >= 2)
+ * @return New queue instance (asserts on allocation failure)
+ */
+DB_DEF db_mpmc db_mpmc_new(size_t capacity);
+
+/**
+ * @brief Increase queue reference count (share ownership)
+ * @param queue Queue to retain (must not be NULL)
+ * @return The same queue for convenience
+ */
+DB_DEF db_mpmc db_mpmc_retain(db_mpmc queue);
+
+/**
+ * @brief Decrease queue reference count and potentially free queue
+ * @param queue_ptr Pointer to queue variable (will be set to NULL)
+ * @note Releases every buffer still in the queue
+ */
+DB_DEF void db_mpmc_release(db_mpmc* queue_ptr);
+
+/**
+ * @brief Push one buffer (any thread)
+ * @param queue Queue instance (must not be NULL)
+ * @param buf Buffer to push (must not be NULL)
+ * @return true if pushed (the queue now owns the caller's reference), false if full
+ */
+DB_DEF bool db_mpmc_push(db_mpmc queue, db_buffer buf);
+
+/**
+ * @brief Push up to count buffers as one contiguous run (any thread)
+ * @param queue Queue instance (must not be NULL)
+ * @param buffers Buffers to push in order (none may be NULL)
+ * @param count Number of buffers
+ * @return Number pushed; the queue owns buffers[0..n) and the caller keeps the rest
+ * @note The run claims its slots with a single compare-and-swap, so consumers
+ *       see the buffers in order with no other producer's buffers in between.
+ */
+DB_DEF size_t db_mpmc_push_batch(db_mpmc queue, const db_buffer* buffers, size_t count);
+
+/**
+ * @brief Pop one buffer (any thread)
+ * @param queue Queue instance (must not be NULL)
+ * @return Oldest buffer (the caller owns the reference), or NULL if empty
+ */
+DB_DEF db_buffer db_mpmc_pop(db_mpmc queue);
+
+/**
+ * @brief Pop up to max buffers as one contiguous run (any thread)
+ * @param queue Queue instance (must not be NULL)
+ * @param out Array receiving the buffers in order
+ * @param max Capacity of out
+ * @return Number of buffers stored in out (the caller owns each reference)
+ */
+DB_DEF size_t db_mpmc_pop_batch(db_mpmc queue, db_buffer* out, size_t max);
+
+/**
+ * @brief Get the approximate number of queued buffers
+ * @param queue Queue instance (must not be NULL)
+ * @return Number of buffers; only a snapshot while other threads are active
+ */
+DB_DEF size_t db_mpmc_size(db_mpmc queue);
+
+/**
+ * @brief Get the queue capacity
+ * @param queue Queue instance (must not be NULL)
+ * @return Maximum number of buffers the queue holds
+ */
+DB_DEF size_t db_mpmc_capacity(db_mpmc queue);
+
+/** @} */
+
+#endif // DB_ATOMIC_REFCOUNT
+
+// Implementation section - only compiled when DB_IMPLEMENTATION is defined
+#ifdef DB_IMPLEMENTATION
+
+/**
+ * @brief Internal buffer metadata structure
+ * @private
+ * 
+ * This structure is stored at negative offsets before the buffer data.
+ * The db_buffer points directly to the data portion. On LP64 it is 24 bytes,
+ * or 16 with DB_COMPACT_HEADER; either way the data stays 8-byte aligned.
+ */
+typedef struct db_internal {
+    db_refcount_t refcount;    ///< Reference count for memory management
+    uint32_t flags;            ///< Storage kind (DB_KIND_*) and flag bits
+    db_length_t size;          ///< Current size of valid data in bytes
+    db_length_t capacity;      ///< Total allocated capacity in bytes
+#if DB_CACHE_HASH
+    db_hash_t hash;            ///< Cached db_hash() value (0 when not computed)
+#endif
+} db_internal;
+
+// Storage kinds (low bits of db_internal.flags)
+#define DB_KIND_MASK 0x0Fu
+#define DB_KIND_HEAP 0u        ///< Single DB_MALLOC block: [db_internal|data]
+#define DB_KIND_EXTERNAL 1u    ///< Caller block: [db_external|...|db_internal|data]
+#define DB_KIND_ALLOCATOR 2u   ///< Allocator block: [db_allocated|db_internal|data]
+#define DB_KIND_MAPPED 3u      ///< File mapping: [header page ...|db_mapping|db_internal][file pages]
+
+// Flag bits (above DB_KIND_MASK in db_internal.flags)
+#define DB_FLAG_SHARED 0x10u   ///< Refcount is updated atomically (see db_share)
+
+/**
+ * @brief Ownership record for external buffers
+ * @private
+ *
+ * Stored directly in front of db_internal inside the caller's header area.
+ */
+typedef struct db_external {
+    db_free_fn free_fn;        ///< Callback that frees the block (may be NULL)
+    void* user;                ///< User pointer for free_fn
+    void* block;               ///< Start of the caller's block
+} db_external;
+
+_Static_assert(sizeof(db_external) + sizeof(db_internal) <= DB_EXTERNAL_HEADER_SIZE,
+               "DB_EXTERNAL_HEADER_SIZE too small for buffer metadata");
+
+/**
+ * @brief Allocator record for buffers created with a custom allocator
+ * @private
+ *
+ * Padded to 8 bytes so the data keeps the alignment of the block.
+ */
+typedef union db_allocated {
+    const db_allocator* allocator; ///< Allocator that owns the block
+    uint64_t align;                ///< Keeps the record 8-byte sized
+} db_allocated;
+
+// Memory-mapped file support
+#ifndef DB_HAVE_MMAP
+#if defined(__unix__) || defined(__APPLE__)
+#define DB_HAVE_MMAP 1
+#else
+#define DB_HAVE_MMAP 0
+#endif
+#endif
+
+#if DB_HAVE_MMAP
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#if !defined(MAP_ANONYMOUS) && defined(MAP_ANON)
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+#if !defined(MAP_ANONYMOUS) || !defined(MADV_NORMAL)
+// Strict ISO modes hide the BSD mapping extensions; fall back to reading
+#undef DB_HAVE_MMAP
+#define DB_HAVE_MMAP 0
+#endif
+#endif
+
+#if DB_HAVE_MMAP
+
+/**
+ * @brief Mapping record for memory-mapped buffers
+ * @private
+ *
+ * Stored in front of db_internal at the end of an anonymous header page that
+ * sits directly before the file pages, so the data stays contiguous with
+ * its metadata.
+ */
+typedef struct db_mapping {
+    void* base;                ///< Start of the whole reservation (header page)
+    size_t length;             ///< Length of the whole reservation
+} db_mapping;
+
+static inline db_mapping* db_mapping_of(db_internal* meta) {
+    return (db_mapping*)((uintptr_t)meta - sizeof(db_mapping));
+}
+#endif
+
+/**
+ * @brief Get pointer to metadata for a buffer
+ * @param buf Buffer handle (must not be NULL)
+ * @return Pointer to metadata structure
+ */
+static inline db_internal* db_meta(db_buffer buf) {
+    // Integer arithmetic: GCC's -Warray-bounds would otherwise flag every
+    // header access as an out-of-bounds read in front of the allocation
+    return (db_internal*)((uintptr_t)buf - sizeof(db_internal));
+}
+
+/**
+ * @brief Get the allocator record of an allocator-backed buffer
+ * @private
+ */
+static inline db_allocated* db_allocated_of(db_internal* meta) {
+    return (db_allocated*)((uintptr_t)meta - sizeof(db_allocated));
+}
+
+/**
+ * @brief Get the ownership record of an external buffer
+ * @private
+ */
+static inline db_external* db_external_of(db_internal* meta) {
+    return (db_external*)((uintptr_t)meta - sizeof(db_external));
+}
+
+/**
+ * @brief Get the allocator a buffer was created with
+ * @private
+ * @return Allocator, or NULL for default heap (and non-reallocatable) storage
+ */
+static const db_allocator* db_buffer_allocator(db_buffer buf) {
+    db_internal* meta = db_meta(buf);
+    if ((meta->flags & DB_KIND_MASK) == DB_KIND_ALLOCATOR) {
+        return db_allocated_of(meta)->allocator;
+    }
+    return NULL;
+}
+
+// Allocation and copy counters
+#if DB_STATS
+static DB_THREAD_LOCAL db_stats db_stats_tls;
+
+static void db_stats_live(int64_t delta) {
+    db_stats_tls.live_bytes += delta;
+    if (db_stats_tls.live_bytes > db_stats_tls.peak_live_bytes) {
+        db_stats_tls.peak_live_bytes = db_stats_tls.live_bytes;
+    }
+}
+
+#define DB_STATS_ADD(field, n) (db_stats_tls.field += (uint64_t)(n))
+#define DB_STATS_LIVE(old_capacity, new_capacity) \
+    db_stats_live((int64_t)(new_capacity) - (int64_t)(old_capacity))
+#else
+#define DB_STATS_ADD(field, n) ((void)0)
+#define DB_STATS_LIVE(old_capacity, new_capacity) ((void)0)
+#endif
+
+/**
+ * @brief Allocate memory for buffer with metadata
+ * @private
+ */
+static db_buffer db_alloc_ex(size_t capacity, const db_allocator* allocator) {
+    // Allocate: [allocator record] + metadata + buffer data
+    size_t prefix = allocator ? sizeof(db_allocated) : 0;
+    size_t header_size = prefix + sizeof(db_internal);
+    size_t total_size = header_size + capacity;
+    
+    // Check for overflow
+    if (total_size < header_size || total_size < capacity) {
+        return NULL;
+    }
+    DB_ASSERT(capacity <= DB_MAX_CAPACITY && "db_alloc: capacity exceeds DB_MAX_CAPACITY");
+    
+    void* block = allocator ? allocator->alloc(allocator->user, total_size) : DB_MALLOC(total_size);
+    DB_ASSERT(block && "db_alloc: memory allocation failed");
+    DB_STATS_ADD(allocations, 1);
+    DB_STATS_LIVE(0, capacity);
+    
+    // Initialize metadata
+    db_internal* meta = (db_internal*)((char*)block + prefix);
+    meta->refcount = DB_REFCOUNT_INIT(1);
+    meta->flags = allocator ? DB_KIND_ALLOCATOR : DB_KIND_HEAP;
+    DB_HASH_RESET(meta);
+    meta->size = 0;
+    meta->capacity = capacity;
+    if (allocator) {
+        db_allocated_of(meta)->allocator = allocator;
+    }
+    
+    // Return pointer to buffer data portion
+    return (db_buffer)((char*)meta + sizeof(db_internal));
+}
+
+static db_buffer db_alloc(size_t capacity) {
+    return db_alloc_ex(capacity, NULL);
+}
+
+/**
+ * @brief Free buffer memory
+ * @private
+ */
+static void db_dealloc(db_buffer buf) {
+    if (!buf) return;
+    
+    db_internal* meta = db_meta(buf);
+    switch (meta->flags & DB_KIND_MASK) {
+        case DB_KIND_EXTERNAL: {
+            db_external* ext = db_external_of(meta);
+            if (ext->free_fn) {
+                ext->free_fn(ext->block, ext->user);
+            }
+            break;
+        }
+#if DB_HAVE_MMAP
+        case DB_KIND_MAPPED: {
+            db_mapping* mapping = db_mapping_of(meta);
+            munmap(mapping->base, mapping->length);
+            break;
+        }
+#endif
+        case DB_KIND_ALLOCATOR: {
+            const db_allocator* allocator = db_allocated_of(meta)->allocator;
+            size_t total_size = sizeof(db_allocated) + sizeof(db_internal) + meta->capacity;
+            DB_STATS_ADD(frees, 1);
+            DB_STATS_LIVE(meta->capacity, 0);
+            allocator->free(allocator->user, db_allocated_of(meta), total_size);
+            break;
+        }
+        default:
+            // Get original malloc pointer and free it
+            DB_STATS_ADD(frees, 1);
+            DB_STATS_LIVE(meta->capacity, 0);
+            DB_FREE(meta);
+            break;
+    }
+}
+
+// Built-in size-class pool allocator
+
+#define DB_SMALL_POOL_CLASSES 6      ///< Block sizes 64, 128, ..., 2048 bytes
+#define DB_SMALL_POOL_MIN_SHIFT 6    ///< log2 of the smallest class
+#define DB_SMALL_POOL_MAX_CACHED 256 ///< Cached blocks per class per thread
+
+typedef struct db_small_node {
+    struct db_small_node* next;
+} db_small_node;
+
+static DB_THREAD_LOCAL db_small_node* db_small_free_list[DB_SMALL_POOL_CLASSES];
+static DB_THREAD_LOCAL unsigned db_small_free_count[DB_SMALL_POOL_CLASSES];
+
+/**
+ * @brief Map a block size to its size class
+ * @private
+ * @return Class index, or -1 if the block is too large for the pool
+ */
+static int db_small_class(size_t size) {
+    int cls = 0;
+    size_t class_size = (size_t)1 << DB_SMALL_POOL_MIN_SHIFT;
+    while (class_size < size) {
+        if (++cls == DB_SMALL_POOL_CLASSES) return -1;
+        class_size <<= 1;
+    }
+    return cls;
+}
+
+static void* db_small_alloc(void* user, size_t size) {
+    (void)user;
+    int cls = db_small_class(size);
+    if (cls < 0) return DB_MALLOC(size);
+    
+    db_small_node* node = db_small_free_list[cls];
+    if (node) {
+        db_small_free_list[cls] = node->next;
+        db_small_free_count[cls]--;
+        return node;
+    }
+    return DB_MALLOC((size_t)1 << (cls + DB_SMALL_POOL_MIN_SHIFT));
+}
+
+static void db_small_free(void* user, void* ptr, size_t size) {
+    (void)user;
+    int cls = db_small_class(size);
+    if (cls < 0 || db_small_free_count[cls] >= DB_SMALL_POOL_MAX_CACHED) {
+        DB_FREE(ptr);
+        return;
+    }
+    
+    db_small_node* node = (db_small_node*)ptr;
+    node->next = db_small_free_list[cls];
+    db_small_free_list[cls] = node;
+    db_small_free_count[cls]++;
+}
+
+static void* db_small_realloc(void* user, void* ptr, size_t old_size, size_t new_size) {
+    int old_cls = db_small_class(old_size);
+    int new_cls = db_small_class(new_size);
+    
+    if (old_cls >= 0 && old_cls == new_cls) return ptr;  // Still fits its block
+    if (old_cls < 0 && new_cls < 0) return DB_REALLOC(ptr, new_size);
+    
+    void* new_ptr = db_small_alloc(user, new_size);
+    if (!new_ptr) return NULL;
+    memcpy(new_ptr, ptr, old_size < new_size ? old_size : new_size);
+    db_small_free(user, ptr, old_size);
+    return new_ptr;
+}
+
+static const db_allocator db_small_pool = {
+    db_small_alloc,
+    db_small_realloc,
+    db_small_free,
+    NULL
+};
+
+// Arena allocator
+
+#define DB_ARENA_DEFAULT_CHUNK (64 * 1024)
+#define DB_ARENA_ALIGN 16
+
+typedef struct db_arena_chunk {
+    struct db_arena_chunk* next;   // Next chunk in the chain
+    size_t size;                   // Usable bytes after the chunk header
+} db_arena_chunk;
+
+struct db_arena_internal {
+    db_allocator allocator;        // Allocator handed out to callers (user = arena)
+    db_arena_chunk* first;         // First regular chunk (kept across resets)
+    db_arena_chunk* current;       // Chunk currently being bumped
+    size_t offset;                 // Bump offset into current chunk
+    db_arena_chunk* large;         // Oversized blocks, freed on reset
+    size_t chunk_size;             // Usable size of regular chunks
+    size_t used;                   // Bytes handed out since last reset
+    void* last;                    // Most recent allocation (for in-place growth)
+    size_t last_size;              // Size of the most recent allocation
+};
+
+#define DB_ARENA_CHUNK_HEADER \
+    ((sizeof(db_arena_chunk) + DB_ARENA_ALIGN - 1) & ~(size_t)(DB_ARENA_ALIGN - 1))
+
+static inline char* db_arena_chunk_data(db_arena_chunk* chunk) {
+    return (char*)chunk + DB_ARENA_CHUNK_HEADER;
+}
+
+static db_arena_chunk* db_arena_new_chunk(size_t size) {
+    db_arena_chunk* chunk = (db_arena_chunk*)DB_MALLOC(DB_ARENA_CHUNK_HEADER + size);
+    DB_ASSERT(chunk && "db_arena: memory allocation failed");
+    chunk->next = NULL;
+    chunk->size = size;
+    return chunk;
+}
+
+static void* db_arena_alloc(void* user, size_t size) {
+    struct db_arena_internal* arena = (struct db_arena_internal*)user;
+    size_t aligned = (size + DB_ARENA_ALIGN - 1) & ~(size_t)(DB_ARENA_ALIGN - 1);
+    
+    if (aligned > arena->chunk_size) {
+        // Too big for a chunk - give it a block of its own
+        db_arena_chunk* chunk = db_arena_new_chunk(aligned);
+        chunk->next = arena->large;
+        arena->large = chunk;
+        arena->used += aligned;
+        arena->last = NULL;
+        return db_arena_chunk_data(chunk);
+    }
+    
+    if (arena->current->size - arena->offset < aligned) {
+        // Move on to the next chunk, reusing chunks kept from before a reset
+        if (!arena->current->next) {
+            arena->current->next = db_arena_new_chunk(arena->chunk_size);
+        }
+        arena->current = arena->current->next;
+        arena->offset = 0;
+    }
+    
+    void* ptr = db_arena_chunk_data(arena->current) + arena->offset;
+    arena->offset += aligned;
+    arena->used += aligned;
+    arena->last = ptr;
+    arena->last_size = aligned;
+    return ptr;
+}
+
+static void db_arena_free(void* user, void* ptr, size_t size) {
+    struct db_arena_internal* arena = (struct db_arena_internal*)user;
+    (void)size;
+    
+    // Memory is reclaimed by db_arena_reset(); only the newest block can be rolled back
+    if (ptr && ptr == arena->last) {
+        arena->offset -= arena->last_size;
+        arena->used -= arena->last_size;
+        arena->last = NULL;
+    }
+}
+
+static void* db_arena_realloc(void* user, void* ptr, size_t old_size, size_t new_size) {
+    struct db_arena_internal* arena = (struct db_arena_internal*)user;
+    size_t aligned = (new_size + DB_ARENA_ALIGN - 1) & ~(size_t)(DB_ARENA_ALIGN - 1);
+    
+    // Grow the newest block in place while it still fits its chunk
+    if (ptr == arena->last) {
+        size_t start = arena->offset - arena->last_size;
+        if (aligned <= arena->current->size - start) {
+            arena->offset = start + aligned;
+            arena->used = arena->used - arena->last_size + aligned;
+            arena->last_size = aligned;
+            return ptr;
+        }
+    }
+    
+    void* new_ptr = db_arena_alloc(user, new_size);
+    memcpy(new_ptr, ptr, old_size < new_size ? old_size : new_size);
+    return new_ptr;
+}
+
+// Recycling buffer pool
+
+typedef struct db_pool_node {
+    struct db_pool_node* next;
+} db_pool_node;
+
+struct db_pool_internal {
+    db_allocator allocator;        // Allocator handed out to callers (user = pool)
+    uint64_t id;                   // Unique id, matched against the thread caches
+    size_t capacity;               // Buffer capacity of every pool block
+    size_t block_size;             // Full block size requested by db_alloc_ex
+    size_t low_watermark;          // Blocks kept by db_pool_trim()
+    size_t high_watermark;         // Most blocks kept in the shared list
+    size_t thread_cache;           // Most blocks kept per thread
+    db_pool_node* idle;            // Shared list of idle blocks
+    size_t idle_count;             // Blocks in the shared list
+#if DB_ATOMIC_REFCOUNT
+    atomic_flag lock;              // Guards idle and idle_count
+#endif
+};
+
+#if DB_ATOMIC_REFCOUNT
+static _Atomic uint64_t db_pool_next_id = 1;
+#define DB_POOL_NEXT_ID() atomic_fetch_add(&db_pool_next_id, 1)
+#define DB_POOL_LOCK(pool) \
+    while (atomic_flag_test_and_set_explicit(&(pool)->lock, memory_order_acquire)) {}
+#define DB_POOL_UNLOCK(pool) atomic_flag_clear_explicit(&(pool)->lock, memory_order_release)
+#else
+static uint64_t db_pool_next_id = 1;
+#define DB_POOL_NEXT_ID() (db_pool_next_id++)
+#define DB_POOL_LOCK(pool) ((void)0)
+#define DB_POOL_UNLOCK(pool) ((void)0)
+#endif
+
+// Each thread caches blocks for the last pool it released into. Ids are
+// never reused, so a cache left behind by a released pool never matches again.
+static DB_THREAD_LOCAL uint64_t db_pool_cache_id;
+static DB_THREAD_LOCAL db_pool_node* db_pool_cache;
+static DB_THREAD_LOCAL size_t db_pool_cache_count;
+
+static void* db_pool_alloc(void* user, size_t size) {
+    struct db_pool_internal* pool = (struct db_pool_internal*)user;
+    if (size != pool->block_size) return DB_MALLOC(size);
+    
+    db_pool_node* node = NULL;
+    if (db_pool_cache_id == pool->id && db_pool_cache) {
+        node = db_pool_cache;
+        db_pool_cache = node->next;
+        db_pool_cache_count--;
+        return node;
+    }
+    
+    DB_POOL_LOCK(pool);
+    node = pool->idle;
+    if (node) {
+        pool->idle = node->next;
+        pool->idle_count--;
+    }
+    DB_POOL_UNLOCK(pool);
+    
+    return node ? (void*)node : DB_MALLOC(size);
+}
+
+static void db_pool_free(void* user, void* ptr, size_t size) {
+    struct db_pool_internal* pool = (struct db_pool_internal*)user;
+    if (size != pool->block_size) {
+        DB_FREE(ptr);
+        return;
+    }
+    
+    db_pool_node* node = (db_pool_node*)ptr;
+    if (pool->thread_cache) {
+        if (db_pool_cache_id != pool->id) {
+            db_pool_trim_thread();  // Blocks of another pool are plain DB_MALLOC blocks
+            db_pool_cache_id = pool->id;
+        }
+        if (db_pool_cache_count < pool->thread_cache) {
+            node->next = db_pool_cache;
+            db_pool_cache = node;
+            db_pool_cache_count++;
+            return;
+        }
+    }
+    
+    DB_POOL_LOCK(pool);
+    if (pool->idle_count < pool->high_watermark) {
+        node->next = pool->idle;
+        pool->idle = node;
+        pool->idle_count++;
+        node = NULL;
+    }
+    DB_POOL_UNLOCK(pool);
+    
+    if (node) DB_FREE(node);  // Above the high watermark
+}
+
+// Implementation of public functions
+
+db_buffer db_new(size_t capacity) {
+    return db_alloc(capacity);
+}
+
+db_buffer db_new_ex(size_t capacity, const db_allocator* allocator) {
+    return db_alloc_ex(capacity, allocator);
+}
+
+db_buffer db_new_with_data(const void* data, size_t size) {
+    return db_new_with_data_ex(data, size, NULL);
+}
+
+db_buffer db_new_with_data_ex(const void* data, size_t size, const db_allocator* allocator) {
+    DB_ASSERT((data || size == 0) && "db_new_with_data: data cannot be NULL when size > 0");
+    
+    db_buffer buf = db_alloc_ex(size, allocator);
+    // db_alloc now asserts on allocation failure
+    
+    if (size > 0) {
+        memcpy(buf, data, size);
+        db_meta(buf)->size = size;
+    }
+    
+    return buf;
+}
+
+db_buffer db_new_from_owned_data(void* data, size_t size, size_t capacity) {
+    DB_ASSERT((data || (size == 0 && capacity == 0)) && "db_new_from_owned_data: data cannot be NULL with non-zero size/capacity");
+    DB_ASSERT(capacity >= size && "db_new_from_owned_data: capacity must be >= size");
+    
+    // We can't use the negative offset trick here since we don't control the data allocation
+    // Instead, we'll copy the data to maintain design consistency
+    // (db_new_from_external() adopts memory that reserves room for the header)
+    db_buffer buf = db_alloc(capacity);
+    // db_alloc now asserts on allocation failure
+    
+    if (size > 0) {
+        memcpy(buf, data, size);
+        db_meta(buf)->size = size;
+    }
+    
+    return buf;
+}
+
+const db_allocator* db_small_pool_allocator(void) {
+    return &db_small_pool;
+}
+
+void db_small_pool_trim(void) {
+    for (int cls = 0; cls < DB_SMALL_POOL_CLASSES; cls++) {
+        while (db_small_free_list[cls]) {
+            db_small_node* node = db_small_free_list[cls];
+            db_small_free_list[cls] = node->next;
+            DB_FREE(node);
+        }
+        db_small_free_count[cls] = 0;
+    }
+}
+
+db_arena db_arena_new(size_t chunk_size) {
+    struct db_arena_internal* arena = (struct db_arena_internal*)DB_MALLOC(sizeof(struct db_arena_internal));
+    DB_ASSERT(arena && "db_arena_new: memory allocation failed");
+    
+    arena->chunk_size = chunk_size ? chunk_size : DB_ARENA_DEFAULT_CHUNK;
+    arena->allocator.alloc = db_arena_alloc;
+    arena->allocator.realloc = db_arena_realloc;
+    arena->allocator.free = db_arena_free;
+    arena->allocator.user = arena;
+    arena->first = db_arena_new_chunk(arena->chunk_size);
+    arena->current = arena->first;
+    arena->offset = 0;
+    arena->large = NULL;
+    arena->used = 0;
+    arena->last = NULL;
+    arena->last_size = 0;
+    
+    return arena;
+}
+
+const db_allocator* db_arena_allocator(db_arena arena) {
+    DB_ASSERT(arena && "db_arena_allocator: arena cannot be NULL");
+    return &arena->allocator;
+}
+
+void db_arena_reset(db_arena arena) {
+    DB_ASSERT(arena && "db_arena_reset: arena cannot be NULL");
+    
+    while (arena->large) {
+        db_arena_chunk* next = arena->large->next;
+        DB_FREE(arena->large);
+        arena->large = next;
+    }
+    
+    arena->current = arena->first;
+    arena->offset = 0;
+    arena->used = 0;
+    arena->last = NULL;
+}
+
+size_t db_arena_used(db_arena arena) {
+    DB_ASSERT(arena && "db_arena_used: arena cannot be NULL");
+    return arena->used;
+}
+
+void db_arena_release(db_arena* arena_ptr) {
+    DB_ASSERT(arena_ptr && "db_arena_release: arena_ptr cannot be NULL");
+    if (!*arena_ptr) return;
+    
+    db_arena arena = *arena_ptr;
+    *arena_ptr = NULL;
+    
+    db_arena_reset(arena);
+    while (arena->first) {
+        db_arena_chunk* next = arena->first->next;
+        DB_FREE(arena->first);
+        arena->first = next;
+    }
+    DB_FREE(arena);
+}
+
+db_pool db_pool_new(const db_pool_config* config) {
+    DB_ASSERT(config && "db_pool_new: config cannot be NULL");
+    DB_ASSERT(config->buffer_capacity > 0 && "db_pool_new: buffer_capacity must be > 0");
+    
+    struct db_pool_internal* pool = (struct db_pool_internal*)DB_MALLOC(sizeof(struct db_pool_internal));
+    DB_ASSERT(pool && "db_pool_new: memory allocation failed");
+    
+    pool->allocator.alloc = db_pool_alloc;
+    pool->allocator.realloc = NULL;  // Growth moves out of the pool block
+    pool->allocator.free = db_pool_free;
+    pool->allocator.user = pool;
+    pool->id = DB_POOL_NEXT_ID();
+    pool->capacity = config->buffer_capacity;
+    pool->block_size = sizeof(db_allocated) + sizeof(db_internal) + config->buffer_capacity;
+    DB_ASSERT(pool->block_size > config->buffer_capacity && "db_pool_new: buffer_capacity too large");
+    pool->low_watermark = config->low_watermark;
+    pool->high_watermark = config->high_watermark < config->low_watermark ? config->low_watermark
+                                                                          : config->high_watermark;
+    pool->thread_cache = config->thread_cache;
+    pool->idle = NULL;
+    pool->idle_count = 0;
+#if DB_ATOMIC_REFCOUNT
+    atomic_flag_clear(&pool->lock);
+#endif
+    
+    // Pre-fault the initial blocks so the first reads don't take page faults
+    for (size_t i = 0; i < pool->low_watermark; i++) {
+        db_pool_node* node = (db_pool_node*)DB_MALLOC(pool->block_size);
+        DB_ASSERT(node && "db_pool_new: memory allocation failed");
+        memset(node, 0, pool->block_size);
+        node->next = pool->idle;
+        pool->idle = node;
+        pool->idle_count++;
+    }
+    
+    return pool;
+}
+
+db_buffer db_pool_acquire(db_pool pool) {
+    DB_ASSERT(pool && "db_pool_acquire: pool cannot be NULL");
+    return db_alloc_ex(pool->capacity, &pool->allocator);
+}
+
+const db_allocator* db_pool_allocator(db_pool pool) {
+    DB_ASSERT(pool && "db_pool_allocator: pool cannot be NULL");
+    return &pool->allocator;
+}
+
+size_t db_pool_idle(db_pool pool) {
+    DB_ASSERT(pool && "db_pool_idle: pool cannot be NULL");
+    
+    DB_POOL_LOCK(pool);
+    size_t idle = pool->idle_count;
+    DB_POOL_UNLOCK(pool);
+    
+    if (db_pool_cache_id == pool->id) idle += db_pool_cache_count;
+    return idle;
+}
+
+void db_pool_trim(db_pool pool) {
+    DB_ASSERT(pool && "db_pool_trim: pool cannot be NULL");
+    
+    if (db_pool_cache_id == pool->id) db_pool_trim_thread();
+    
+    db_pool_node* excess = NULL;
+    DB_POOL_LOCK(pool);
+    while (pool->idle_count > pool->low_watermark) {
+        db_pool_node* node = pool->idle;
+        pool->idle = node->next;
+        pool->idle_count--;
+        node->next = excess;
+        excess = node;
+    }
+    DB_POOL_UNLOCK(pool);
+    
+    // Free outside the lock
+    while (excess) {
+        db_pool_node* next = excess->next;
+        DB_FREE(excess);
+        excess = next;
+    }
+}
+
+void db_pool_trim_thread(void) {
+    while (db_pool_cache) {
+        db_pool_node* next = db_pool_cache->next;
+        DB_FREE(db_pool_cache);
+        db_pool_cache = next;
+    }
+    db_pool_cache_count = 0;
+    db_pool_cache_id = 0;
+}
+
+void db_pool_release(db_pool* pool_ptr) {
+    DB_ASSERT(pool_ptr && "db_pool_release: pool_ptr cannot be NULL");
+    if (!*pool_ptr) return;
+    
+    db_pool pool = *pool_ptr;
+    *pool_ptr = NULL;
+    
+    if (db_pool_cache_id == pool->id) db_pool_trim_thread();
+    while (pool->idle) {
+        db_pool_node* next = pool->idle->next;
+        DB_FREE(pool->idle);
+        pool->idle = next;
+    }
+    DB_FREE(pool);
+}
+
+db_buffer db_new_from_external(void* block, size_t size, size_t capacity, db_free_fn free_fn, void* user) {
+    DB_ASSERT(block && "db_new_from_external: block cannot be NULL");
+    DB_ASSERT(capacity >= size && "db_new_from_external: capacity must be >= size");
+    DB_ASSERT(capacity <= DB_MAX_CAPACITY && "db_new_from_external: capacity exceeds DB_MAX_CAPACITY");
+    
+    // Metadata goes at the tail of the reserved header area, right before the data
+    db_buffer buf = (db_buffer)block + DB_EXTERNAL_HEADER_SIZE;
+    db_internal* meta = db_meta(buf);
+    db_external* ext = db_external_of(meta);
+    
+    ext->free_fn = free_fn;
+    ext->user = user;
+    ext->block = block;
+    
+    meta->refcount = DB_REFCOUNT_INIT(1);
+    meta->flags = DB_KIND_EXTERNAL;
+    DB_HASH_RESET(meta);
+    meta->size = size;
+    meta->capacity = capacity;
+    
+    return buf;
+}
+
+#if DB_LOCAL_REFCOUNT
+/**
+ * @brief Update the refcount of a buffer that hasn't been shared
+ * @private
+ * @note Relaxed load and store, so no locked instruction on the owner thread.
+ */
+static int db_local_refcount_add(db_refcount_t* refcount, int delta) {
+    int value = atomic_load_explicit(refcount, memory_order_relaxed) + delta;
+    atomic_store_explicit(refcount, value, memory_order_relaxed);
+    return value;
+}
+#endif
+
+db_buffer db_retain(db_buffer buf) {
+    DB_ASSERT(buf && "db_retain: buf cannot be NULL");
+    db_internal* meta = db_meta(buf);
+#if DB_LOCAL_REFCOUNT
+    if (!(meta->flags & DB_FLAG_SHARED)) {
+        db_local_refcount_add(&meta->refcount, 1);
+        return buf;
+    }
+#endif
+    DB_REFCOUNT_RETAIN(&meta->refcount);
+    return buf;
+}
+
+void db_release(db_buffer* buf_ptr) {
+    DB_ASSERT(buf_ptr && "db_release: buf_ptr cannot be NULL");
+    if (!*buf_ptr) return;
+    
+    db_buffer buf = *buf_ptr;
+    *buf_ptr = NULL;
+    
+    db_internal* meta = db_meta(buf);
+#if DB_LOCAL_REFCOUNT
+    if (!(meta->flags & DB_FLAG_SHARED)) {
+        if (db_local_refcount_add(&meta->refcount, -1) == 0) {
+            db_dealloc(buf);
+        }
+        return;
+    }
+#endif
+    if (DB_REFCOUNT_DECREMENT(&meta->refcount) == 0) {
+        // Reference count reached 0, free the buffer
+        db_dealloc(buf);
+    }
+}
+
+db_buffer db_share(db_buffer buf) {
+    DB_ASSERT(buf && "db_share: buf cannot be NULL");
+#if DB_LOCAL_REFCOUNT
+    db_internal* meta = db_meta(buf);
+    // Only write when needed: other threads may already be reading the flags
+    if (!(meta->flags & DB_FLAG_SHARED)) {
+        meta->flags |= DB_FLAG_SHARED;
+    }
+#endif
+    return buf;
+}
+
+bool db_is_shared(db_buffer buf) {
+    DB_ASSERT(buf && "db_is_shared: buf cannot be NULL");
+#if DB_LOCAL_REFCOUNT
+    return (db_meta(buf)->flags & DB_FLAG_SHARED) != 0;
+#else
+    (void)buf;
+    return DB_ATOMIC_REFCOUNT != 0;
+#endif
+}
+
+
+size_t db_size(db_buffer buf) {
+    DB_ASSERT(buf && "db_size: buf cannot be NULL");
+    return db_meta(buf)->size;
+}
+
+size_t db_capacity(db_buffer buf) {
+    DB_ASSERT(buf && "db_capacity: buf cannot be NULL");
+    return db_meta(buf)->capacity;
+}
+
+bool db_is_empty(db_buffer buf) {
+    DB_ASSERT(buf && "db_is_empty: buf cannot be NULL");
+    return db_meta(buf)->size == 0;
+}
+
+int db_refcount(db_buffer buf) {
+    DB_ASSERT(buf && "db_refcount: buf cannot be NULL");
+    return DB_REFCOUNT_LOAD(&db_meta(buf)->refcount);
+}
+
+db_buffer db_slice(db_buffer buf, size_t offset, size_t length) {
+    DB_ASSERT(buf && "db_slice: buf cannot be NULL");
+    
+    size_t buf_size = db_meta(buf)->size;
+    if (offset > buf_size || length > buf_size - offset) {
+        return NULL; // Invalid bounds
+    }
+    
+    // The whole buffer is already an immutable buffer - share it
+    if (offset == 0 && length == buf_size) {
+        return db_retain(buf);
+    }
+    
+    // Create an independent copy of the slice data
+    db_buffer slice = db_alloc_ex(length, db_buffer_allocator(buf));
+    // db_alloc now asserts on allocation failure
+    
+    // Copy the slice data directly from the source buffer
+    if (length > 0) {
+        memcpy(slice, buf + offset, length);
+        db_meta(slice)->size = length;
+        DB_STATS_ADD(bytes_copied, length);
+    }
+    
+    return slice;
+}
+
+db_buffer db_slice_from(db_buffer buf, size_t offset) {
+    DB_ASSERT(buf && "db_slice_from: buf cannot be NULL");
+    size_t buf_size = db_meta(buf)->size;
+    if (offset > buf_size) return NULL;
+    return db_slice(buf, offset, buf_size - offset);
+}
+
+db_buffer db_slice_to(db_buffer buf, size_t length) {
+    DB_ASSERT(buf && "db_slice_to: buf cannot be NULL");
+    if (length > db_meta(buf)->size) return NULL;
+    return db_slice(buf, 0, length);
+}
+
+
+
+db_buffer db_append(db_buffer buf, const void* data, size_t size) {
+    DB_ASSERT(buf && "db_append: buf cannot be NULL");
+    DB_ASSERT((data || size == 0) && "db_append: data cannot be NULL when size > 0");
+    
+    if (size == 0) {
+        return db_retain(buf);  // Return retained original if nothing to append
+    }
+    
+    size_t old_size = db_meta(buf)->size;
+    size_t new_size = old_size + size;
+    db_buffer result = db_new_ex(new_size, db_buffer_allocator(buf));
+    // db_new now asserts on allocation failure
+    
+    // Copy original buffer
+    if (old_size > 0) {
+        memcpy(result, buf, old_size);
+    }
+    // Append new data
+    memcpy(result + old_size, data, size);
+    DB_STATS_ADD(bytes_copied, new_size);
+    
+    // Set the final size
+    db_meta(result)->size = new_size;
+    
+    return result;
+}
+
+// Internal helper functions for builder (similar to ds_stringbuilder helpers)
+
+/**
+ * @brief Internal function to ensure buffer has exclusive access
+ * @param builder_data Pointer to builder's data pointer
+ * @return 0 on success, -1 on failure
+ */
+static int db_internal_ensure_unique(db_buffer* builder_data) {
+    if (!*builder_data) return -1;
+    
+    if (db_refcount(*builder_data) <= 1) {
+        DB_HASH_RESET(db_meta(*builder_data));  // The caller is about to write
+        return 0; // Already unique
+    }
+    
+    // Need to create our own copy
+    size_t current_size = db_size(*builder_data);
+    db_buffer new_buf = db_new_with_data_ex(*builder_data, current_size, db_buffer_allocator(*builder_data));
+    // db_new_with_data now asserts on allocation failure
+    DB_STATS_ADD(cow_copies, 1);
+    DB_STATS_ADD(bytes_copied, current_size);
+    
+    db_release(builder_data);
+    *builder_data = new_buf;
+    return 0;
+}
+
+/**
+ * @brief Internal function to pick the next capacity under a growth policy
+ * @param capacity Current capacity in bytes
+ * @param required_capacity Required capacity in bytes
+ * @param header_size Bytes in front of the data in the same block
+ * @param policy Growth policy (NULL for the default)
+ * @return New capacity, at least required_capacity
+ */
+static size_t db_internal_grow_capacity(size_t capacity, size_t required_capacity, size_t header_size,
+                                        const db_growth_policy* policy) {
+    size_t initial = (policy && policy->initial_capacity) ? policy->initial_capacity : 16;
+    double factor = (policy && policy->growth_factor > 1.0) ? policy->growth_factor : 2.0;
+    size_t max_step = policy ? policy->max_growth_step : 0;
+    
+    size_t new_capacity = capacity;
+    if (new_capacity == 0 || (policy && new_capacity < policy->initial_capacity)) {
+        new_capacity = initial;
+    }
+    
+    while (new_capacity < required_capacity) {
+        double grown = (double)new_capacity * factor;
+        size_t next = grown >= (double)SIZE_MAX ? SIZE_MAX : (size_t)grown;
+        if (next <= new_capacity) next = new_capacity + 1;
+        
+        if (max_step && next - new_capacity > max_step) {
+            // Capped steps: jump straight to the first step boundary that fits
+            size_t missing = required_capacity - new_capacity;
+            size_t steps = missing / max_step + (missing % max_step != 0);
+            new_capacity = steps > (SIZE_MAX - new_capacity) / max_step ? required_capacity
+                                                                        : new_capacity + steps * max_step;
+            break;
+        }
+        new_capacity = next;
+    }
+    
+    if (policy && policy->round_to_page) {
+#ifdef _WIN32
+        size_t page = 4096;
+#else
+        size_t page = (size_t)sysconf(_SC_PAGESIZE);
+#endif
+        size_t block = header_size + new_capacity;
+        if (block <= SIZE_MAX - (page - 1)) {
+            new_capacity = (block + page - 1) / page * page - header_size;
+        }
+    }
+    
+    if (new_capacity > DB_MAX_CAPACITY) {
+        new_capacity = DB_MAX_CAPACITY;  // Callers already checked required_capacity fits
+    }
+    return new_capacity;
+}
+
+/**
+ * @brief Internal function to ensure buffer has enough capacity
+ * @param builder_data Pointer to builder's data pointer  
+ * @param builder_capacity Pointer to builder's capacity
+ * @param required_capacity Required capacity in bytes
+ * @param policy Growth policy (NULL for the default doubling)
+ * @return 0 on success, -1 on failure
+ */
+static int db_internal_ensure_capacity(db_buffer* builder_data, size_t* builder_capacity, size_t required_capacity,
+                                       const db_growth_policy* policy) {
+    if (*builder_capacity >= required_capacity) {
+        return 0; // Already have enough capacity
+    }
+    if (required_capacity > DB_MAX_CAPACITY) {
+        return -1; // Can't be represented in the header
+    }
+    
+    db_internal* meta = db_meta(*builder_data);
+    size_t header_size = sizeof(db_internal);
+    if ((meta->flags & DB_KIND_MASK) == DB_KIND_ALLOCATOR) {
+        header_size += sizeof(db_allocated);
+    }
+    size_t new_capacity = db_internal_grow_capacity(*builder_capacity, required_capacity, header_size, policy);
+    
+    if ((meta->flags & DB_KIND_MASK) == DB_KIND_ALLOCATOR) {
+        db_allocated* record = db_allocated_of(meta);
+        const db_allocator* allocator = record->allocator;
+        size_t header_size = sizeof(db_allocated) + sizeof(db_internal);
+        void* block;
+        
+        if (allocator->realloc) {
+            block = allocator->realloc(allocator->user, record, header_size + meta->capacity,
+                                       header_size + new_capacity);
+            DB_ASSERT(block && "db_internal_ensure_capacity: memory reallocation failed");
+        } else {
+            block = allocator->alloc(allocator->user, header_size + new_capacity);
+            DB_ASSERT(block && "db_internal_ensure_capacity: memory allocation failed");
+            memcpy(block, record, header_size + meta->size);
+            DB_STATS_ADD(bytes_copied, meta->size);
+            allocator->free(allocator->user, record, header_size + meta->capacity);
+        }
+        
+        db_internal* new_meta = (db_internal*)((char*)block + sizeof(db_allocated));
+        DB_STATS_ADD(reallocs, 1);
+        DB_STATS_LIVE(new_meta->capacity, new_capacity);
+        new_meta->capacity = new_capacity;
+        *builder_data = (db_buffer)((char*)new_meta + sizeof(db_internal));
+        *builder_capacity = new_capacity;
+        return 0;
+    }
+    
+    if ((meta->flags & DB_KIND_MASK) != DB_KIND_HEAP) {
+        // Storage we don't own can't be realloc'd - move into a heap block
+        db_buffer new_buf = db_alloc(new_capacity);
+        DB_ASSERT(new_buf && "db_internal_ensure_capacity: memory allocation failed");
+        memcpy(new_buf, *builder_data, meta->size);
+        db_meta(new_buf)->size = meta->size;
+        DB_STATS_ADD(bytes_copied, meta->size);
+        
+        db_release(builder_data);
+        *builder_data = new_buf;
+        *builder_capacity = new_capacity;
+        return 0;
+    }
+    
+    // Use realloc for efficient buffer growth
+    // Calculate new block size (metadata + data)
+    size_t new_block_size = sizeof(db_internal) + new_capacity;
+    
+    // Realloc the entire block (metadata + data)
+    db_internal* new_meta = (db_internal*)DB_REALLOC(meta, new_block_size);
+    DB_ASSERT(new_meta && "db_internal_ensure_capacity: memory reallocation failed");
+    
+    // Update capacity (size remains the same)
+    DB_STATS_ADD(reallocs, 1);
+    DB_STATS_LIVE(new_meta->capacity, new_capacity);
+    new_meta->capacity = new_capacity;
+    
+    // Update the buffer pointer to point to data portion
+    *builder_data = (db_buffer)((char*)new_meta + sizeof(db_internal));
+    *builder_capacity = new_capacity;
+    return 0;
+}
+
+/**
+ * @brief Internal function to give a buffer's spare capacity back to its allocator
+ * @param builder_data Pointer to builder's data pointer
+ * @note Only heap and allocator buffers are resized; other kinds are left alone.
+ */
+static void db_internal_shrink_to_fit(db_buffer* builder_data) {
+    db_internal* meta = db_meta(*builder_data);
+    if (meta->size == meta->capacity || db_refcount(*builder_data) > 1) {
+        return;
+    }
+    
+    uint32_t kind = meta->flags & DB_KIND_MASK;
+    if (kind == DB_KIND_HEAP) {
+        db_internal* new_meta = (db_internal*)DB_REALLOC(meta, sizeof(db_internal) + meta->size);
+        if (!new_meta) return;  // Keeping the slack is harmless
+        DB_STATS_ADD(reallocs, 1);
+        DB_STATS_LIVE(new_meta->capacity, new_meta->size);
+        new_meta->capacity = new_meta->size;
+        *builder_data = (db_buffer)((char*)new_meta + sizeof(db_internal));
+    } else if (kind == DB_KIND_ALLOCATOR) {
+        db_allocated* record = db_allocated_of(meta);
+        const db_allocator* allocator = record->allocator;
+        if (!allocator->realloc) return;
+        
+        size_t header_size = sizeof(db_allocated) + sizeof(db_internal);
+        void* block = allocator->realloc(allocator->user, record, header_size + meta->capacity,
+                                         header_size + meta->size);
+        if (!block) return;
+        db_internal* new_meta = (db_internal*)((char*)block + sizeof(db_allocated));
+        DB_STATS_ADD(reallocs, 1);
+        DB_STATS_LIVE(new_meta->capacity, new_meta->size);
+        new_meta->capacity = new_meta->size;
+        *builder_data = (db_buffer)((char*)new_meta + sizeof(db_internal));
+    }
+}
+
+/**
+ * @brief Internal function to make room for size bytes at the end of the buffer
+ * @param builder_data Pointer to builder's data pointer
+ * @param builder_capacity Pointer to builder's capacity
+ * @param size Number of bytes the caller is about to write
+ * @param policy Growth policy (NULL for the default)
+ * @return Pointer to the first writable byte past the current size, or NULL on failure
+ * @note The size is left unchanged; the caller bumps it once the bytes are written.
+ */
+static char* db_internal_reserve(db_buffer* builder_data, size_t* builder_capacity, size_t size,
+                                 const db_growth_policy* policy) {
+    if (db_internal_ensure_unique(builder_data) != 0) {
+        return NULL;
+    }
+    // A copy-on-write copy only has room for its current contents
+    *builder_capacity = db_meta(*builder_data)->capacity;
+    
+    size_t current_size = db_size(*builder_data);
+    if (size > SIZE_MAX - current_size) {
+        return NULL; // Size overflow
+    }
+    
+    if (db_internal_ensure_capacity(builder_data, builder_capacity, current_size + size, policy) != 0) {
+        return NULL;
+    }
+    
+    return *builder_data + current_size;
+}
+
+/**
+ * @brief Internal function to append data to builder buffer (mutable)
+ * @param builder_data Pointer to builder's data pointer
+ * @param builder_capacity Pointer to builder's capacity
+ * @param data Data to append
+ * @param size Size of data to append
+ * @param policy Growth policy (NULL for the default)
+ * @return 0 on success, -1 on failure
+ */
+static int db_internal_append(db_buffer* builder_data, size_t* builder_capacity, const void* data, size_t size,
+                              const db_growth_policy* policy) {
+    if (size == 0) return 0;
+    
+    char* tail = db_internal_reserve(builder_data, builder_capacity, size, policy);
+    if (!tail) {
+        return -1;
+    }
+    
+    // Append the data
+    memcpy(tail, data, size);
+    db_meta(*builder_data)->size += size;
+    
+    return 0;
+}
+
+int db_append_inplace(db_buffer* buf_ptr, const void* data, size_t size) {
+    DB_ASSERT(buf_ptr && *buf_ptr && "db_append_inplace: buf_ptr and *buf_ptr cannot be NULL");
+    DB_ASSERT((data || size == 0) && "db_append_inplace: data cannot be NULL when size > 0");
+    
+    size_t capacity = db_meta(*buf_ptr)->capacity;
+    return db_internal_append(buf_ptr, &capacity, data, size, NULL);
+}
+
+db_buffer db_concat(db_buffer buf1, db_buffer buf2) {
+    DB_ASSERT(buf1 && "db_concat: buf1 cannot be NULL");
+    DB_ASSERT(buf2 && "db_concat: buf2 cannot be NULL");
+    
+    size_t size1 = db_meta(buf1)->size;
+    size_t size2 = db_meta(buf2)->size;
+    size_t total_size = size1 + size2;
+    
+    const db_allocator* allocator = db_buffer_allocator(buf1);
+    if (total_size == 0) return db_new_ex(0, allocator);
+    
+    db_buffer result = db_new_ex(total_size, allocator);
+    // db_new now asserts on allocation failure
+    
+    if (size1 > 0) {
+        memcpy(result, buf1, size1);
+    }
+    
+    if (size2 > 0) {
+        memcpy(result + size1, buf2, size2);
+    }
+    DB_STATS_ADD(bytes_copied, total_size);
+    
+    db_meta(result)->size = total_size;
+    return result;
+}
+
+db_buffer db_concat_many(db_buffer* buffers, size_t count) {
+    if (!buffers || count == 0) return db_new(0);
+    
+    // Calculate total size
+    size_t total_size = 0;
+    db_buffer first = NULL;
+    for (size_t i = 0; i < count; i++) {
+        if (buffers[i]) {
+            if (!first) first = buffers[i];
+            total_size += db_meta(buffers[i])->size;
+        }
+    }
+    
+    // Allocate from the first buffer's allocator
+    db_buffer result = db_new_ex(total_size, first ? db_buffer_allocator(first) : NULL);
+    // db_new now asserts on allocation failure
+    
+    size_t offset = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (buffers[i]) {
+            size_t size = db_meta(buffers[i])->size;
+            if (size > 0) {
+                memcpy(result + offset, buffers[i], size);
+                offset += size;
+            }
+        }
+    }
+    DB_STATS_ADD(bytes_copied, total_size);
+    
+    db_meta(result)->size = total_size;
+    return result;
+}
+
+bool db_equals(db_buffer buf1, db_buffer buf2) {
+    DB_ASSERT(buf1 && "db_equals: buf1 cannot be NULL");
+    DB_ASSERT(buf2 && "db_equals: buf2 cannot be NULL");
+    
+    if (buf1 == buf2) return true;
+    
+    size_t size1 = db_meta(buf1)->size;
+    size_t size2 = db_meta(buf2)->size;
+    if (size1 != size2) return false;
+    
+#if DB_CACHE_HASH
+    // Different cached hashes settle it without touching the bytes
+    uint64_t hash1 = DB_HASH_LOAD(&db_meta(buf1)->hash);
+    uint64_t hash2 = DB_HASH_LOAD(&db_meta(buf2)->hash);
+    if (hash1 && hash2 && hash1 != hash2) return false;
+#endif
+    
+    return memcmp(buf1, buf2, size1) == 0;
+}
+
+int db_compare(db_buffer buf1, db_buffer buf2) {
+    DB_ASSERT(buf1 && "db_compare: buf1 cannot be NULL");
+    DB_ASSERT(buf2 && "db_compare: buf2 cannot be NULL");
+    
+    if (buf1 == buf2) return 0;
+    
+    size_t size1 = db_meta(buf1)->size;
+    size_t size2 = db_meta(buf2)->size;
+    size_t min_size = size1 < size2 ? size1 : size2;
+    
+    int result = memcmp(buf1, buf2, min_size);
+    
+    if (result != 0) return result;
+    
+    // Contents are equal up to min_size, compare sizes
+    if (size1 < size2) return -1;
+    if (size1 > size2) return 1;
+    return 0;
+}
+
+// Size of the overflow chunk used by db_builder_readv()
+#ifndef DB_READV_CHUNK_SIZE
+#define DB_READV_CHUNK_SIZE 65536
+#endif
+
+// I/O operations - basic implementation
+#include <errno.h>
+#ifdef _WIN32
+#include <io.h>
+#define db_read read
+#define db_write write
+#else
+#include <unistd.h>
+#include <limits.h>
+#define db_read read  
+#define db_write write
+#ifndef IOV_MAX
+#define IOV_MAX 1024
+#endif
+#endif
+
+ssize_t db_read_fd(db_buffer* buf_ptr, int fd, size_t max_bytes) {
+    DB_ASSERT(buf_ptr && *buf_ptr && "db_read_fd: buf_ptr and *buf_ptr cannot be NULL");
+    DB_ASSERT(fd >= 0 && "db_read_fd: invalid file descriptor");
+    
+    size_t read_size = max_bytes == 0 ? 4096 : max_bytes;
+    
+    // Make room at the tail (copy-on-write if shared, geometric growth otherwise)
+    if (db_internal_ensure_unique(buf_ptr) != 0) return -1;
+    size_t capacity = db_meta(*buf_ptr)->capacity;
+    
+    size_t current_size = db_meta(*buf_ptr)->size;
+    if (db_internal_ensure_capacity(buf_ptr, &capacity, current_size + read_size, NULL) != 0) {
+        return -1;
+    }
+    
+    // Let read() write straight into the buffer
+    ssize_t bytes_read = db_read(fd, *buf_ptr + current_size, read_size);
+    if (bytes_read > 0) {
+        db_meta(*buf_ptr)->size = current_size + (size_t)bytes_read;
+    }
+    
+    return bytes_read;
+}
+
+ssize_t db_write_fd(db_buffer buf, int fd) {
+    DB_ASSERT(buf && "db_write_fd: buf cannot be NULL");
+    DB_ASSERT(fd >= 0 && "db_write_fd: invalid file descriptor");
+    size_t size = db_meta(buf)->size;
+    if (size == 0) return 0;
+    
+    return db_write(fd, buf, size);
+}
+
+/**
+ * @brief Vectored write loop shared by db_write_fdv() and db_chain_write_fdv()
+ * @private
+ * @param get Returns the segment at an index
+ */
+static ssize_t db_internal_writev(int fd, db_buffer (*get)(const void*, size_t), const void* ctx,
+                                  size_t count, db_write_cursor* cursor) {
+    ssize_t total = 0;
+    
+    while (cursor->index < count) {
+#ifdef _WIN32
+        // No writev - one write per buffer
+        db_buffer seg = get(ctx, cursor->index);
+        size_t requested = db_meta(seg)->size - cursor->offset;
+        ssize_t written = requested ? db_write(fd, seg + cursor->offset, (unsigned int)requested) : 0;
+#else
+        struct iovec iov[64];
+        size_t max_iov = sizeof(iov) / sizeof(iov[0]) < IOV_MAX ? sizeof(iov) / sizeof(iov[0]) : IOV_MAX;
+        int iovcnt = 0;
+        size_t offset = cursor->offset;
+        size_t requested = 0;
+        
+        for (size_t i = cursor->index; i < count && (size_t)iovcnt < max_iov; i++) {
+            db_buffer seg = get(ctx, i);
+            size_t size = db_meta(seg)->size;
+            if (size > offset) {
+                iov[iovcnt].iov_base = seg + offset;
+                iov[iovcnt].iov_len = size - offset;
+                requested += size - offset;
+                iovcnt++;
+            }
+            offset = 0;
+        }
+        
+        ssize_t written = iovcnt ? writev(fd, iov, iovcnt) : 0;
+#endif
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            return total > 0 ? total : -1;
+        }
+        total += written;
+        
+        // Advance the cursor past everything that was fully written
+        size_t left = (size_t)written;
+        while (cursor->index < count) {
+            size_t remaining = db_meta(get(ctx, cursor->index))->size - cursor->offset;
+            if (left < remaining) {
+                cursor->offset += left;
+                break;
+            }
+            left -= remaining;
+            cursor->index++;
+            cursor->offset = 0;
+        }
+        
+        if (written == 0 && requested > 0) break;  // Nothing accepted
+    }
+    
+    return total;
+}
+
+static db_buffer db_array_segment(const void* ctx, size_t index) {
+    return ((const db_buffer*)ctx)[index];
+}
+
+ssize_t db_write_fdv(int fd, const db_buffer* buffers, size_t count, db_write_cursor* cursor) {
+    DB_ASSERT((buffers || count == 0) && "db_write_fdv: buffers cannot be NULL");
+    DB_ASSERT(cursor && "db_write_fdv: cursor cannot be NULL");
+    DB_ASSERT(fd >= 0 && "db_write_fdv: invalid file descriptor");
+    
+    return db_internal_writev(fd, db_array_segment, buffers, count, cursor);
+}
+
+db_buffer db_read_file(const char* filename) {
+    if (!filename) return NULL; // Allow NULL filename as runtime error
+    
+    FILE* file = fopen(filename, "rb");
+    if (!file) return NULL;
+    
+    // The size is only a capacity hint: ftell is a long, which can't hold
+    // sizes past 2 GB on LLP64 platforms, so read until EOF regardless
+    size_t hint = 4096;
+    if (fseek(file, 0, SEEK_END) == 0) {
+        long file_size = ftell(file);
+        if (file_size > 0 && (unsigned long)file_size <= DB_MAX_CAPACITY) hint = (size_t)file_size;
+    }
+    fseek(file, 0, SEEK_SET);
+    
+    db_buffer buf = db_new(hint);
+    if (!buf) {
+        fclose(file);
+        return NULL;
+    }
+    
+    size_t capacity = db_meta(buf)->capacity;
+    for (;;) {
+        size_t room = capacity - db_meta(buf)->size;
+        if (room == 0) {
+            // Probe for EOF before growing, so an exact hint costs no realloc
+            int c = fgetc(file);
+            if (c == EOF) break;
+            if (db_meta(buf)->size == DB_MAX_CAPACITY) break;  // File larger than DB_MAX_CAPACITY
+            
+            room = capacity;  // Hint was short - keep doubling
+            if (room > DB_MAX_CAPACITY - db_meta(buf)->size) room = DB_MAX_CAPACITY - db_meta(buf)->size;
+            char* tail = db_internal_reserve(&buf, &capacity, room, NULL);
+            if (!tail) break;
+            tail[0] = (char)c;
+            db_meta(buf)->size += 1;
+            room -= 1;
+            if (room == 0) continue;
+        }
+        
+        char* tail = buf + db_meta(buf)->size;
+        size_t bytes_read = fread(tail, 1, room, file);
+        db_meta(buf)->size += bytes_read;
+        if (bytes_read < room) break;
+    }
+    
+    bool failed = ferror(file) != 0 || !feof(file);
+    fclose(file);
+    if (failed) {
+        db_release(&buf);
+        return NULL;
+    }
+    db_internal_shrink_to_fit(&buf);  // Drop slack from doubling or a stale size hint
+    return buf;
+}
+
+#if DB_HAVE_MMAP
+static int db_map_advice_flag(db_map_advice advice) {
+    switch (advice) {
+        case DB_MAP_SEQUENTIAL: return MADV_SEQUENTIAL;
+        case DB_MAP_RANDOM: return MADV_RANDOM;
+        case DB_MAP_WILLNEED: return MADV_WILLNEED;
+        default: return MADV_NORMAL;
+    }
+}
+#endif
+
+db_buffer db_map_file(const char* filename, db_map_advice advice) {
+    if (!filename) return NULL; // Allow NULL filename as runtime error
+    
+#if DB_HAVE_MMAP
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) return NULL;
+    
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        close(fd);
+        return db_read_file(filename);  // Not a regular file - read it instead
+    }
+    if (st.st_size == 0) {
+        close(fd);
+        return db_new(0);  // Zero-length mappings aren't allowed
+    }
+    if ((uint64_t)st.st_size > DB_MAX_CAPACITY) {
+        close(fd);
+        return NULL;  // Too large for the header (DB_COMPACT_HEADER)
+    }
+    
+    size_t file_size = (size_t)st.st_size;
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t length = page + ((file_size + page - 1) & ~(page - 1));
+    
+    // Reserve header page + file pages, then map the file over the tail
+    char* base = (char*)mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == (char*)MAP_FAILED) {
+        close(fd);
+        return db_read_file(filename);
+    }
+    
+    void* view = mmap(base + page, file_size, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0);
+    close(fd);  // The mapping keeps the file referenced
+    if (view == MAP_FAILED) {
+        munmap(base, length);
+        return db_read_file(filename);
+    }
+    
+    db_buffer buf = (db_buffer)(base + page);
+    db_internal* meta = db_meta(buf);
+    db_mapping* mapping = db_mapping_of(meta);
+    mapping->base = base;
+    mapping->length = length;
+    
+    meta->refcount = DB_REFCOUNT_INIT(1);
+    meta->flags = DB_KIND_MAPPED;
+    DB_HASH_RESET(meta);
+    meta->size = file_size;
+    meta->capacity = file_size;
+    
+    if (advice != DB_MAP_NORMAL) {
+        madvise(buf, file_size, db_map_advice_flag(advice));
+    }
+    return buf;
+#else
+    (void)advice;
+    return db_read_file(filename);
+#endif
+}
+
+bool db_map_advise(db_buffer buf, size_t offset, size_t length, db_map_advice advice) {
+    DB_ASSERT(buf && "db_map_advise: buf cannot be NULL");
+    
+#if DB_HAVE_MMAP
+    db_internal* meta = db_meta(buf);
+    if ((meta->flags & DB_KIND_MASK) != DB_KIND_MAPPED) return false;
+    if (offset > meta->size || length > meta->size - offset) return false;
+    if (length == 0) return true;
+    
+    // madvise needs a page-aligned start; the data itself starts on a page
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t start = offset & ~(page - 1);
+    return madvise(buf + start, length + (offset - start), db_map_advice_flag(advice)) == 0;
+#else
+    (void)buf;
+    (void)offset;
+    (void)length;
+    (void)advice;
+    return false;
+#endif
+}
+
+bool db_write_file(db_buffer buf, const char* filename) {
+    DB_ASSERT(buf && "db_write_file: buf cannot be NULL");
+    if (!filename) return false;
+    
+    FILE* file = fopen(filename, "wb");
+    if (!file) return false;
+    
+    bool success = true;
+    size_t size = db_meta(buf)->size;
+    if (size > 0) {
+        size_t written = fwrite(buf, 1, size, file);
+        success = (written == size);
+    }
+    
+    fclose(file);
+    return success;
+}
+
+// Chunked file streaming
+#include <fcntl.h>
+#include <limits.h>
+#ifdef O_BINARY
+#define DB_O_BINARY O_BINARY
+#else
+#define DB_O_BINARY 0
+#endif
+
+#define DB_FILE_STREAM_DEFAULT_CHUNK (1024 * 1024)
+#define DB_FILE_STREAM_DEFAULT_READAHEAD 4
+
+struct db_file_stream_internal {
+    int fd;
+    bool owns_fd;              // Opened by db_file_stream_open()
+    bool eof;
+    int error;
+    size_t chunk_size;
+    size_t readahead;          // Bytes hinted ahead of the read position
+    const uint8_t* delimiter;
+    size_t delimiter_size;
+    bool drop_behind;
+    db_pool pool;
+    db_buffer carry;           // Partial record left over from the last chunk
+    uint64_t start;            // File offset the stream started at (for fadvise)
+    uint64_t read_offset;      // Bytes read from the file so far
+    uint64_t hinted;           // End of the range already hinted with WILLNEED
+    uint64_t dropped;          // End of the range already dropped with DONTNEED
+};
+
+/**
+ * @brief Find the last occurrence of a needle
+ * @private
+ * @return Offset of the match, or DB_NOT_FOUND
+ */
+static size_t db_internal_find_last(const uint8_t* data, size_t size, const uint8_t* needle, size_t needle_size) {
+    if (needle_size == 0 || needle_size > size) return DB_NOT_FOUND;
+    for (size_t i = size - needle_size + 1; i-- > 0;) {
+        if (data[i] == needle[0] && memcmp(data + i + 1, needle + 1, needle_size - 1) == 0) {
+            return i;
+        }
+    }
+    return DB_NOT_FOUND;
+}
+
+/**
+ * @brief Issue page cache hints for the stream's read position
+ * @private
+ */
+static void db_file_stream_advise(struct db_file_stream_internal* stream, uint64_t delivered) {
+#if defined(POSIX_FADV_WILLNEED)
+    uint64_t window_end = stream->read_offset + stream->readahead;
+    if (window_end > stream->hinted) {
+        uint64_t start = stream->hinted > stream->read_offset ? stream->hinted : stream->read_offset;
+        posix_fadvise(stream->fd, (off_t)(stream->start + start), (off_t)(window_end - start), POSIX_FADV_WILLNEED);
+        stream->hinted = window_end;
+    }
+    if (stream->drop_behind && delivered > stream->dropped) {
+        // Drop only the pages read since the last call; their bytes now live in
+        // the returned chunk or the carry. The kernel skips a partial last page,
+        // so the watermark stops at a page boundary and it is retried next time.
+        posix_fadvise(stream->fd, (off_t)(stream->start + stream->dropped), (off_t)(delivered - stream->dropped),
+                      POSIX_FADV_DONTNEED);
+        uint64_t page = (uint64_t)sysconf(_SC_PAGESIZE);
+        uint64_t end = (stream->start + delivered) / page * page;
+        if (end > stream->start + stream->dropped) stream->dropped = end - stream->start;
+    }
+#else
+    (void)stream;
+    (void)delivered;
+#endif
+}
+
+db_file_stream db_file_stream_from_fd(int fd, const db_file_stream_options* options) {
+    struct db_file_stream_internal* stream =
+        (struct db_file_stream_internal*)DB_MALLOC(sizeof(struct db_file_stream_internal));
+    DB_ASSERT(stream && "db_file_stream_from_fd: memory allocation failed");
+    DB_ASSERT((!options || !options->delimiter_size || options->delimiter) &&
+              "db_file_stream_from_fd: delimiter cannot be NULL when delimiter_size > 0");
+    
+    stream->fd = fd;
+    stream->owns_fd = false;
+    stream->eof = false;
+    stream->error = 0;
+    stream->chunk_size = options && options->chunk_size ? options->chunk_size : DB_FILE_STREAM_DEFAULT_CHUNK;
+    size_t readahead = options && options->readahead_chunks ? options->readahead_chunks
+                                                            : DB_FILE_STREAM_DEFAULT_READAHEAD;
+    stream->readahead = readahead > SIZE_MAX / stream->chunk_size ? SIZE_MAX : readahead * stream->chunk_size;
+    stream->delimiter = options ? (const uint8_t*)options->delimiter : NULL;
+    stream->delimiter_size = stream->delimiter ? options->delimiter_size : 0;
+    stream->drop_behind = options && options->drop_behind;
+    stream->pool = options ? options->pool : NULL;
+    stream->carry = NULL;
+    stream->read_offset = 0;
+    stream->hinted = 0;
+    stream->dropped = 0;
+    
+    // Hints take absolute offsets; pipes and sockets can't seek and get none
+    off_t start = lseek(fd, 0, SEEK_CUR);
+    stream->start = start > 0 ? (uint64_t)start : 0;
+#if defined(POSIX_FADV_SEQUENTIAL)
+    posix_fadvise(fd, (off_t)stream->start, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+    return stream;
+}
+
+db_file_stream db_file_stream_open(const char* filename, const db_file_stream_options* options) {
+    DB_ASSERT(filename && "db_file_stream_open: filename cannot be NULL");
+    
+    int fd = open(filename, O_RDONLY | DB_O_BINARY);
+    if (fd < 0) return NULL;
+    
+    db_file_stream stream = db_file_stream_from_fd(fd, options);
+    stream->owns_fd = true;
+    return stream;
+}
+
+db_buffer db_file_stream_next(db_file_stream stream) {
+    DB_ASSERT(stream && "db_file_stream_next: stream cannot be NULL");
+    if (stream->eof && !stream->carry) return NULL;
+    
+    db_buffer buf = stream->pool ? db_pool_acquire(stream->pool) : db_new(stream->chunk_size);
+    size_t capacity = db_meta(buf)->capacity;
+    if (stream->carry) {
+        db_internal_append(&buf, &capacity, stream->carry, db_meta(stream->carry)->size, NULL);
+        db_release(&stream->carry);
+    }
+    
+    size_t target = stream->chunk_size;
+    size_t scanned = 0;  // Prefix known to hold no delimiter
+    for (;;) {
+        db_file_stream_advise(stream, 0);
+        while (!stream->eof && db_meta(buf)->size < target) {
+            size_t want = target - db_meta(buf)->size;
+            if (want > INT_MAX) want = INT_MAX;  // Keep the result representable on every platform
+            char* tail = db_internal_reserve(&buf, &capacity, want, NULL);
+            DB_ASSERT(tail && "db_file_stream_next: chunk size overflow");
+            
+            ssize_t n = db_read(stream->fd, tail, (unsigned int)want);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                stream->error = errno;
+                stream->eof = true;
+            } else if (n == 0) {
+                stream->eof = true;
+            } else {
+                db_meta(buf)->size += (size_t)n;
+                stream->read_offset += (uint64_t)n;
+            }
+        }
+        if (!stream->delimiter || stream->eof) break;
+        
+        // End the chunk after the last delimiter and carry the rest
+        size_t size = db_meta(buf)->size;
+        size_t from = scanned >= stream->delimiter_size ? scanned - (stream->delimiter_size - 1) : 0;
+        size_t match = db_internal_find_last((const uint8_t*)buf + from, size - from,
+                                             stream->delimiter, stream->delimiter_size);
+        if (match != DB_NOT_FOUND) {
+            size_t end = from + match + stream->delimiter_size;
+            if (end < size) {
+                stream->carry = db_new_with_data(buf + end, size - end);
+                db_meta(buf)->size = end;
+            }
+            break;
+        }
+        
+        // One record is longer than the chunk; keep reading until it ends
+        scanned = size;
+        target = size > SIZE_MAX - stream->chunk_size ? SIZE_MAX : size + stream->chunk_size;
+    }
+    
+    if (stream->drop_behind) {
+        db_file_stream_advise(stream, stream->read_offset);
+    }
+    if (db_meta(buf)->size == 0) {
+        db_release(&buf);
+    }
+    return buf;
+}
+
+uint64_t db_file_stream_position(db_file_stream stream) {
+    DB_ASSERT(stream && "db_file_stream_position: stream cannot be NULL");
+    return stream->read_offset - (stream->carry ? db_meta(stream->carry)->size : 0);
+}
+
+int db_file_stream_error(db_file_stream stream) {
+    DB_ASSERT(stream && "db_file_stream_error: stream cannot be NULL");
+    return stream->error;
+}
+
+void db_file_stream_release(db_file_stream* stream_ptr) {
+    DB_ASSERT(stream_ptr && "db_file_stream_release: stream_ptr cannot be NULL");
+    if (!*stream_ptr) return;
+    
+    db_file_stream stream = *stream_ptr;
+    *stream_ptr = NULL;
+    
+    db_release(&stream->carry);
+    if (stream->owns_fd) close(stream->fd);
+    DB_FREE(stream);
+}
+
+// io_uring backend
+#if DB_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#define DB_URING_NONE UINT32_MAX  // No slot / not a registered buffer
+#define DB_URING_CANCEL UINT64_MAX  // user_data of the cancel requests issued by db_uring_release()
+
+// In-flight request, indexed by the SQE user_data
+typedef struct db_uring_slot {
+    db_buffer buf;        // Buffer reference held for the request
+    void* user;           // Caller's pointer
+    uint32_t next_free;   // Free list link
+    uint8_t op;           // db_uring_op
+} db_uring_slot;
+
+struct db_uring_internal {
+    int fd;
+    
+    // Submission ring (shared with the kernel)
+    unsigned* sq_head;
+    unsigned* sq_tail;
+    unsigned* sq_array;
+    unsigned sq_mask;
+    unsigned sq_entries;
+    unsigned sq_queued;          // Filled SQEs not yet passed to io_uring_enter
+    struct io_uring_sqe* sqes;
+    
+    // Completion ring (shared with the kernel)
+    unsigned* cq_head;
+    unsigned* cq_tail;
+    unsigned cq_mask;
+    struct io_uring_cqe* cqes;
+    
+    void* sq_map;
+    size_t sq_map_size;
+    void* cq_map;                // Same as sq_map with IORING_FEAT_SINGLE_MMAP
+    size_t cq_map_size;
+    size_t sqes_size;
+    
+    // Requests not yet collected by db_uring_complete()
+    db_uring_slot* slots;
+    unsigned slot_count;
+    uint32_t free_slot;
+    unsigned pending;
+    
+    // Registered buffers
+    db_buffer* fixed;
+    unsigned fixed_count;
+    unsigned fixed_cursor;       // Where the search for a free buffer resumes
+};
+
+static int db_uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+    int ret;
+    do {
+        ret = (int)syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, NULL, 0);
+    } while (ret < 0 && errno == EINTR);
+    return ret;
+}
+
+/**
+ * @brief Take a request slot and an SQE, submitting queued SQEs if the ring is full
+ * @private
+ * @return SQE to fill (user_data already set), or NULL if the ring is saturated
+ */
+static struct io_uring_sqe* db_uring_prepare(struct db_uring_internal* ring, int opcode, int fd, db_buffer buf,
+                                             void* addr, size_t len, uint64_t offset, void* user) {
+    if (ring->free_slot == DB_URING_NONE) return NULL;
+    
+    unsigned tail = *ring->sq_tail;
+    if (tail - __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE) == ring->sq_entries) {
+        if (db_uring_submit(ring) <= 0) return NULL;
+        if (tail - __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE) == ring->sq_entries) return NULL;
+    }
+    
+    uint32_t index = ring->free_slot;
+    db_uring_slot* slot = &ring->slots[index];
+    ring->free_slot = slot->next_free;
+    slot->buf = buf;
+    slot->user = user;
+    slot->op = opcode == IORING_OP_READ || opcode == IORING_OP_READ_FIXED ? DB_URING_READ : DB_URING_WRITE;
+    ring->pending++;
+    
+    unsigned sq_index = tail & ring->sq_mask;
+    struct io_uring_sqe* sqe = &ring->sqes[sq_index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = (uint8_t)opcode;
+    sqe->fd = fd;
+    sqe->addr = (uint64_t)(uintptr_t)addr;
+    sqe->len = (uint32_t)len;
+    sqe->off = offset;
+    sqe->user_data = index;
+    
+    ring->sq_array[sq_index] = sq_index;
+    __atomic_store_n(ring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+    ring->sq_queued++;
+    return sqe;
+}
+
+/**
+ * @brief Find the registered buffer index of a buffer
+ * @private
+ */
+static uint32_t db_uring_fixed_index(struct db_uring_internal* ring, db_buffer buf) {
+    for (unsigned i = 0; i < ring->fixed_count; i++) {
+        if (ring->fixed[i] == buf) return i;
+    }
+    return DB_URING_NONE;
+}
+
+db_uring db_uring_new(unsigned entries) {
+    DB_ASSERT(entries > 0 && "db_uring_new: entries must be > 0");
+    
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    int fd = (int)syscall(__NR_io_uring_setup, entries, &params);
+    if (fd < 0) return NULL;
+    
+    struct db_uring_internal* ring = (struct db_uring_internal*)DB_MALLOC(sizeof(struct db_uring_internal));
+    DB_ASSERT(ring && "db_uring_new: memory allocation failed");
+    memset(ring, 0, sizeof(*ring));
+    ring->fd = fd;
+    
+    ring->sq_map_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->cq_map_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap) {
+        if (ring->cq_map_size > ring->sq_map_size) ring->sq_map_size = ring->cq_map_size;
+        ring->cq_map_size = ring->sq_map_size;
+    }
+    
+    ring->sq_map = mmap(NULL, ring->sq_map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, IORING_OFF_SQ_RING);
+    ring->cq_map = single_mmap || ring->sq_map == MAP_FAILED
+                       ? ring->sq_map
+                       : mmap(NULL, ring->cq_map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, IORING_OFF_CQ_RING);
+    ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    ring->sqes = (struct io_uring_sqe*)mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd,
+                                            IORING_OFF_SQES);
+    if (ring->sq_map == MAP_FAILED || ring->cq_map == MAP_FAILED || (void*)ring->sqes == MAP_FAILED) {
+        if ((void*)ring->sqes != MAP_FAILED) munmap(ring->sqes, ring->sqes_size);
+        if (ring->cq_map != MAP_FAILED && ring->cq_map != ring->sq_map) munmap(ring->cq_map, ring->cq_map_size);
+        if (ring->sq_map != MAP_FAILED) munmap(ring->sq_map, ring->sq_map_size);
+        close(fd);
+        DB_FREE(ring);
+        return NULL;
+    }
+    
+    char* sq = (char*)ring->sq_map;
+    ring->sq_head = (unsigned*)(sq + params.sq_off.head);
+    ring->sq_tail = (unsigned*)(sq + params.sq_off.tail);
+    ring->sq_array = (unsigned*)(sq + params.sq_off.array);
+    ring->sq_mask = *(unsigned*)(sq + params.sq_off.ring_mask);
+    ring->sq_entries = params.sq_entries;
+    
+    char* cq = (char*)ring->cq_map;
+    ring->cq_head = (unsigned*)(cq + params.cq_off.head);
+    ring->cq_tail = (unsigned*)(cq + params.cq_off.tail);
+    ring->cq_mask = *(unsigned*)(cq + params.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe*)(cq + params.cq_off.cqes);
+    
+    // Never have more requests out than the completion ring can hold, keeping
+    // one entry spare for the cancel results db_uring_release() waits on
+    ring->slot_count = params.cq_entries - 1;
+    ring->slots = (db_uring_slot*)DB_MALLOC(ring->slot_count * sizeof(db_uring_slot));
+    DB_ASSERT(ring->slots && "db_uring_new: memory allocation failed");
+    for (unsigned i = 0; i < ring->slot_count; i++) {
+        ring->slots[i].buf = NULL;
+        ring->slots[i].next_free = i + 1 < ring->slot_count ? i + 1 : DB_URING_NONE;
+    }
+    ring->free_slot = 0;
+    
+    return ring;
+}
+
+int db_uring_register_pool(db_uring ring, db_pool pool, unsigned count) {
+    DB_ASSERT(ring && "db_uring_register_pool: ring cannot be NULL");
+    DB_ASSERT(pool && "db_uring_register_pool: pool cannot be NULL");
+    DB_ASSERT(ring->fixed_count == 0 && "db_uring_register_pool: buffers already registered");
+    if (count == 0) return 0;
+    
+    db_buffer* fixed = (db_buffer*)DB_MALLOC(count * sizeof(db_buffer));
+    struct iovec* iov = (struct iovec*)DB_MALLOC(count * sizeof(struct iovec));
+    DB_ASSERT(fixed && iov && "db_uring_register_pool: memory allocation failed");
+    
+    for (unsigned i = 0; i < count; i++) {
+        fixed[i] = db_pool_acquire(pool);
+        iov[i].iov_base = fixed[i];
+        iov[i].iov_len = db_meta(fixed[i])->capacity;
+    }
+    
+    int ret = (int)syscall(__NR_io_uring_register, ring->fd, IORING_REGISTER_BUFFERS, iov, count);
+    DB_FREE(iov);
+    if (ret < 0) {
+        for (unsigned i = 0; i < count; i++) db_release(&fixed[i]);
+        DB_FREE(fixed);
+        return -1;
+    }
+    
+    ring->fixed = fixed;
+    ring->fixed_count = count;
+    ring->fixed_cursor = 0;
+    return 0;
+}
+
+int db_uring_read(db_uring ring, int fd, db_buffer* buf_ptr, size_t max_bytes, uint64_t offset, void* user) {
+    DB_ASSERT(ring && "db_uring_read: ring cannot be NULL");
+    DB_ASSERT(buf_ptr && *buf_ptr && "db_uring_read: buf_ptr and *buf_ptr cannot be NULL");
+    DB_ASSERT(max_bytes > 0 && max_bytes <= UINT32_MAX && "db_uring_read: max_bytes out of range");
+    if (ring->free_slot == DB_URING_NONE) return -1;
+    
+    size_t capacity = db_meta(*buf_ptr)->capacity;
+    char* tail = db_internal_reserve(buf_ptr, &capacity, max_bytes, NULL);
+    if (!tail) return -1;
+    
+    if (!db_uring_prepare(ring, IORING_OP_READ, fd, *buf_ptr, tail, max_bytes, offset, user)) return -1;
+    *buf_ptr = NULL;
+    return 0;
+}
+
+int db_uring_read_fixed(db_uring ring, int fd, size_t max_bytes, uint64_t offset, void* user) {
+    DB_ASSERT(ring && "db_uring_read_fixed: ring cannot be NULL");
+    
+    // Free means only the ring still holds the buffer
+    for (unsigned n = 0; n < ring->fixed_count; n++) {
+        unsigned i = (ring->fixed_cursor + n) % ring->fixed_count;
+        db_buffer buf = ring->fixed[i];
+        if (db_refcount(buf) != 1) continue;
+        
+        db_internal* meta = db_meta(buf);
+        size_t len = max_bytes < meta->capacity ? max_bytes : meta->capacity;
+        if (len > UINT32_MAX) len = UINT32_MAX;
+        struct io_uring_sqe* sqe = db_uring_prepare(ring, IORING_OP_READ_FIXED, fd, buf, buf, len, offset, user);
+        if (!sqe) return -1;
+        
+        sqe->buf_index = (uint16_t)i;
+        meta->size = 0;
+        DB_HASH_RESET(meta);
+        db_retain(buf);  // The completion's reference
+        ring->fixed_cursor = i + 1;
+        return 0;
+    }
+    return -1;
+}
+
+int db_uring_write(db_uring ring, int fd, db_buffer* buf_ptr, uint64_t offset, void* user) {
+    DB_ASSERT(ring && "db_uring_write: ring cannot be NULL");
+    DB_ASSERT(buf_ptr && *buf_ptr && "db_uring_write: buf_ptr and *buf_ptr cannot be NULL");
+    
+    db_buffer buf = *buf_ptr;
+    size_t size = db_meta(buf)->size;
+    DB_ASSERT(size <= UINT32_MAX && "db_uring_write: buffer too large for one request");
+    
+    uint32_t fixed = db_uring_fixed_index(ring, buf);
+    int opcode = fixed == DB_URING_NONE ? IORING_OP_WRITE : IORING_OP_WRITE_FIXED;
+    struct io_uring_sqe* sqe = db_uring_prepare(ring, opcode, fd, buf, buf, size, offset, user);
+    if (!sqe) return -1;
+    
+    if (fixed != DB_URING_NONE) sqe->buf_index = (uint16_t)fixed;
+    *buf_ptr = NULL;
+    return 0;
+}
+
+int db_uring_submit(db_uring ring) {
+    DB_ASSERT(ring && "db_uring_submit: ring cannot be NULL");
+    if (ring->sq_queued == 0) return 0;
+    
+    int submitted = db_uring_enter(ring->fd, ring->sq_queued, 0, 0);
+    if (submitted < 0) return -1;
+    ring->sq_queued -= (unsigned)submitted;
+    return submitted;
+}
+
+size_t db_uring_complete(db_uring ring, db_uring_completion* out, size_t max, unsigned min_complete) {
+    DB_ASSERT(ring && "db_uring_complete: ring cannot be NULL");
+    DB_ASSERT((out || max == 0) && "db_uring_complete: out cannot be NULL when max > 0");
+    
+    if (min_complete > ring->pending) min_complete = ring->pending;
+    if (min_complete > max) min_complete = (unsigned)max;
+    
+    unsigned head = *ring->cq_head;
+    unsigned ready = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE) - head;
+    if (ring->sq_queued || ready < min_complete) {
+        unsigned wait = ready < min_complete ? min_complete : 0;
+        int submitted = db_uring_enter(ring->fd, ring->sq_queued, wait, wait ? IORING_ENTER_GETEVENTS : 0);
+        if (submitted > 0) ring->sq_queued -= (unsigned)submitted;
+    }
+    
+    size_t count = 0;
+    unsigned tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+    while (head != tail && count < max) {
+        struct io_uring_cqe* cqe = &ring->cqes[head & ring->cq_mask];
+        uint32_t index = (uint32_t)cqe->user_data;
+        db_uring_slot* slot = &ring->slots[index];
+        
+        db_uring_completion* done = &out[count++];
+        done->buf = slot->buf;
+        done->user = slot->user;
+        done->result = cqe->res;
+        done->op = (db_uring_op)slot->op;
+        if (done->op == DB_URING_READ && cqe->res > 0) {
+            db_meta(done->buf)->size += (size_t)cqe->res;
+        }
+        
+        slot->buf = NULL;
+        slot->next_free = ring->free_slot;
+        ring->free_slot = index;
+        ring->pending--;
+        head++;
+    }
+    __atomic_store_n(ring->cq_head, head, __ATOMIC_RELEASE);
+    
+    return count;
+}
+
+unsigned db_uring_pending(db_uring ring) {
+    DB_ASSERT(ring && "db_uring_pending: ring cannot be NULL");
+    return ring->pending;
+}
+
+/**
+ * @brief Drop the buffer of a request and return its slot to the free list
+ * @private
+ */
+static void db_uring_retire(struct db_uring_internal* ring, uint32_t index) {
+    db_uring_slot* slot = &ring->slots[index];
+    db_release(&slot->buf);
+    slot->next_free = ring->free_slot;
+    ring->free_slot = index;
+    ring->pending--;
+}
+
+/**
+ * @brief Retire every request with a completion in the CQ, counting off cancel results
+ * @private
+ */
+static void db_uring_reap(struct db_uring_internal* ring, unsigned* cancels) {
+    unsigned head = *ring->cq_head;
+    unsigned tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+    for (; head != tail; head++) {
+        uint64_t user_data = ring->cqes[head & ring->cq_mask].user_data;
+        if (user_data == DB_URING_CANCEL) (*cancels)--;
+        else db_uring_retire(ring, (uint32_t)user_data);
+    }
+    __atomic_store_n(ring->cq_head, head, __ATOMIC_RELEASE);
+}
+
+void db_uring_release(db_uring* ring_ptr) {
+    DB_ASSERT(ring_ptr && "db_uring_release: ring_ptr cannot be NULL");
+    if (!*ring_ptr) return;
+    
+    db_uring ring = *ring_ptr;
+    *ring_ptr = NULL;
+    
+    // SQEs not yet passed to io_uring_enter never reached the kernel: take them back
+    unsigned tail = *ring->sq_tail;
+    for (unsigned k = 1; k <= ring->sq_queued; k++) {
+        db_uring_retire(ring, (uint32_t)ring->sqes[(tail - k) & ring->sq_mask].user_data);
+    }
+    tail -= ring->sq_queued;
+    ring->sq_queued = 0;
+    __atomic_store_n(ring->sq_tail, tail, __ATOMIC_RELEASE);
+    
+    // The kernel may still write into in-flight buffers: cancel them and wait for
+    // every completion. A cancel owes a CQE of its own, so one is queued only
+    // while the CQ has room for every result still due, and the CQ is reaped
+    // after each io_uring_enter. On a hard error the buffers are leaked, never freed.
+    unsigned cq_entries = ring->cq_mask + 1;
+    unsigned cancels = 0;  // Cancel results not reaped yet
+    unsigned next = 0;     // Next slot to look at for a cancel
+    bool wedged = false;
+    while (!wedged && ring->pending + cancels > 0) {
+        while (next < ring->slot_count && !ring->slots[next].buf) next++;
+        if (next < ring->slot_count && ring->pending + cancels < cq_entries &&
+            tail - __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE) < ring->sq_entries) {
+            unsigned sq_index = tail & ring->sq_mask;
+            struct io_uring_sqe* sqe = &ring->sqes[sq_index];
+            memset(sqe, 0, sizeof(*sqe));
+            sqe->opcode = IORING_OP_ASYNC_CANCEL;
+            sqe->fd = -1;
+            sqe->addr = next++;  // user_data of the request to cancel
+            sqe->user_data = DB_URING_CANCEL;
+            ring->sq_array[sq_index] = sq_index;
+            __atomic_store_n(ring->sq_tail, ++tail, __ATOMIC_RELEASE);
+            ring->sq_queued++;
+            cancels++;
+            continue;
+        }
+        
+        // Out of room or out of requests: submit what's queued, else wait for a result
+        int submitted = ring->sq_queued ? db_uring_enter(ring->fd, ring->sq_queued, 0, 0)
+                                        : db_uring_enter(ring->fd, 0, 1, IORING_ENTER_GETEVENTS);
+        if (submitted < 0 || (ring->sq_queued && submitted == 0)) wedged = true;
+        else ring->sq_queued -= (unsigned)submitted;
+        db_uring_reap(ring, &cancels);
+    }
+    
+    // Closing the ring also unregisters the fixed buffers
+    munmap(ring->sqes, ring->sqes_size);
+    if (ring->cq_map != ring->sq_map) munmap(ring->cq_map, ring->cq_map_size);
+    munmap(ring->sq_map, ring->sq_map_size);
+    close(ring->fd);
+    
+    // A fixed buffer still in flight keeps the reference its request holds
+    for (unsigned i = 0; i < ring->fixed_count; i++) db_release(&ring->fixed[i]);
+    DB_FREE(ring->fixed);
+    DB_FREE(ring->slots);
+    DB_FREE(ring);
+}
+
+#endif // DB_IO_URING
+
+// Byte order helpers
+#if defined(__BYTE_ORDER__) && defined(__ORDER_LITTLE_ENDIAN__)
+#define DB_LITTLE_ENDIAN (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#elif defined(_WIN32) || defined(__x86_64__) || defined(__i386__) || defined(__aarch64__)
+#define DB_LITTLE_ENDIAN 1
+#else
+#define DB_LITTLE_ENDIAN 0
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+/**
+ * @brief Load 8 bytes as a little-endian 64-bit value from any alignment
+ * @private
+ */
+static inline uint64_t db_load_le64(const void* src) {
+#if DB_LITTLE_ENDIAN
+    uint64_t value;
+    memcpy(&value, src, sizeof(value));
+    return value;
+#else
+    const uint8_t* p = (const uint8_t*)src;
+    return (uint64_t)p[0] | ((uint64_t)p[1] << 8) | ((uint64_t)p[2] << 16) | ((uint64_t)p[3] << 24) |
+           ((uint64_t)p[4] << 32) | ((uint64_t)p[5] << 40) | ((uint64_t)p[6] << 48) | ((uint64_t)p[7] << 56);
+#endif
+}
+
+/**
+ * @brief Count trailing zero bits (value must not be 0)
+ * @private
+ */
+static inline unsigned db_ctz64(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+    return (unsigned)__builtin_ctzll(value);
+#elif defined(_MSC_VER) && defined(_WIN64)
+    unsigned long index;
+    _BitScanForward64(&index, value);
+    return (unsigned)index;
+#else
+    unsigned count = 0;
+    while (!(value & 1)) {
+        value >>= 1;
+        count++;
+    }
+    return count;
+#endif
+}
+
+// SIMD support
+//
+// Kernels process whole blocks and return how many input bytes they handled;
+// the scalar code finishes the tail. SSE2 and NEON are used whenever the
+// compiler targets them, AVX2 is selected at runtime on GCC/Clang.
+#if !defined(DB_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define DB_SIMD_SSE2 1
+#include <emmintrin.h>
+#else
+#define DB_SIMD_SSE2 0
+#endif
+
+#if DB_SIMD_SSE2 && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define DB_SIMD_AVX2 1
+#include <immintrin.h>
+#define DB_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define DB_SIMD_AVX2 0
+#endif
+
+#if !defined(DB_NO_SIMD) && defined(__aarch64__) && defined(__ARM_NEON)
+#define DB_SIMD_NEON 1
+#include <arm_neon.h>
+#else
+#define DB_SIMD_NEON 0
+#endif
+
+#if DB_SIMD_AVX2
+/**
+ * @brief Check once whether the CPU supports AVX2
+ * @private
+ */
+static bool db_cpu_has_avx2(void) {
+    static int cached = -1;  // Benign race: every thread computes the same value
+    if (cached < 0) {
+        __builtin_cpu_init();
+        cached = __builtin_cpu_supports("avx2") ? 1 : 0;
+    }
+    return cached == 1;
+}
+#endif
+
+#if DB_SIMD_SSE2
+static size_t db_hex_encode_sse2(const uint8_t* src, size_t size, char* dst, bool uppercase) {
+    const __m128i mask = _mm_set1_epi8(0x0F);
+    const __m128i nine = _mm_set1_epi8(9);
+    const __m128i zero = _mm_set1_epi8('0');
+    const __m128i alpha = _mm_set1_epi8(uppercase ? 'A' - '0' - 10 : 'a' - '0' - 10);
+    size_t i = 0;
+    
+    for (; i + 16 <= size; i += 16) {
+        __m128i in = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i hi = _mm_and_si128(_mm_srli_epi16(in, 4), mask);
+        __m128i lo = _mm_and_si128(in, mask);
+        
+        // nibble + '0', plus the letter offset for nibbles above 9
+        hi = _mm_add_epi8(_mm_add_epi8(hi, zero), _mm_and_si128(_mm_cmpgt_epi8(hi, nine), alpha));
+        lo = _mm_add_epi8(_mm_add_epi8(lo, zero), _mm_and_si128(_mm_cmpgt_epi8(lo, nine), alpha));
+        
+        _mm_storeu_si128((__m128i*)(dst + i * 2), _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128((__m128i*)(dst + i * 2 + 16), _mm_unpackhi_epi8(hi, lo));
+    }
+    return i;
+}
+
+/**
+ * @brief Convert 16 hex characters to nibbles, flagging invalid characters
+ * @private
+ */
+static inline __m128i db_hex_nibbles_sse2(__m128i c, __m128i* valid) {
+    __m128i lower = _mm_or_si128(c, _mm_set1_epi8(0x20));
+    __m128i is_digit = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('0' - 1)),
+                                     _mm_cmplt_epi8(c, _mm_set1_epi8('9' + 1)));
+    __m128i is_alpha = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+                                     _mm_cmplt_epi8(lower, _mm_set1_epi8('f' + 1)));
+    *valid = _mm_and_si128(*valid, _mm_or_si128(is_digit, is_alpha));
+    
+    __m128i digit = _mm_and_si128(is_digit, _mm_sub_epi8(c, _mm_set1_epi8('0')));
+    __m128i letter = _mm_and_si128(is_alpha, _mm_sub_epi8(lower, _mm_set1_epi8('a' - 10)));
+    return _mm_or_si128(digit, letter);
+}
+
+static size_t db_hex_decode_sse2(const char* src, size_t byte_len, uint8_t* dst, bool* ok) {
+    const __m128i low_byte = _mm_set1_epi16(0x00FF);
+    __m128i valid = _mm_set1_epi8(-1);
+    size_t i = 0;
+    
+    for (; i + 16 <= byte_len; i += 16) {
+        __m128i n0 = db_hex_nibbles_sse2(_mm_loadu_si128((const __m128i*)(src + i * 2)), &valid);
+        __m128i n1 = db_hex_nibbles_sse2(_mm_loadu_si128((const __m128i*)(src + i * 2 + 16)), &valid);
+        
+        // Each 16-bit lane holds [high nibble, low nibble] - fold into one byte
+        __m128i b0 = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(n0, low_byte), 4), _mm_srli_epi16(n0, 8));
+        __m128i b1 = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(n1, low_byte), 4), _mm_srli_epi16(n1, 8));
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(b0, b1));
+    }
+    
+    *ok = _mm_movemask_epi8(valid) == 0xFFFF;
+    return i;
+}
+#endif
+
+#if DB_SIMD_AVX2
+DB_TARGET_AVX2
+static size_t db_hex_encode_avx2(const uint8_t* src, size_t size, char* dst, bool uppercase) {
+    const __m256i mask = _mm256_set1_epi8(0x0F);
+    const __m256i nine = _mm256_set1_epi8(9);
+    const __m256i zero = _mm256_set1_epi8('0');
+    const __m256i alpha = _mm256_set1_epi8(uppercase ? 'A' - '0' - 10 : 'a' - '0' - 10);
+    size_t i = 0;
+    
+    for (; i + 32 <= size; i += 32) {
+        __m256i in = _mm256_loadu_si256((const __m256i*)(src + i));
+        __m256i hi = _mm256_and_si256(_mm256_srli_epi16(in, 4), mask);
+        __m256i lo = _mm256_and_si256(in, mask);
+        
+        hi = _mm256_add_epi8(_mm256_add_epi8(hi, zero), _mm256_and_si256(_mm256_cmpgt_epi8(hi, nine), alpha));
+        lo = _mm256_add_epi8(_mm256_add_epi8(lo, zero), _mm256_and_si256(_mm256_cmpgt_epi8(lo, nine), alpha));
+        
+        // Unpack works per 128-bit lane, so put the lanes back in order
+        __m256i a = _mm256_unpacklo_epi8(hi, lo);
+        __m256i b = _mm256_unpackhi_epi8(hi, lo);
+        _mm256_storeu_si256((__m256i*)(dst + i * 2), _mm256_permute2x128_si256(a, b, 0x20));
+        _mm256_storeu_si256((__m256i*)(dst + i * 2 + 32), _mm256_permute2x128_si256(a, b, 0x31));
+    }
+    return i;
+}
+
+DB_TARGET_AVX2
+static inline __m256i db_hex_nibbles_avx2(__m256i c, __m256i* valid) {
+    __m256i lower = _mm256_or_si256(c, _mm256_set1_epi8(0x20));
+    __m256i is_digit = _mm256_andnot_si256(_mm256_cmpgt_epi8(c, _mm256_set1_epi8('9')),
+                                           _mm256_cmpgt_epi8(c, _mm256_set1_epi8('0' - 1)));
+    __m256i is_alpha = _mm256_andnot_si256(_mm256_cmpgt_epi8(lower, _mm256_set1_epi8('f')),
+                                           _mm256_cmpgt_epi8(lower, _mm256_set1_epi8('a' - 1)));
+    *valid = _mm256_and_si256(*valid, _mm256_or_si256(is_digit, is_alpha));
+    
+    __m256i digit = _mm256_and_si256(is_digit, _mm256_sub_epi8(c, _mm256_set1_epi8('0')));
+    __m256i letter = _mm256_and_si256(is_alpha, _mm256_sub_epi8(lower, _mm256_set1_epi8('a' - 10)));
+    return _mm256_or_si256(digit, letter);
+}
+
+DB_TARGET_AVX2
+static size_t db_hex_decode_avx2(const char* src, size_t byte_len, uint8_t* dst, bool* ok) {
+    const __m256i low_byte = _mm256_set1_epi16(0x00FF);
+    __m256i valid = _mm256_set1_epi8(-1);
+    size_t i = 0;
+    
+    for (; i + 32 <= byte_len; i += 32) {
+        __m256i n0 = db_hex_nibbles_avx2(_mm256_loadu_si256((const __m256i*)(src + i * 2)), &valid);
+        __m256i n1 = db_hex_nibbles_avx2(_mm256_loadu_si256((const __m256i*)(src + i * 2 + 32)), &valid);
+        
+        __m256i b0 = _mm256_or_si256(_mm256_slli_epi16(_mm256_and_si256(n0, low_byte), 4), _mm256_srli_epi16(n0, 8));
+        __m256i b1 = _mm256_or_si256(_mm256_slli_epi16(_mm256_and_si256(n1, low_byte), 4), _mm256_srli_epi16(n1, 8));
+        
+        // Pack works per 128-bit lane: [b0.lo, b1.lo, b0.hi, b1.hi] -> reorder quadwords
+        __m256i packed = _mm256_packus_epi16(b0, b1);
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_permute4x64_epi64(packed, 0xD8));
+    }
+    
+    *ok = (uint32_t)_mm256_movemask_epi8(valid) == 0xFFFFFFFFu;
+    return i;
+}
+#endif
+
+#if DB_SIMD_NEON
+static size_t db_hex_encode_neon(const uint8_t* src, size_t size, char* dst, bool uppercase) {
+    const uint8x16_t table = vld1q_u8((const uint8_t*)(uppercase ? "0123456789ABCDEF" : "0123456789abcdef"));
+    const uint8x16_t mask = vdupq_n_u8(0x0F);
+    size_t i = 0;
+    
+    for (; i + 16 <= size; i += 16) {
+        uint8x16_t in = vld1q_u8(src + i);
+        uint8x16x2_t out;
+        out.val[0] = vqtbl1q_u8(table, vshrq_n_u8(in, 4));
+        out.val[1] = vqtbl1q_u8(table, vandq_u8(in, mask));
+        vst2q_u8((uint8_t*)dst + i * 2, out);  // Interleaves high/low digits
+    }
+    return i;
+}
+
+static inline uint8x16_t db_hex_nibbles_neon(uint8x16_t c, uint8x16_t* valid) {
+    uint8x16_t digit = vsubq_u8(c, vdupq_n_u8('0'));
+    uint8x16_t letter = vsubq_u8(vorrq_u8(c, vdupq_n_u8(0x20)), vdupq_n_u8('a'));
+    uint8x16_t is_digit = vcltq_u8(digit, vdupq_n_u8(10));
+    uint8x16_t is_alpha = vcltq_u8(letter, vdupq_n_u8(6));
+    *valid = vandq_u8(*valid, vorrq_u8(is_digit, is_alpha));
+    return vbslq_u8(is_digit, digit, vaddq_u8(letter, vdupq_n_u8(10)));
+}
+
+static size_t db_hex_decode_neon(const char* src, size_t byte_len, uint8_t* dst, bool* ok) {
+    uint8x16_t valid = vdupq_n_u8(0xFF);
+    size_t i = 0;
+    
+    for (; i + 16 <= byte_len; i += 16) {
+        uint8x16x2_t in = vld2q_u8((const uint8_t*)src + i * 2);  // Even/odd characters
+        uint8x16_t hi = db_hex_nibbles_neon(in.val[0], &valid);
+        uint8x16_t lo = db_hex_nibbles_neon(in.val[1], &valid);
+        vst1q_u8(dst + i, vorrq_u8(vshlq_n_u8(hi, 4), lo));
+    }
+    
+    *ok = vminvq_u8(valid) == 0xFF;
+    return i;
+}
+#endif
+
+// Base64 kernels
+//
+// Encoders take whole 3-byte groups and return input bytes consumed; decoders
+// take whole 4-character groups and return characters consumed, stopping
+// early (with *ok false) at the first block holding an invalid character.
+static const char db_base64_standard[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+static const char db_base64_url[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+#if DB_SIMD_AVX2
+DB_TARGET_AVX2
+static size_t db_base64_encode_avx2(const uint8_t* src, size_t size, char* dst, bool url) {
+    // Per lane: bytes [b0 b1 b2] -> dword [b1 b0 b2 b1], so each sextet can be shifted into place
+    const __m256i spread = _mm256_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+                                            1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+    // Offset to add to each sextet, indexed by its range (see below)
+    const __m128i shift = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                        '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                        (char)((url ? '-' : '+') - 62), (char)((url ? '_' : '/') - 63),
+                                        'A', 0, 0);
+    const __m256i shift_lut = _mm256_broadcastsi128_si256(shift);
+    size_t i = 0;
+    
+    // Each lane loads 16 bytes and uses 12, so stop 4 bytes early
+    for (; i + 28 <= size; i += 24) {
+        __m256i in = _mm256_inserti128_si256(
+            _mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)(src + i))),
+            _mm_loadu_si128((const __m128i*)(src + i + 12)), 1);
+        in = _mm256_shuffle_epi8(in, spread);
+        
+        __m256i ac = _mm256_mulhi_epu16(_mm256_and_si256(in, _mm256_set1_epi32(0x0FC0FC00)),
+                                        _mm256_set1_epi32(0x04000040));
+        __m256i bd = _mm256_mullo_epi16(_mm256_and_si256(in, _mm256_set1_epi32(0x003F03F0)),
+                                        _mm256_set1_epi32(0x01000010));
+        __m256i sextets = _mm256_or_si256(ac, bd);
+        
+        // 0..25 -> 13, 26..51 -> 0, 52..61 -> 1..10, 62 -> 11, 63 -> 12
+        __m256i range = _mm256_subs_epu8(sextets, _mm256_set1_epi8(51));
+        range = _mm256_or_si256(range, _mm256_and_si256(_mm256_cmpgt_epi8(_mm256_set1_epi8(26), sextets),
+                                                         _mm256_set1_epi8(13)));
+        __m256i out = _mm256_add_epi8(sextets, _mm256_shuffle_epi8(shift_lut, range));
+        _mm256_storeu_si256((__m256i*)(dst + i / 3 * 4), out);
+    }
+    return i;
+}
+
+DB_TARGET_AVX2
+static inline __m256i db_base64_range_avx2(__m256i c, char lo, char hi) {
+    return _mm256_andnot_si256(_mm256_cmpgt_epi8(c, _mm256_set1_epi8(hi)),
+                               _mm256_cmpgt_epi8(c, _mm256_set1_epi8((char)(lo - 1))));
+}
+
+/**
+ * @brief Convert 32 base64 characters to sextets, flagging invalid characters
+ * @private
+ */
+DB_TARGET_AVX2
+static inline __m256i db_base64_sextets_avx2(__m256i c, bool url, __m256i* valid) {
+    __m256i upper = db_base64_range_avx2(c, 'A', 'Z');
+    __m256i lower = db_base64_range_avx2(c, 'a', 'z');
+    __m256i digit = db_base64_range_avx2(c, '0', '9');
+    __m256i s62 = _mm256_cmpeq_epi8(c, _mm256_set1_epi8(url ? '-' : '+'));
+    __m256i s63 = _mm256_cmpeq_epi8(c, _mm256_set1_epi8(url ? '_' : '/'));
+    *valid = _mm256_and_si256(*valid, _mm256_or_si256(_mm256_or_si256(upper, lower),
+                                                      _mm256_or_si256(digit, _mm256_or_si256(s62, s63))));
+    
+    __m256i value = _mm256_and_si256(upper, _mm256_sub_epi8(c, _mm256_set1_epi8('A')));
+    value = _mm256_or_si256(value, _mm256_and_si256(lower, _mm256_sub_epi8(c, _mm256_set1_epi8('a' - 26))));
+    value = _mm256_or_si256(value, _mm256_and_si256(digit, _mm256_add_epi8(c, _mm256_set1_epi8(52 - '0'))));
+    value = _mm256_or_si256(value, _mm256_and_si256(s62, _mm256_set1_epi8(62)));
+    return _mm256_or_si256(value, _mm256_and_si256(s63, _mm256_set1_epi8(63)));
+}
+
+DB_TARGET_AVX2
+static size_t db_base64_decode_avx2(const char* src, size_t length, uint8_t* dst, size_t dst_size,
+                                    bool url, bool* ok) {
+    const __m256i pack = _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                                          2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    const __m256i order = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7);
+    size_t i = 0;
+    
+    // Each block stores 32 bytes of which 24 are output, so keep clear of the end
+    for (; i + 32 <= length && i / 4 * 3 + 32 <= dst_size; i += 32) {
+        __m256i valid = _mm256_set1_epi8(-1);
+        __m256i sextets = db_base64_sextets_avx2(_mm256_loadu_si256((const __m256i*)(src + i)), url, &valid);
+        if ((uint32_t)_mm256_movemask_epi8(valid) != 0xFFFFFFFFu) {
+            *ok = false;
+            return i;
+        }
+        
+        // [a b c d] -> a<<18 | b<<12 | c<<6 | d in each dword, then gather the 3 bytes big-endian
+        __m256i pairs = _mm256_maddubs_epi16(sextets, _mm256_set1_epi32(0x01400140));
+        __m256i words = _mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00011000));
+        __m256i bytes = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(words, pack), order);
+        _mm256_storeu_si256((__m256i*)(dst + i / 4 * 3), bytes);
+    }
+    *ok = true;
+    return i;
+}
+#endif
+
+#if DB_SIMD_NEON
+static size_t db_base64_encode_neon(const uint8_t* src, size_t size, char* dst, bool url) {
+    uint8x16x4_t table = vld1q_u8_x4((const uint8_t*)(url ? db_base64_url : db_base64_standard));
+    const uint8x16_t mask = vdupq_n_u8(0x3F);
+    size_t i = 0;
+    
+    for (; i + 48 <= size; i += 48) {
+        uint8x16x3_t in = vld3q_u8(src + i);  // Deinterleaves into byte 0, 1 and 2 of each group
+        uint8x16x4_t out;
+        out.val[0] = vshrq_n_u8(in.val[0], 2);
+        out.val[1] = vandq_u8(vorrq_u8(vshlq_n_u8(in.val[0], 4), vshrq_n_u8(in.val[1], 4)), mask);
+        out.val[2] = vandq_u8(vorrq_u8(vshlq_n_u8(in.val[1], 2), vshrq_n_u8(in.val[2], 6)), mask);
+        out.val[3] = vandq_u8(in.val[2], mask);
+        for (int k = 0; k < 4; k++) {
+            out.val[k] = vqtbl4q_u8(table, out.val[k]);
+        }
+        vst4q_u8((uint8_t*)dst + i / 3 * 4, out);
+    }
+    return i;
+}
+
+static inline uint8x16_t db_base64_sextets_neon(uint8x16_t c, bool url, uint8x16_t* valid) {
+    uint8x16_t upper = vcltq_u8(vsubq_u8(c, vdupq_n_u8('A')), vdupq_n_u8(26));
+    uint8x16_t lower = vcltq_u8(vsubq_u8(c, vdupq_n_u8('a')), vdupq_n_u8(26));
+    uint8x16_t digit = vcltq_u8(vsubq_u8(c, vdupq_n_u8('0')), vdupq_n_u8(10));
+    uint8x16_t s62 = vceqq_u8(c, vdupq_n_u8(url ? '-' : '+'));
+    uint8x16_t s63 = vceqq_u8(c, vdupq_n_u8(url ? '_' : '/'));
+    *valid = vandq_u8(*valid, vorrq_u8(vorrq_u8(upper, lower), vorrq_u8(digit, vorrq_u8(s62, s63))));
+    
+    uint8x16_t value = vandq_u8(upper, vsubq_u8(c, vdupq_n_u8('A')));
+    value = vorrq_u8(value, vandq_u8(lower, vsubq_u8(c, vdupq_n_u8('a' - 26))));
+    value = vorrq_u8(value, vandq_u8(digit, vaddq_u8(c, vdupq_n_u8(52 - '0'))));
+    value = vorrq_u8(value, vandq_u8(s62, vdupq_n_u8(62)));
+    return vorrq_u8(value, vandq_u8(s63, vdupq_n_u8(63)));
+}
+
+static size_t db_base64_decode_neon(const char* src, size_t length, uint8_t* dst, size_t dst_size,
+                                    bool url, bool* ok) {
+    size_t i = 0;
+    
+    for (; i + 64 <= length && i / 4 * 3 + 48 <= dst_size; i += 64) {
+        uint8x16x4_t in = vld4q_u8((const uint8_t*)src + i);  // Character 0, 1, 2 and 3 of each group
+        uint8x16_t valid = vdupq_n_u8(0xFF);
+        uint8x16_t a = db_base64_sextets_neon(in.val[0], url, &valid);
+        uint8x16_t b = db_base64_sextets_neon(in.val[1], url, &valid);
+        uint8x16_t c = db_base64_sextets_neon(in.val[2], url, &valid);
+        uint8x16_t d = db_base64_sextets_neon(in.val[3], url, &valid);
+        if (vminvq_u8(valid) != 0xFF) {
+            *ok = false;
+            return i;
+        }
+        
+        uint8x16x3_t out;
+        out.val[0] = vorrq_u8(vshlq_n_u8(a, 2), vshrq_n_u8(b, 4));
+        out.val[1] = vorrq_u8(vshlq_n_u8(b, 4), vshrq_n_u8(c, 2));
+        out.val[2] = vorrq_u8(vshlq_n_u8(c, 6), d);
+        vst3q_u8(dst + i / 4 * 3, out);
+    }
+    *ok = true;
+    return i;
+}
+#endif
+
+// Byte swapping kernels
+//
+// Reverse each width-byte element (2, 4 or 8) in whole 16/32-byte blocks and
+// return how many bytes were handled.
+#if DB_SIMD_SSE2
+static size_t db_bswap_sse2(uint8_t* dst, const uint8_t* src, size_t size, size_t width) {
+    size_t i = 0;
+    
+    for (; i + 16 <= size; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+        // Reverse the 16-bit words of each element, then the bytes of each word
+        if (width == 4) {
+            v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+        } else if (width == 8) {
+            v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, _MM_SHUFFLE(0, 1, 2, 3)), _MM_SHUFFLE(0, 1, 2, 3));
+        }
+        v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+        _mm_storeu_si128((__m128i*)(dst + i), v);
+    }
+    return i;
+}
+#endif
+
+#if DB_SIMD_AVX2
+DB_TARGET_AVX2
+static size_t db_bswap_avx2(uint8_t* dst, const uint8_t* src, size_t size, size_t width) {
+    __m256i shuffle;
+    if (width == 2) {
+        shuffle = _mm256_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14,
+                                   1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+    } else if (width == 4) {
+        shuffle = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+                                   3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    } else {
+        shuffle = _mm256_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+                                   7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+    }
+    size_t i = 0;
+    
+    for (; i + 32 <= size; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(src + i));
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_shuffle_epi8(v, shuffle));
+    }
+    return i;
+}
+#endif
+
+#if DB_SIMD_NEON
+static size_t db_bswap_neon(uint8_t* dst, const uint8_t* src, size_t size, size_t width) {
+    size_t i = 0;
+    
+    for (; i + 16 <= size; i += 16) {
+        uint8x16_t v = vld1q_u8(src + i);
+        v = width == 2 ? vrev16q_u8(v) : width == 4 ? vrev32q_u8(v) : vrev64q_u8(v);
+        vst1q_u8(dst + i, v);
+    }
+    return i;
+}
+#endif
+
+/**
+ * @brief Reverse the bytes of a 32-bit value
+ * @private
+ */
+static inline uint32_t db_bswap32(uint32_t v) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_bswap32(v);
+#elif defined(_MSC_VER)
+    return _byteswap_ulong(v);
+#else
+    return (v >> 24) | ((v >> 8) & 0xFF00u) | ((v << 8) & 0xFF0000u) | (v << 24);
+#endif
+}
+
+/**
+ * @brief Copy count elements of width bytes, reversing each one if swap is set
+ * @private
+ */
+static void db_copy_elements(void* dst, const void* src, size_t count, size_t width, bool swap) {
+    size_t size = count * width;
+    if (size == 0) return;
+    
+    if (!swap) {
+        memcpy(dst, src, size);
+        return;
+    }
+    
+    uint8_t* out = (uint8_t*)dst;
+    const uint8_t* in = (const uint8_t*)src;
+    size_t i = 0;
+    
+#if DB_SIMD_AVX2
+    if (db_cpu_has_avx2()) {
+        i = db_bswap_avx2(out, in, size, width);
+    }
+#endif
+#if DB_SIMD_SSE2
+    i += db_bswap_sse2(out + i, in + i, size - i, width);
+#endif
+#if DB_SIMD_NEON
+    i = db_bswap_neon(out, in, size, width);
+#endif
+    
+    for (; i < size; i += width) {
+        if (width == 2) {
+            uint16_t v;
+            memcpy(&v, in + i, 2);
+            v = (uint16_t)((v << 8) | (v >> 8));
+            memcpy(out + i, &v, 2);
+        } else if (width == 4) {
+            uint32_t v;
+            memcpy(&v, in + i, 4);
+            v = db_bswap32(v);
+            memcpy(out + i, &v, 4);
+        } else {
+            uint64_t v;
+            memcpy(&v, in + i, 8);
+            v = ((uint64_t)db_bswap32((uint32_t)v) << 32) | db_bswap32((uint32_t)(v >> 32));
+            memcpy(out + i, &v, 8);
+        }
+    }
+}
+
+// Search kernels
+//
+// Each kernel scans whole blocks and returns the index of the first match,
+// or the number of bytes it scanned when there was none; the scalar code
+// continues from there.
+#if DB_SIMD_SSE2
+static size_t db_find_any_sse2(const uint8_t* data, size_t size, const uint8_t* set, size_t set_size, bool* found) {
+    __m128i masks[16];
+    for (size_t k = 0; k < set_size; k++) masks[k] = _mm_set1_epi8((char)set[k]);
+    size_t i = 0;
+    
+    for (; i + 16 <= size; i += 16) {
+        __m128i block = _mm_loadu_si128((const __m128i*)(data + i));
+        __m128i hits = _mm_cmpeq_epi8(block, masks[0]);
+        for (size_t k = 1; k < set_size; k++) hits = _mm_or_si128(hits, _mm_cmpeq_epi8(block, masks[k]));
+        
+        unsigned bits = (unsigned)_mm_movemask_epi8(hits);
+        if (bits) {
+            *found = true;
+            return i + db_ctz64(bits);
+        }
+    }
+    return i;
+}
+
+static size_t db_find_sse2(const uint8_t* data, size_t size, const uint8_t* needle, size_t needle_size, bool* found) {
+    const __m128i first = _mm_set1_epi8((char)needle[0]);
+    const __m128i last = _mm_set1_epi8((char)needle[needle_size - 1]);
+    size_t i = 0;
+    
+    for (; i + needle_size - 1 + 16 <= size; i += 16) {
+        __m128i head = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(data + i)), first);
+        __m128i tail = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(data + i + needle_size - 1)), last);
+        unsigned bits = (unsigned)_mm_movemask_epi8(_mm_and_si128(head, tail));
+        
+        while (bits) {
+            size_t at = i + db_ctz64(bits);
+            if (needle_size <= 2 || memcmp(data + at + 1, needle + 1, needle_size - 2) == 0) {
+                *found = true;
+                return at;
+            }
+            bits &= bits - 1;
+        }
+    }
+    return i;
+}
+#endif
+
+#if DB_SIMD_AVX2
+DB_TARGET_AVX2
+static size_t db_find_any_avx2(const uint8_t* data, size_t size, const uint8_t* set, size_t set_size, bool* found) {
+    __m256i masks[16];
+    for (size_t k = 0; k < set_size; k++) masks[k] = _mm256_set1_epi8((char)set[k]);
+    size_t i = 0;
+    
+    for (; i + 32 <= size; i += 32) {
+        __m256i block = _mm256_loadu_si256((const __m256i*)(data + i));
+        __m256i hits = _mm256_cmpeq_epi8(block, masks[0]);
+        for (size_t k = 1; k < set_size; k++) hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(block, masks[k]));
+        
+        uint32_t bits = (uint32_t)_mm256_movemask_epi8(hits);
+        if (bits) {
+            *found = true;
+            return i + db_ctz64(bits);
+        }
+    }
+    return i;
+}
+
+DB_TARGET_AVX2
+static size_t db_find_avx2(const uint8_t* data, size_t size, const uint8_t* needle, size_t needle_size, bool* found) {
+    const __m256i first = _mm256_set1_epi8((char)needle[0]);
+    const __m256i last = _mm256_set1_epi8((char)needle[needle_size - 1]);
+    size_t i = 0;
+    
+    for (; i + needle_size - 1 + 32 <= size; i += 32) {
+        __m256i head = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(data + i)), first);
+        __m256i tail = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(data + i + needle_size - 1)), last);
+        uint32_t bits = (uint32_t)_mm256_movemask_epi8(_mm256_and_si256(head, tail));
+        
+        while (bits) {
+            size_t at = i + db_ctz64(bits);
+            if (needle_size <= 2 || memcmp(data + at + 1, needle + 1, needle_size - 2) == 0) {
+                *found = true;
+                return at;
+            }
+            bits &= bits - 1;
+        }
+    }
+    return i;
+}
+#endif
+
+#if DB_SIMD_NEON
+/**
+ * @brief Pack a 16-byte compare result into a 64-bit mask, 4 bits per byte
+ * @private
+ */
+static inline uint64_t db_neon_mask(uint8x16_t hits) {
+    uint8x8_t packed = vshrn_n_u16(vreinterpretq_u16_u8(hits), 4);
+    return vget_lane_u64(vreinterpret_u64_u8(packed), 0);
+}
+
+static size_t db_find_any_neon(const uint8_t* data, size_t size, const uint8_t* set, size_t set_size, bool* found) {
+    uint8x16_t masks[16];
+    for (size_t k = 0; k < set_size; k++) masks[k] = vdupq_n_u8(set[k]);
+    size_t i = 0;
+    
+    for (; i + 16 <= size; i += 16) {
+        uint8x16_t block = vld1q_u8(data + i);
+        uint8x16_t hits = vceqq_u8(block, masks[0]);
+        for (size_t k = 1; k < set_size; k++) hits = vorrq_u8(hits, vceqq_u8(block, masks[k]));
+        
+        uint64_t bits = db_neon_mask(hits);
+        if (bits) {
+            *found = true;
+            return i + db_ctz64(bits) / 4;
+        }
+    }
+    return i;
+}
+
+static size_t db_find_neon(const uint8_t* data, size_t size, const uint8_t* needle, size_t needle_size, bool* found) {
+    const uint8x16_t first = vdupq_n_u8(needle[0]);
+    const uint8x16_t last = vdupq_n_u8(needle[needle_size - 1]);
+    size_t i = 0;
+    
+    for (; i + needle_size - 1 + 16 <= size; i += 16) {
+        uint8x16_t head = vceqq_u8(vld1q_u8(data + i), first);
+        uint8x16_t tail = vceqq_u8(vld1q_u8(data + i + needle_size - 1), last);
+        uint64_t bits = db_neon_mask(vandq_u8(head, tail)) & 0x8888888888888888ull;
+        
+        while (bits) {
+            size_t at = i + db_ctz64(bits) / 4;
+            if (needle_size <= 2 || memcmp(data + at + 1, needle + 1, needle_size - 2) == 0) {
+                *found = true;
+                return at;
+            }
+            bits &= bits - 1;
+        }
+    }
+    return i;
+}
+#endif
+
+/**
+ * @brief Find the first byte from set in data
+ * @private
+ * @return Index of the match, or DB_NOT_FOUND
+ */
+static size_t db_internal_find_any(const uint8_t* data, size_t size, const uint8_t* set, size_t set_size) {
+    if (set_size == 0) return DB_NOT_FOUND;
+    if (set_size == 1) {
+        const uint8_t* hit = (const uint8_t*)memchr(data, set[0], size);
+        return hit ? (size_t)(hit - data) : DB_NOT_FOUND;
+    }
+    
+    size_t i = 0;
+    bool found = false;
+    if (set_size <= 16) {
+#if DB_SIMD_AVX2
+        if (db_cpu_has_avx2()) {
+            i = db_find_any_avx2(data, size, set, set_size, &found);
+            if (found) return i;
+        }
+#endif
+#if DB_SIMD_SSE2
+        i += db_find_any_sse2(data + i, size - i, set, set_size, &found);
+        if (found) return i;
+#endif
+#if DB_SIMD_NEON
+        i = db_find_any_neon(data, size, set, set_size, &found);
+        if (found) return i;
+#endif
+    }
+    (void)found;  // Unused when no SIMD path is compiled in
+    
+    bool table[256] = {false};
+    for (size_t k = 0; k < set_size; k++) table[set[k]] = true;
+    for (; i < size; i++) {
+        if (table[data[i]]) return i;
+    }
+    return DB_NOT_FOUND;
+}
+
+/**
+ * @brief Find needle in data
+ * @private
+ * @return Index of the match, or DB_NOT_FOUND
+ */
+static size_t db_internal_find(const uint8_t* data, size_t size, const uint8_t* needle, size_t needle_size) {
+    if (needle_size == 0) return 0;
+    if (needle_size > size) return DB_NOT_FOUND;
+    if (needle_size == 1) return db_internal_find_any(data, size, needle, 1);
+    
+    size_t i = 0;
+    bool found = false;
+#if DB_SIMD_AVX2
+    if (db_cpu_has_avx2()) {
+        i = db_find_avx2(data, size, needle, needle_size, &found);
+        if (found) return i;
+    }
+#endif
+#if DB_SIMD_SSE2
+    i += db_find_sse2(data + i, size - i, needle, needle_size, &found);
+    if (found) return i;
+#endif
+#if DB_SIMD_NEON
+    i = db_find_neon(data, size, needle, needle_size, &found);
+    if (found) return i;
+#endif
+    (void)found;  // Unused when no SIMD path is compiled in
+    
+    // Remaining candidates: jump between occurrences of the first byte
+    size_t last_start = size - needle_size;
+    while (i <= last_start) {
+        const uint8_t* hit = (const uint8_t*)memchr(data + i, needle[0], last_start - i + 1);
+        if (!hit) break;
+        i = (size_t)(hit - data);
+        if (memcmp(data + i + 1, needle + 1, needle_size - 1) == 0) return i;
+        i++;
+    }
+    return DB_NOT_FOUND;
+}
+
+#if DB_SIMD_SSE2
+static size_t db_mismatch_sse2(const uint8_t* a, const uint8_t* b, size_t size, bool* found) {
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        __m128i eq = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(a + i)), _mm_loadu_si128((const __m128i*)(b + i)));
+        unsigned diff = ~(unsigned)_mm_movemask_epi8(eq) & 0xFFFFu;
+        if (diff) {
+            *found = true;
+            return i + db_ctz64(diff);
+        }
+    }
+    return i;
+}
+#endif
+
+#if DB_SIMD_AVX2
+DB_TARGET_AVX2
+static size_t db_mismatch_avx2(const uint8_t* a, const uint8_t* b, size_t size, bool* found) {
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        __m256i eq = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(a + i)),
+                                       _mm256_loadu_si256((const __m256i*)(b + i)));
+        uint32_t diff = ~(uint32_t)_mm256_movemask_epi8(eq);
+        if (diff) {
+            *found = true;
+            return i + db_ctz64(diff);
+        }
+    }
+    return i;
+}
+#endif
+
+#if DB_SIMD_NEON
+static size_t db_mismatch_neon(const uint8_t* a, const uint8_t* b, size_t size, bool* found) {
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        uint64_t diff = ~db_neon_mask(vceqq_u8(vld1q_u8(a + i), vld1q_u8(b + i)));
+        if (diff) {
+            *found = true;
+            return i + db_ctz64(diff) / 4;
+        }
+    }
+    return i;
+}
+#endif
+
+/**
+ * @brief Find the first index where a and b differ
+ * @private
+ * @return Index of the first difference, or size if the ranges are equal
+ */
+static size_t db_internal_mismatch(const uint8_t* a, const uint8_t* b, size_t size) {
+    size_t i = 0;
+    bool found = false;
+#if DB_SIMD_AVX2
+    if (db_cpu_has_avx2()) {
+        i = db_mismatch_avx2(a, b, size, &found);
+        if (found) return i;
+    }
+#endif
+#if DB_SIMD_SSE2
+    i += db_mismatch_sse2(a + i, b + i, size - i, &found);
+    if (found) return i;
+#endif
+#if DB_SIMD_NEON
+    i = db_mismatch_neon(a, b, size, &found);
+    if (found) return i;
+#endif
+    (void)found;  // Unused when no SIMD path is compiled in
+    
+    for (; i + 8 <= size; i += 8) {
+        uint64_t diff = db_load_le64(a + i) ^ db_load_le64(b + i);
+        if (diff) return i + db_ctz64(diff) / 8;
+    }
+    for (; i < size; i++) {
+        if (a[i] != b[i]) return i;
+    }
+    return size;
+}
+
+// Search implementation
+
+size_t db_find_byte(db_buffer buf, size_t offset, uint8_t byte) {
+    DB_ASSERT(buf && "db_find_byte: buf cannot be NULL");
+    
+    size_t size = db_meta(buf)->size;
+    if (offset >= size) return DB_NOT_FOUND;
+    
+    const char* hit = (const char*)memchr(buf + offset, byte, size - offset);
+    return hit ? (size_t)(hit - buf) : DB_NOT_FOUND;
+}
+
+size_t db_find_any(db_buffer buf, size_t offset, const void* set, size_t set_size) {
+    DB_ASSERT(buf && "db_find_any: buf cannot be NULL");
+    DB_ASSERT((set || set_size == 0) && "db_find_any: set cannot be NULL when set_size > 0");
+    
+    size_t size = db_meta(buf)->size;
+    if (offset >= size) return DB_NOT_FOUND;
+    
+    size_t at = db_internal_find_any((const uint8_t*)buf + offset, size - offset, (const uint8_t*)set, set_size);
+    return at == DB_NOT_FOUND ? DB_NOT_FOUND : offset + at;
+}
+
+size_t db_find(db_buffer buf, size_t offset, const void* needle, size_t needle_size) {
+    DB_ASSERT(buf && "db_find: buf cannot be NULL");
+    DB_ASSERT((needle || needle_size == 0) && "db_find: needle cannot be NULL when needle_size > 0");
+    
+    size_t size = db_meta(buf)->size;
+    if (offset > size) return DB_NOT_FOUND;
+    
+    size_t at = db_internal_find((const uint8_t*)buf + offset, size - offset, (const uint8_t*)needle, needle_size);
+    return at == DB_NOT_FOUND ? DB_NOT_FOUND : offset + at;
+}
+
+size_t db_mismatch(db_buffer buf1, db_buffer buf2) {
+    DB_ASSERT(buf1 && "db_mismatch: buf1 cannot be NULL");
+    DB_ASSERT(buf2 && "db_mismatch: buf2 cannot be NULL");
+    
+    size_t size1 = db_meta(buf1)->size;
+    size_t size2 = db_meta(buf2)->size;
+    size_t min_size = size1 < size2 ? size1 : size2;
+    
+    if (buf1 == buf2) return min_size;  // Same buffer (a retained copy or full-range slice)
+    
+    return db_internal_mismatch((const uint8_t*)buf1, (const uint8_t*)buf2, min_size);
+}
+
+void db_split_init(db_split* split, db_buffer buf, const void* delim, size_t delim_size) {
+    DB_ASSERT(split && "db_split_init: split cannot be NULL");
+    DB_ASSERT(buf && "db_split_init: buf cannot be NULL");
+    DB_ASSERT(delim && delim_size > 0 && "db_split_init: delimiter cannot be empty");
+    
+    split->buf = buf;
+    split->delim = (const char*)delim;
+    split->delim_size = delim_size;
+    split->position = 0;
+    split->done = false;
+}
+
+bool db_split_next(db_split* split, const char** piece, size_t* size) {
+    DB_ASSERT(split && piece && size && "db_split_next: arguments cannot be NULL");
+    
+    if (split->done) return false;
+    
+    size_t start = split->position;
+    size_t end = db_find(split->buf, start, split->delim, split->delim_size);
+    *piece = split->buf + start;
+    
+    if (end == DB_NOT_FOUND) {
+        *size = db_meta(split->buf)->size - start;
+        split->done = true;
+    } else {
+        *size = end - start;
+        split->position = end + split->delim_size;
+    }
+    return true;
+}
+
+// Checksum and hash implementation
+
+static const uint32_t db_crc32c_table[256] = {
+    0x00000000u, 0xf26b8303u, 0xe13b70f7u, 0x1350f3f4u, 0xc79a971fu, 0x35f1141cu,
+    0x26a1e7e8u, 0xd4ca64ebu, 0x8ad958cfu, 0x78b2dbccu, 0x6be22838u, 0x9989ab3bu,
+    0x4d43cfd0u, 0xbf284cd3u, 0xac78bf27u, 0x5e133c24u, 0x105ec76fu, 0xe235446cu,
+    0xf165b798u, 0x030e349bu, 0xd7c45070u, 0x25afd373u, 0x36ff2087u, 0xc494a384u,
+    0x9a879fa0u, 0x68ec1ca3u, 0x7bbcef57u, 0x89d76c54u, 0x5d1d08bfu, 0xaf768bbcu,
+    0xbc267848u, 0x4e4dfb4bu, 0x20bd8edeu, 0xd2d60dddu, 0xc186fe29u, 0x33ed7d2au,
+    0xe72719c1u, 0x154c9ac2u, 0x061c6936u, 0xf477ea35u, 0xaa64d611u, 0x580f5512u,
+    0x4b5fa6e6u, 0xb93425e5u, 0x6dfe410eu, 0x9f95c20du, 0x8cc531f9u, 0x7eaeb2fau,
+    0x30e349b1u, 0xc288cab2u, 0xd1d83946u, 0x23b3ba45u, 0xf779deaeu, 0x05125dadu,
+    0x1642ae59u, 0xe4292d5au, 0xba3a117eu, 0x4851927du, 0x5b016189u, 0xa96ae28au,
+    0x7da08661u, 0x8fcb0562u, 0x9c9bf696u, 0x6ef07595u, 0x417b1dbcu, 0xb3109ebfu,
+    0xa0406d4bu, 0x522bee48u, 0x86e18aa3u, 0x748a09a0u, 0x67dafa54u, 0x95b17957u,
+    0xcba24573u, 0x39c9c670u, 0x2a993584u, 0xd8f2b687u, 0x0c38d26cu, 0xfe53516fu,
+    0xed03a29bu, 0x1f682198u, 0x5125dad3u, 0xa34e59d0u, 0xb01eaa24u, 0x42752927u,
+    0x96bf4dccu, 0x64d4cecfu, 0x77843d3bu, 0x85efbe38u, 0xdbfc821cu, 0x2997011fu,
+    0x3ac7f2ebu, 0xc8ac71e8u, 0x1c661503u, 0xee0d9600u, 0xfd5d65f4u, 0x0f36e6f7u,
+    0x61c69362u, 0x93ad1061u, 0x80fde395u, 0x72966096u, 0xa65c047du, 0x5437877eu,
+    0x4767748au, 0xb50cf789u, 0xeb1fcbadu, 0x197448aeu, 0x0a24bb5au, 0xf84f3859u,
+    0x2c855cb2u, 0xdeeedfb1u, 0xcdbe2c45u, 0x3fd5af46u, 0x7198540du, 0x83f3d70eu,
+    0x90a324fau, 0x62c8a7f9u, 0xb602c312u, 0x44694011u, 0x5739b3e5u, 0xa55230e6u,
+    0xfb410cc2u, 0x092a8fc1u, 0x1a7a7c35u, 0xe811ff36u, 0x3cdb9bddu, 0xceb018deu,
+    0xdde0eb2au, 0x2f8b6829u, 0x82f63b78u, 0x709db87bu, 0x63cd4b8fu, 0x91a6c88cu,
+    0x456cac67u, 0xb7072f64u, 0xa457dc90u, 0x563c5f93u, 0x082f63b7u, 0xfa44e0b4u,
+    0xe9141340u, 0x1b7f9043u, 0xcfb5f4a8u, 0x3dde77abu, 0x2e8e845fu, 0xdce5075cu,
+    0x92a8fc17u, 0x60c37f14u, 0x73938ce0u, 0x81f80fe3u, 0x55326b08u, 0xa759e80bu,
+    0xb4091bffu, 0x466298fcu, 0x1871a4d8u, 0xea1a27dbu, 0xf94ad42fu, 0x0b21572cu,
+    0xdfeb33c7u, 0x2d80b0c4u, 0x3ed04330u, 0xccbbc033u, 0xa24bb5a6u, 0x502036a5u,
+    0x4370c551u, 0xb11b4652u, 0x65d122b9u, 0x97baa1bau, 0x84ea524eu, 0x7681d14du,
+    0x2892ed69u, 0xdaf96e6au, 0xc9a99d9eu, 0x3bc21e9du, 0xef087a76u, 0x1d63f975u,
+    0x0e330a81u, 0xfc588982u, 0xb21572c9u, 0x407ef1cau, 0x532e023eu, 0xa145813du,
+    0x758fe5d6u, 0x87e466d5u, 0x94b49521u, 0x66df1622u, 0x38cc2a06u, 0xcaa7a905u,
+    0xd9f75af1u, 0x2b9cd9f2u, 0xff56bd19u, 0x0d3d3e1au, 0x1e6dcdeeu, 0xec064eedu,
+    0xc38d26c4u, 0x31e6a5c7u, 0x22b65633u, 0xd0ddd530u, 0x0417b1dbu, 0xf67c32d8u,
+    0xe52cc12cu, 0x1747422fu, 0x49547e0bu, 0xbb3ffd08u, 0xa86f0efcu, 0x5a048dffu,
+    0x8ecee914u, 0x7ca56a17u, 0x6ff599e3u, 0x9d9e1ae0u, 0xd3d3e1abu, 0x21b862a8u,
+    0x32e8915cu, 0xc083125fu, 0x144976b4u, 0xe622f5b7u, 0xf5720643u, 0x07198540u,
+    0x590ab964u, 0xab613a67u, 0xb831c993u, 0x4a5a4a90u, 0x9e902e7bu, 0x6cfbad78u,
+    0x7fab5e8cu, 0x8dc0dd8fu, 0xe330a81au, 0x115b2b19u, 0x020bd8edu, 0xf0605beeu,
+    0x24aa3f05u, 0xd6c1bc06u, 0xc5914ff2u, 0x37faccf1u, 0x69e9f0d5u, 0x9b8273d6u,
+    0x88d28022u, 0x7ab90321u, 0xae7367cau, 0x5c18e4c9u, 0x4f48173du, 0xbd23943eu,
+    0xf36e6f75u, 0x0105ec76u, 0x12551f82u, 0xe03e9c81u, 0x34f4f86au, 0xc69f7b69u,
+    0xd5cf889du, 0x27a40b9eu, 0x79b737bau, 0x8bdcb4b9u, 0x988c474du, 0x6ae7c44eu,
+    0xbe2da0a5u, 0x4c4623a6u, 0x5f16d052u, 0xad7d5351u
+};
+
+#if !defined(DB_NO_SIMD) && defined(__GNUC__) && defined(__x86_64__)
+#define DB_HW_CRC32C_SSE42 1
+#include <nmmintrin.h>
+
+/**
+ * @brief Check once whether the CPU supports SSE4.2
+ * @private
+ */
+static bool db_cpu_has_sse42(void) {
+    static int cached = -1;  // Benign race: every thread computes the same value
+    if (cached < 0) {
+        __builtin_cpu_init();
+        cached = __builtin_cpu_supports("sse4.2") ? 1 : 0;
+    }
+    return cached == 1;
+}
+
+__attribute__((target("sse4.2")))
+static uint32_t db_crc32c_sse42(uint32_t crc, const uint8_t* p, size_t size) {
+    uint64_t c = crc;
+    for (; size >= 8; size -= 8, p += 8) {
+        uint64_t word;
+        memcpy(&word, p, 8);
+        c = _mm_crc32_u64(c, word);
+    }
+    uint32_t c32 = (uint32_t)c;
+    for (; size > 0; size--) c32 = _mm_crc32_u8(c32, *p++);
+    return c32;
+}
+#else
+#define DB_HW_CRC32C_SSE42 0
+#endif
+
+#if !defined(DB_NO_SIMD) && defined(__ARM_FEATURE_CRC32)
+#define DB_HW_CRC32C_ARM 1
+#include <arm_acle.h>
+
+static uint32_t db_crc32c_arm(uint32_t crc, const uint8_t* p, size_t size) {
+    for (; size >= 8; size -= 8, p += 8) {
+        uint64_t word;
+        memcpy(&word, p, 8);
+        crc = __crc32cd(crc, word);
+    }
+    for (; size > 0; size--) crc = __crc32cb(crc, *p++);
+    return crc;
+}
+#else
+#define DB_HW_CRC32C_ARM 0
+#endif
+
+uint32_t db_crc32c_update(uint32_t crc, const void* data, size_t size) {
+    DB_ASSERT((data || size == 0) && "db_crc32c_update: data cannot be NULL when size > 0");
+    
+    const uint8_t* p = (const uint8_t*)data;
+    crc = ~crc;
+    
+#if DB_HW_CRC32C_SSE42
+    if (db_cpu_has_sse42()) return ~db_crc32c_sse42(crc, p, size);
+#endif
+#if DB_HW_CRC32C_ARM
+    return ~db_crc32c_arm(crc, p, size);
+#endif
+    
+    for (; size > 0; size--) {
+        crc = db_crc32c_table[(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+uint32_t db_crc32c(db_buffer buf) {
+    DB_ASSERT(buf && "db_crc32c: buf cannot be NULL");
+    return db_crc32c_update(0, buf, db_meta(buf)->size);
+}
+
+#define DB_XXH_PRIME1 0x9E3779B185EBCA87ull
+#define DB_XXH_PRIME2 0xC2B2AE3D27D4EB4Full
+#define DB_XXH_PRIME3 0x165667B19E3779F9ull
+#define DB_XXH_PRIME4 0x85EBCA77C2B2AE63ull
+#define DB_XXH_PRIME5 0x27D4EB2F165667C5ull
+
+static inline uint64_t db_rotl64(uint64_t value, unsigned bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+static inline uint64_t db_xxh64_round(uint64_t acc, uint64_t input) {
+    acc += input * DB_XXH_PRIME2;
+    return db_rotl64(acc, 31) * DB_XXH_PRIME1;
+}
+
+static inline uint64_t db_xxh64_merge(uint64_t hash, uint64_t acc) {
+    hash ^= db_xxh64_round(0, acc);
+    return hash * DB_XXH_PRIME1 + DB_XXH_PRIME4;
+}
+
+uint64_t db_xxhash64(const void* data, size_t size, uint64_t seed) {
+    DB_ASSERT((data || size == 0) && "db_xxhash64: data cannot be NULL when size > 0");
+    
+    const uint8_t* p = (const uint8_t*)data;
+    const uint8_t* end = p + size;
+    uint64_t hash;
+    
+    if (size >= 32) {
+        // Four independent lanes keep the multipliers busy
+        uint64_t v1 = seed + DB_XXH_PRIME1 + DB_XXH_PRIME2;
+        uint64_t v2 = seed + DB_XXH_PRIME2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - DB_XXH_PRIME1;
+        
+        for (; end - p >= 32; p += 32) {
+            v1 = db_xxh64_round(v1, db_load_le64(p));
+            v2 = db_xxh64_round(v2, db_load_le64(p + 8));
+            v3 = db_xxh64_round(v3, db_load_le64(p + 16));
+            v4 = db_xxh64_round(v4, db_load_le64(p + 24));
+        }
+        
+        hash = db_rotl64(v1, 1) + db_rotl64(v2, 7) + db_rotl64(v3, 12) + db_rotl64(v4, 18);
+        hash = db_xxh64_merge(hash, v1);
+        hash = db_xxh64_merge(hash, v2);
+        hash = db_xxh64_merge(hash, v3);
+        hash = db_xxh64_merge(hash, v4);
+    } else {
+        hash = seed + DB_XXH_PRIME5;
+    }
+    
+    hash += (uint64_t)size;
+    
+    for (; end - p >= 8; p += 8) {
+        hash ^= db_xxh64_round(0, db_load_le64(p));
+        hash = db_rotl64(hash, 27) * DB_XXH_PRIME1 + DB_XXH_PRIME4;
+    }
+    if (end - p >= 4) {
+        uint32_t word = (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+        hash ^= (uint64_t)word * DB_XXH_PRIME1;
+        hash = db_rotl64(hash, 23) * DB_XXH_PRIME2 + DB_XXH_PRIME3;
+        p += 4;
+    }
+    for (; p < end; p++) {
+        hash ^= (uint64_t)*p * DB_XXH_PRIME5;
+        hash = db_rotl64(hash, 11) * DB_XXH_PRIME1;
+    }
+    
+    // Final avalanche
+    hash ^= hash >> 33;
+    hash *= DB_XXH_PRIME2;
+    hash ^= hash >> 29;
+    hash *= DB_XXH_PRIME3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+uint64_t db_hash(db_buffer buf) {
+    DB_ASSERT(buf && "db_hash: buf cannot be NULL");
+    
+    db_internal* meta = db_meta(buf);
+#if DB_CACHE_HASH
+    uint64_t cached = DB_HASH_LOAD(&meta->hash);
+    if (cached) return cached;
+#endif
+    
+    uint64_t hash = db_xxhash64(buf, meta->size, 0);
+    if (hash == 0) hash = 1;  // 0 means "not computed" in the header
+    
+#if DB_CACHE_HASH
+    DB_HASH_STORE(&meta->hash, hash);
+#endif
+    return hash;
+}
+
+// Utility functions
+
+/**
+ * @brief Internal function to hex-encode size bytes into size * 2 characters
+ * @private
+ */
+static void db_internal_hex_encode(const uint8_t* data, size_t size, char* hex_data, bool uppercase) {
+    const char* hex_chars = uppercase ? "0123456789ABCDEF" : "0123456789abcdef";
+    size_t i = 0;
+    
+#if DB_SIMD_AVX2
+    if (db_cpu_has_avx2()) {
+        i = db_hex_encode_avx2(data, size, hex_data, uppercase);
+    }
+#endif
+#if DB_SIMD_SSE2
+    i += db_hex_encode_sse2(data + i, size - i, hex_data + i * 2, uppercase);
+#endif
+#if DB_SIMD_NEON
+    i = db_hex_encode_neon(data, size, hex_data, uppercase);
+#endif
+    
+    for (; i < size; i++) {
+        hex_data[i * 2] = hex_chars[data[i] >> 4];
+        hex_data[i * 2 + 1] = hex_chars[data[i] & 0x0F];
+    }
+}
+
+db_buffer db_to_hex(db_buffer buf, bool uppercase) {
+    DB_ASSERT(buf && "db_to_hex: buf cannot be NULL");
+    
+    size_t size = db_meta(buf)->size;
+    if (size == 0) return db_new_with_data("", 0);
+    
+    size_t hex_size = size * 2;
+    db_buffer hex_buf = db_new(hex_size);
+    // db_new now asserts on allocation failure
+    
+    db_internal_hex_encode((const uint8_t*)buf, size, hex_buf, uppercase);
+    
+    db_meta(hex_buf)->size = hex_size;
+    return hex_buf;
+}
+
+static int hex_char_to_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+db_buffer db_from_hex(const char* hex_string, size_t length) {
+    if (!hex_string || length % 2 != 0) return NULL; // Runtime validation
+    
+    size_t byte_length = length / 2;
+    db_buffer buf = db_new(byte_length);
+    // db_new now asserts on allocation failure
+    
+    uint8_t* data = (uint8_t*)buf;
+    size_t i = 0;
+    bool ok = true;
+    
+#if DB_SIMD_AVX2
+    if (db_cpu_has_avx2()) {
+        i = db_hex_decode_avx2(hex_string, byte_length, data, &ok);
+    }
+#endif
+#if DB_SIMD_SSE2
+    if (ok) {
+        bool block_ok = true;
+        i += db_hex_decode_sse2(hex_string + i * 2, byte_length - i, data + i, &block_ok);
+        ok = block_ok;
+    }
+#endif
+#if DB_SIMD_NEON
+    i = db_hex_decode_neon(hex_string, byte_length, data, &ok);
+#endif
+    if (!ok) {
+        db_release(&buf);
+        return NULL;
+    }
+    
+    for (; i < byte_length; i++) {
+        int high = hex_char_to_value(hex_string[i * 2]);
+        int low = hex_char_to_value(hex_string[i * 2 + 1]);
+        
+        if (high < 0 || low < 0) {
+            db_release(&buf);
+            return NULL;
+        }
+        
+        data[i] = (uint8_t)((high << 4) | low);
+    }
+    
+    db_meta(buf)->size = byte_length;
+    return buf;
+}
+
+/**
+ * @brief Internal function to get the exact encoded length of size bytes
+ * @private
+ */
+static size_t db_base64_encoded_size(size_t size, db_base64_alphabet alphabet) {
+    size_t tail = size % 3;
+    if (alphabet == DB_BASE64_STANDARD && tail) return (size / 3 + 1) * 4;
+    return size / 3 * 4 + (tail ? tail + 1 : 0);
+}
+
+/**
+ * @brief Internal function to encode whole 3-byte groups
+ * @private
+ * @return Input bytes consumed (size rounded down to a multiple of 3)
+ */
+static size_t db_base64_encode_groups(const uint8_t* src, size_t size, char* dst, db_base64_alphabet alphabet) {
+    bool url = alphabet == DB_BASE64_URL;
+    const char* table = url ? db_base64_url : db_base64_standard;
+    size_t i = 0;
+    
+#if DB_SIMD_AVX2
+    if (db_cpu_has_avx2()) {
+        i = db_base64_encode_avx2(src, size, dst, url);
+    }
+#endif
+#if DB_SIMD_NEON
+    i = db_base64_encode_neon(src, size, dst, url);
+#endif
+    (void)url;
+    
+    for (; i + 3 <= size; i += 3) {
+        uint32_t group = (uint32_t)src[i] << 16 | (uint32_t)src[i + 1] << 8 | src[i + 2];
+        char* out = dst + i / 3 * 4;
+        out[0] = table[group >> 18];
+        out[1] = table[(group >> 12) & 0x3F];
+        out[2] = table[(group >> 6) & 0x3F];
+        out[3] = table[group & 0x3F];
+    }
+    return i;
+}
+
+/**
+ * @brief Internal function to encode the final 1 or 2 bytes of a message
+ * @private
+ * @return Characters written (2-4)
+ */
+static size_t db_base64_encode_tail(const uint8_t* src, size_t size, char* dst, db_base64_alphabet alphabet) {
+    const char* table = alphabet == DB_BASE64_URL ? db_base64_url : db_base64_standard;
+    uint32_t group = (uint32_t)src[0] << 16 | (size > 1 ? (uint32_t)src[1] << 8 : 0);
+    
+    dst[0] = table[group >> 18];
+    dst[1] = table[(group >> 12) & 0x3F];
+    size_t written = 2;
+    if (size > 1) dst[written++] = table[(group >> 6) & 0x3F];
+    if (alphabet == DB_BASE64_STANDARD) {
+        while (written < 4) dst[written++] = '=';
+    }
+    return written;
+}
+
+static int db_base64_char_to_value(char c, db_base64_alphabet alphabet) {
+    if (c >= 'A' && c <= 'Z') return c - 'A';
+    if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+    if (c >= '0' && c <= '9') return c - '0' + 52;
+    if (c == (alphabet == DB_BASE64_URL ? '-' : '+')) return 62;
+    if (c == (alphabet == DB_BASE64_URL ? '_' : '/')) return 63;
+    return -1;
+}
+
+db_buffer db_to_base64(db_buffer buf, db_base64_alphabet alphabet) {
+    DB_ASSERT(buf && "db_to_base64: buf cannot be NULL");
+    
+    size_t size = db_meta(buf)->size;
+    size_t encoded_size = db_base64_encoded_size(size, alphabet);
+    db_buffer text = db_new(encoded_size);
+    // db_new now asserts on allocation failure
+    
+    const uint8_t* data = (const uint8_t*)buf;
+    size_t consumed = db_base64_encode_groups(data, size, text, alphabet);
+    if (consumed < size) {
+        db_base64_encode_tail(data + consumed, size - consumed, text + consumed / 3 * 4, alphabet);
+    }
+    
+    db_meta(text)->size = encoded_size;
+    return text;
+}
+
+db_buffer db_from_base64(const char* text, size_t length, db_base64_alphabet alphabet) {
+    if (!text) return NULL; // Runtime validation
+    
+    // Padding is only valid as the end of a full 4-character group
+    if (length % 4 == 0 && length > 0 && text[length - 1] == '=') {
+        length -= (text[length - 2] == '=') ? 2 : 1;
+    }
+    if (length % 4 == 1) return NULL;
+    
+    size_t decoded_size = length / 4 * 3 + (length % 4 ? length % 4 - 1 : 0);
+    db_buffer buf = db_new(decoded_size);
+    // db_new now asserts on allocation failure
+    
+    uint8_t* data = (uint8_t*)buf;
+    size_t i = 0;
+    bool ok = true;
+    
+#if DB_SIMD_AVX2
+    if (db_cpu_has_avx2()) {
+        i = db_base64_decode_avx2(text, length, data, decoded_size, alphabet == DB_BASE64_URL, &ok);
+    }
+#endif
+#if DB_SIMD_NEON
+    i = db_base64_decode_neon(text, length, data, decoded_size, alphabet == DB_BASE64_URL, &ok);
+#endif
+    if (!ok) {
+        db_release(&buf);
+        return NULL;
+    }
+    
+    uint32_t group = 0;
+    size_t count = 0;
+    size_t out = i / 4 * 3;
+    for (; i < length; i++) {
+        int value = db_base64_char_to_value(text[i], alphabet);
+        if (value < 0) {
+            db_release(&buf);
+            return NULL;
+        }
+        
+        group = group << 6 | (uint32_t)value;
+        if (++count == 4) {
+            data[out++] = (uint8_t)(group >> 16);
+            data[out++] = (uint8_t)(group >> 8);
+            data[out++] = (uint8_t)group;
+            group = 0;
+            count = 0;
+        }
+    }
+    if (count == 2) {
+        data[out++] = (uint8_t)(group >> 4);
+    } else if (count == 3) {
+        data[out++] = (uint8_t)(group >> 10);
+        data[out++] = (uint8_t)(group >> 2);
+    }
+    
+    db_meta(buf)->size = decoded_size;
+    return buf;
+}
+
+void db_debug_print(db_buffer buf, const char* label) {
+    const char* name = label ? label : "buffer";
+    
+    if (!buf) {
+        printf("%s: NULL\n", name);
+        return;
+    }
+    
+    db_internal* meta = db_meta(buf);
+    size_t size = meta->size;
+    size_t capacity = meta->capacity;
+    int refcount = DB_REFCOUNT_LOAD(&meta->refcount);
+    
+    printf("%s: size=%zu, capacity=%zu, refcount=%d\n",
+           name, size, capacity, refcount);
+    
+    // Print first few bytes as hex
     if (size > 0) {
-        memcpy(buf, data, size);
-        db_meta(buf)->size = size;
+        printf("  data: ");
+        const uint8_t* data = (const uint8_t*)buf;
+        size_t print_size = size < 16 ? size : 16;
+        
+        for (size_t i = 0; i < print_size; i++) {
+            printf("%02x ", data[i]);
+        }
+        
+        if (size > 16) {
+            printf("... (%zu more bytes)", size - 16);
+        }
+        printf("\n");
+    }
+}
+
+db_stats db_stats_snapshot(void) {
+#if DB_STATS
+    return db_stats_tls;
+#else
+    db_stats stats;
+    memset(&stats, 0, sizeof(stats));
+    return stats;
+#endif
+}
+
+void db_stats_reset(void) {
+#if DB_STATS
+    int64_t live_bytes = db_stats_tls.live_bytes;
+    memset(&db_stats_tls, 0, sizeof(db_stats_tls));
+    db_stats_tls.live_bytes = live_bytes;
+    db_stats_tls.peak_live_bytes = live_bytes;
+#endif
+}
+
+// Builder and Reader Implementation
+
+struct db_builder_internal {
+    db_refcount_t refcount;  // Reference count for the builder itself
+    db_buffer data;          // Points to buffer data (same layout as db_buffer)
+    size_t capacity;         // Capacity for growth (size is in metadata)
+    db_growth_policy policy; // How to grow when capacity runs out
+    char* readv_chunk;       // Overflow block for db_builder_readv() (allocated on first use)
+};
+
+struct db_reader_internal {
+    db_refcount_t refcount;  // Reference count for the reader itself
+    db_buffer buf;           // Buffer being read (retained reference)
+    const char* data;        // Start of the readable range inside buf
+    size_t size;             // Length of the readable range
+    size_t position;         // Current read position (relative to data)
+};
+
+// Builder implementation
+
+db_builder db_builder_new(size_t initial_capacity) {
+    return db_builder_new_ex(initial_capacity, NULL);
+}
+
+db_builder db_builder_new_ex(size_t initial_capacity, const db_allocator* allocator) {
+    struct db_builder_internal* builder = (struct db_builder_internal*)DB_MALLOC(sizeof(struct db_builder_internal));
+    DB_ASSERT(builder && "db_builder_new: memory allocation failed");
+    
+    db_buffer buf = db_new_ex(initial_capacity, allocator);
+    // db_new asserts on allocation failure
+    
+    builder->refcount = DB_REFCOUNT_INIT(1);
+    builder->data = buf;  // Take ownership of newly created buffer
+    builder->capacity = initial_capacity;
+    builder->policy = (db_growth_policy){0};
+    builder->readv_chunk = NULL;
+    
+    return builder;
+}
+
+db_builder db_builder_from_buffer(db_buffer buf) {
+    DB_ASSERT(buf && "db_builder_from_buffer: buf cannot be NULL");
+    
+    struct db_builder_internal* builder = (struct db_builder_internal*)DB_MALLOC(sizeof(struct db_builder_internal));
+    DB_ASSERT(builder && "db_builder_from_buffer: memory allocation failed");
+    
+    // Make a copy of the buffer to preserve immutability
+    builder->data = db_new_with_data(buf, db_size(buf));
+    builder->refcount = DB_REFCOUNT_INIT(1);
+    builder->capacity = db_capacity(builder->data);  // The copy only holds the data
+    builder->policy = (db_growth_policy){0};
+    builder->readv_chunk = NULL;
+    
+    return builder;
+}
+
+db_builder db_builder_from_buffer_take(db_buffer* buf_ptr) {
+    DB_ASSERT(buf_ptr && *buf_ptr && "db_builder_from_buffer_take: buf_ptr and *buf_ptr cannot be NULL");
+    
+    if (db_refcount(*buf_ptr) > 1) {
+        // Someone else can still see it - fall back to copying
+        db_builder builder = db_builder_from_buffer(*buf_ptr);
+        db_release(buf_ptr);
+        return builder;
     }
     
-    return buf;
+    struct db_builder_internal* builder = (struct db_builder_internal*)DB_MALLOC(sizeof(struct db_builder_internal));
+    DB_ASSERT(builder && "db_builder_from_buffer_take: memory allocation failed");
+    
+    builder->refcount = DB_REFCOUNT_INIT(1);
+    builder->data = *buf_ptr;  // Adopt the caller's reference
+    builder->capacity = db_meta(builder->data)->capacity;
+    builder->policy = (db_growth_policy){0};
+    builder->readv_chunk = NULL;
+    *buf_ptr = NULL;
+    
+    return builder;
 }
 
-db_buffer db_new_from_owned_data(void* data, size_t size, size_t capacity) {
-    DB_ASSERT((data || (size == 0 && capacity == 0)) && "db_new_from_owned_data: data cannot be NULL with non-zero size/capacity");
-    DB_ASSERT(capacity >= size && "db_new_from_owned_data: capacity must be >= size");
+void db_builder_set_policy(db_builder builder, const db_growth_policy* policy) {
+    DB_ASSERT(builder && "db_builder_set_policy: builder cannot be NULL");
     
-    // We can't use the negative offset trick here since we don't control the data allocation
-    // Instead, we'll copy the data to maintain design consistency
-    db_buffer buf = db_alloc(capacity);
-    // db_alloc now asserts on allocation failure
+    builder->policy = policy ? *policy : (db_growth_policy){0};
+}
+
+db_builder db_builder_retain(db_builder builder) {
+    DB_ASSERT(builder && "db_builder_retain: builder cannot be NULL");
+    DB_REFCOUNT_RETAIN(&builder->refcount);
+    return builder;
+}
+
+void db_builder_release(db_builder* builder_ptr) {
+    DB_ASSERT(builder_ptr && "db_builder_release: builder_ptr cannot be NULL");
+    if (!*builder_ptr) return;
     
-    if (size > 0) {
-        memcpy(buf, data, size);
-        db_meta(buf)->size = size;
+    db_builder builder = *builder_ptr;
+    *builder_ptr = NULL;
+    
+    if (DB_REFCOUNT_DECREMENT(&builder->refcount) == 0) {
+        // Reference count reached 0, free the builder and release buffer
+        db_release(&builder->data);
+        DB_FREE(builder->readv_chunk);
+        DB_FREE(builder);
+    }
+}
+
+db_buffer db_builder_finish(db_builder* builder_ptr) {
+    DB_ASSERT(builder_ptr && "db_builder_finish: builder_ptr cannot be NULL");
+    DB_ASSERT(*builder_ptr && "db_builder_finish: builder cannot be NULL");
+    
+    struct db_builder_internal* builder = *builder_ptr;
+    if (builder->policy.shrink_on_finish) {
+        db_internal_shrink_to_fit(&builder->data);
     }
+    db_buffer result = builder->data;
     
-    return buf;
+    // Invalidate the builder - don't release the buffer, it's being returned
+    builder->data = NULL;
+    DB_FREE(builder->readv_chunk);
+    DB_FREE(builder);
+    *builder_ptr = NULL;
+    
+    return result;
 }
 
-db_buffer db_retain(db_buffer buf) {
-    DB_ASSERT(buf && "db_retain: buf cannot be NULL");
-    DB_REFCOUNT_INCREMENT(&db_meta(buf)->refcount);
-    return buf;
+size_t db_builder_size(db_builder builder) {
+    DB_ASSERT(builder && "db_builder_size: builder cannot be NULL");
+    return db_size(builder->data);
 }
 
-void db_release(db_buffer* buf_ptr) {
-    DB_ASSERT(buf_ptr && "db_release: buf_ptr cannot be NULL");
-    if (!*buf_ptr) return;
+size_t db_builder_capacity(db_builder builder) {
+    DB_ASSERT(builder && "db_builder_capacity: builder cannot be NULL");
+    return builder->capacity;
+}
+
+void db_builder_clear(db_builder builder) {
+    DB_ASSERT(builder && "db_builder_clear: builder cannot be NULL");
     
-    db_buffer buf = *buf_ptr;
-    *buf_ptr = NULL;
+    db_internal* meta = db_meta(builder->data);
     
-    if (DB_REFCOUNT_DECREMENT(&db_meta(buf)->refcount) == 0) {
-        // Reference count reached 0, free the buffer
-        db_dealloc(buf);
+    // Nobody else can see the contents, so just rewind. Mapped file pages are
+    // read-only and must not be written over.
+    if (db_refcount(builder->data) <= 1 && (meta->flags & DB_KIND_MASK) != DB_KIND_MAPPED) {
+        meta->size = 0;
+        DB_HASH_RESET(meta);
+        return;
     }
+    
+    // Shared contents stay immutable - start over in a new buffer
+    const db_allocator* allocator = db_buffer_allocator(builder->data);
+    db_release(&builder->data);
+    builder->data = db_new_ex(builder->capacity, allocator);
 }
 
 
-size_t db_size(db_buffer buf) {
-    DB_ASSERT(buf && "db_size: buf cannot be NULL");
-    return db_meta(buf)->size;
+
+int db_builder_append_uint8(db_builder builder, uint8_t value) {
+    DB_ASSERT(builder && "db_builder_append_uint8: builder cannot be NULL");
+    
+    return db_internal_append(&builder->data, &builder->capacity, &value, 1, &builder->policy);
 }
 
-size_t db_capacity(db_buffer buf) {
-    DB_ASSERT(buf && "db_capacity: buf cannot be NULL");
-    return db_meta(buf)->capacity;
+int db_builder_append_uint16_le(db_builder builder, uint16_t value) {
+    DB_ASSERT(builder && "db_builder_append_uint16_le: builder cannot be NULL");
+    
+    uint8_t* out = (uint8_t*)db_internal_reserve(&builder->data, &builder->capacity, 2, &builder->policy);
+    if (!out) return -1;
+    
+    out[0] = (uint8_t)(value & 0xFF);
+    out[1] = (uint8_t)((value >> 8) & 0xFF);
+    db_meta(builder->data)->size += 2;
+    return 0;
 }
 
-bool db_is_empty(db_buffer buf) {
-    DB_ASSERT(buf && "db_is_empty: buf cannot be NULL");
-    return db_meta(buf)->size == 0;
+int db_builder_append_uint16_be(db_builder builder, uint16_t value) {
+    DB_ASSERT(builder && "db_builder_append_uint16_be: builder cannot be NULL");
+    
+    uint8_t* out = (uint8_t*)db_internal_reserve(&builder->data, &builder->capacity, 2, &builder->policy);
+    if (!out) return -1;
+    
+    out[0] = (uint8_t)((value >> 8) & 0xFF);
+    out[1] = (uint8_t)(value & 0xFF);
+    db_meta(builder->data)->size += 2;
+    return 0;
 }
 
-int db_refcount(db_buffer buf) {
-    DB_ASSERT(buf && "db_refcount: buf cannot be NULL");
-    return DB_REFCOUNT_LOAD(&db_meta(buf)->refcount);
+int db_builder_append_uint32_le(db_builder builder, uint32_t value) {
+    DB_ASSERT(builder && "db_builder_append_uint32_le: builder cannot be NULL");
+    
+    uint8_t* out = (uint8_t*)db_internal_reserve(&builder->data, &builder->capacity, 4, &builder->policy);
+    if (!out) return -1;
+    
+    out[0] = (uint8_t)(value & 0xFF);
+    out[1] = (uint8_t)((value >> 8) & 0xFF);
+    out[2] = (uint8_t)((value >> 16) & 0xFF);
+    out[3] = (uint8_t)((value >> 24) & 0xFF);
+    db_meta(builder->data)->size += 4;
+    return 0;
 }
 
-db_buffer db_slice(db_buffer buf, size_t offset, size_t length) {
-    DB_ASSERT(buf && "db_slice: buf cannot be NULL");
+int db_builder_append_uint32_be(db_builder builder, uint32_t value) {
+    DB_ASSERT(builder && "db_builder_append_uint32_be: builder cannot be NULL");
     
-    size_t buf_size = db_meta(buf)->size;
-    if (offset > buf_size || offset + length > buf_size) {
-        return NULL; // Invalid bounds
+    uint8_t* out = (uint8_t*)db_internal_reserve(&builder->data, &builder->capacity, 4, &builder->policy);
+    if (!out) return -1;
+    
+    out[0] = (uint8_t)((value >> 24) & 0xFF);
+    out[1] = (uint8_t)((value >> 16) & 0xFF);
+    out[2] = (uint8_t)((value >> 8) & 0xFF);
+    out[3] = (uint8_t)(value & 0xFF);
+    db_meta(builder->data)->size += 4;
+    return 0;
+}
+
+int db_builder_append_uint64_le(db_builder builder, uint64_t value) {
+    DB_ASSERT(builder && "db_builder_append_uint64_le: builder cannot be NULL");
+    
+    uint8_t* out = (uint8_t*)db_internal_reserve(&builder->data, &builder->capacity, 8, &builder->policy);
+    if (!out) return -1;
+    
+    out[0] = (uint8_t)(value & 0xFF);
+    out[1] = (uint8_t)((value >> 8) & 0xFF);
+    out[2] = (uint8_t)((value >> 16) & 0xFF);
+    out[3] = (uint8_t)((value >> 24) & 0xFF);
+    out[4] = (uint8_t)((value >> 32) & 0xFF);
+    out[5] = (uint8_t)((value >> 40) & 0xFF);
+    out[6] = (uint8_t)((value >> 48) & 0xFF);
+    out[7] = (uint8_t)((value >> 56) & 0xFF);
+    db_meta(builder->data)->size += 8;
+    return 0;
+}
+
+int db_builder_append_uint64_be(db_builder builder, uint64_t value) {
+    DB_ASSERT(builder && "db_builder_append_uint64_be: builder cannot be NULL");
+    
+    uint8_t* out = (uint8_t*)db_internal_reserve(&builder->data, &builder->capacity, 8, &builder->policy);
+    if (!out) return -1;
+    
+    out[0] = (uint8_t)((value >> 56) & 0xFF);
+    out[1] = (uint8_t)((value >> 48) & 0xFF);
+    out[2] = (uint8_t)((value >> 40) & 0xFF);
+    out[3] = (uint8_t)((value >> 32) & 0xFF);
+    out[4] = (uint8_t)((value >> 24) & 0xFF);
+    out[5] = (uint8_t)((value >> 16) & 0xFF);
+    out[6] = (uint8_t)((value >> 8) & 0xFF);
+    out[7] = (uint8_t)(value & 0xFF);
+    db_meta(builder->data)->size += 8;
+    return 0;
+}
+
+int db_builder_append(db_builder builder, const void* data, size_t size) {
+    DB_ASSERT(builder && "db_builder_append: builder cannot be NULL");
+    DB_ASSERT((data || size == 0) && "db_builder_append: data cannot be NULL when size > 0");
+    
+    if (size == 0) return 0;
+    
+    return db_internal_append(&builder->data, &builder->capacity, data, size, &builder->policy);
+}
+
+int db_builder_append_cstring(db_builder builder, const char* str) {
+    DB_ASSERT(builder && "db_builder_append_cstring: builder cannot be NULL");
+    DB_ASSERT(str && "db_builder_append_cstring: str cannot be NULL");
+    
+    size_t len = strlen(str);
+    return db_builder_append(builder, str, len);
+}
+
+int db_builder_append_buffer(db_builder builder, db_buffer buf) {
+    DB_ASSERT(builder && "db_builder_append_buffer: builder cannot be NULL");
+    DB_ASSERT(buf && "db_builder_append_buffer: buf cannot be NULL");
+    
+    return db_builder_append(builder, buf, db_size(buf));
+}
+
+void* db_builder_reserve(db_builder builder, size_t size) {
+    DB_ASSERT(builder && "db_builder_reserve: builder cannot be NULL");
+    
+    return db_internal_reserve(&builder->data, &builder->capacity, size, &builder->policy);
+}
+
+int db_builder_commit(db_builder builder, size_t size) {
+    DB_ASSERT(builder && "db_builder_commit: builder cannot be NULL");
+    
+    db_internal* meta = db_meta(builder->data);
+    if (size > builder->capacity - meta->size) {
+        return -1; // More than the reserved tail
     }
     
-    // Create an independent copy of the slice data
-    db_buffer slice = db_alloc(length);
-    // db_alloc now asserts on allocation failure
+    meta->size += size;
+    return 0;
+}
+
+int db_builder_append_varint_u64(db_builder builder, uint64_t value) {
+    DB_ASSERT(builder && "db_builder_append_varint_u64: builder cannot be NULL");
     
-    // Copy the slice data directly from the source buffer
-    if (length > 0) {
-        memcpy(slice, buf + offset, length);
-        db_meta(slice)->size = length;
+    size_t length = 1;
+    for (uint64_t rest = value >> 7; rest; rest >>= 7) length++;
+    
+    uint8_t* out = (uint8_t*)db_internal_reserve(&builder->data, &builder->capacity, length, &builder->policy);
+    if (!out) return -1;
+    
+    for (size_t i = 0; i + 1 < length; i++) {
+        out[i] = (uint8_t)(value | 0x80);
+        value >>= 7;
     }
+    out[length - 1] = (uint8_t)value;
     
-    return slice;
+    db_meta(builder->data)->size += length;
+    return 0;
 }
 
-db_buffer db_slice_from(db_buffer buf, size_t offset) {
-    DB_ASSERT(buf && "db_slice_from: buf cannot be NULL");
-    size_t buf_size = db_meta(buf)->size;
-    if (offset > buf_size) return NULL;
-    return db_slice(buf, offset, buf_size - offset);
+int db_builder_append_varint_s64(db_builder builder, int64_t value) {
+    DB_ASSERT(builder && "db_builder_append_varint_s64: builder cannot be NULL");
+    
+    uint64_t zigzag = ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+    return db_builder_append_varint_u64(builder, zigzag);
 }
 
-db_buffer db_slice_to(db_buffer buf, size_t length) {
-    DB_ASSERT(buf && "db_slice_to: buf cannot be NULL");
-    if (length > db_meta(buf)->size) return NULL;
-    return db_slice(buf, 0, length);
+int db_builder_append_base64(db_builder builder, db_base64_stream* stream, const void* data, size_t size) {
+    DB_ASSERT(builder && "db_builder_append_base64: builder cannot be NULL");
+    DB_ASSERT((data || size == 0) && "db_builder_append_base64: data cannot be NULL when size > 0");
+    
+    if (!stream) {
+        // One complete message: encode and flush in a single step
+        db_base64_stream message = DB_BASE64_STREAM_INIT(DB_BASE64_STANDARD);
+        if (db_builder_append_base64(builder, &message, data, size) != 0) return -1;
+        return db_builder_flush_base64(builder, &message);
+    }
+    
+    const uint8_t* src = (const uint8_t*)data;
+    if (stream->pending_size > 0) {
+        // Complete the group left over from the previous call
+        while (stream->pending_size < 2 && size > 0) {
+            stream->pending[stream->pending_size++] = *src++;
+            size--;
+        }
+        if (size == 0) return 0;
+        
+        uint8_t group[3] = { stream->pending[0], stream->pending[1], *src++ };
+        size--;
+        char* tail = db_internal_reserve(&builder->data, &builder->capacity, 4, &builder->policy);
+        if (!tail) return -1;
+        db_base64_encode_groups(group, 3, tail, stream->alphabet);
+        db_meta(builder->data)->size += 4;
+        stream->pending_size = 0;
+    }
+    
+    size_t whole = size - size % 3;
+    if (whole > 0) {
+        if (whole / 3 > SIZE_MAX / 4) return -1;
+        char* tail = db_internal_reserve(&builder->data, &builder->capacity, whole / 3 * 4, &builder->policy);
+        if (!tail) return -1;
+        db_base64_encode_groups(src, whole, tail, stream->alphabet);
+        db_meta(builder->data)->size += whole / 3 * 4;
+    }
+    
+    for (size_t i = whole; i < size; i++) {
+        stream->pending[stream->pending_size++] = src[i];
+    }
+    return 0;
+}
+
+int db_builder_flush_base64(db_builder builder, db_base64_stream* stream) {
+    DB_ASSERT(builder && "db_builder_flush_base64: builder cannot be NULL");
+    DB_ASSERT(stream && "db_builder_flush_base64: stream cannot be NULL");
+    
+    if (stream->pending_size == 0) return 0;
+    
+    char* tail = db_internal_reserve(&builder->data, &builder->capacity, 4, &builder->policy);
+    if (!tail) return -1;
+    db_meta(builder->data)->size += db_base64_encode_tail(stream->pending, stream->pending_size, tail,
+                                                          stream->alphabet);
+    stream->pending_size = 0;
+    return 0;
 }
 
+int db_builder_append_uint16_le_array(db_builder builder, const uint16_t* values, size_t count) {
+    DB_ASSERT(builder && "db_builder_append_uint16_le_array: builder cannot be NULL");
+    DB_ASSERT((values || count == 0) && "db_builder_append_uint16_le_array: values cannot be NULL when count > 0");
+    
+    if (count > SIZE_MAX / 2) return -1;
+    char* out = db_internal_reserve(&builder->data, &builder->capacity, count * 2, &builder->policy);
+    if (!out) return -1;
+    
+    db_copy_elements(out, values, count, 2, !DB_LITTLE_ENDIAN);
+    db_meta(builder->data)->size += count * 2;
+    return 0;
+}
 
+int db_builder_append_uint16_be_array(db_builder builder, const uint16_t* values, size_t count) {
+    DB_ASSERT(builder && "db_builder_append_uint16_be_array: builder cannot be NULL");
+    DB_ASSERT((values || count == 0) && "db_builder_append_uint16_be_array: values cannot be NULL when count > 0");
+    
+    if (count > SIZE_MAX / 2) return -1;
+    char* out = db_internal_reserve(&builder->data, &builder->capacity, count * 2, &builder->policy);
+    if (!out) return -1;
+    
+    db_copy_elements(out, values, count, 2, DB_LITTLE_ENDIAN);
+    db_meta(builder->data)->size += count * 2;
+    return 0;
+}
 
-db_buffer db_append(db_buffer buf, const void* data, size_t size) {
-    DB_ASSERT(buf && "db_append: buf cannot be NULL");
-    DB_ASSERT((data || size == 0) && "db_append: data cannot be NULL when size > 0");
+int db_builder_append_uint32_le_array(db_builder builder, const uint32_t* values, size_t count) {
+    DB_ASSERT(builder && "db_builder_append_uint32_le_array: builder cannot be NULL");
+    DB_ASSERT((values || count == 0) && "db_builder_append_uint32_le_array: values cannot be NULL when count > 0");
+    
+    if (count > SIZE_MAX / 4) return -1;
+    char* out = db_internal_reserve(&builder->data, &builder->capacity, count * 4, &builder->policy);
+    if (!out) return -1;
+    
+    db_copy_elements(out, values, count, 4, !DB_LITTLE_ENDIAN);
+    db_meta(builder->data)->size += count * 4;
+    return 0;
+}
+
+int db_builder_append_uint32_be_array(db_builder builder, const uint32_t* values, size_t count) {
+    DB_ASSERT(builder && "db_builder_append_uint32_be_array: builder cannot be NULL");
+    DB_ASSERT((values || count == 0) && "db_builder_append_uint32_be_array: values cannot be NULL when count > 0");
+    
+    if (count > SIZE_MAX / 4) return -1;
+    char* out = db_internal_reserve(&builder->data, &builder->capacity, count * 4, &builder->policy);
+    if (!out) return -1;
+    
+    db_copy_elements(out, values, count, 4, DB_LITTLE_ENDIAN);
+    db_meta(builder->data)->size += count * 4;
+    return 0;
+}
+
+int db_builder_append_uint64_le_array(db_builder builder, const uint64_t* values, size_t count) {
+    DB_ASSERT(builder && "db_builder_append_uint64_le_array: builder cannot be NULL");
+    DB_ASSERT((values || count == 0) && "db_builder_append_uint64_le_array: values cannot be NULL when count > 0");
+    
+    if (count > SIZE_MAX / 8) return -1;
+    char* out = db_internal_reserve(&builder->data, &builder->capacity, count * 8, &builder->policy);
+    if (!out) return -1;
+    
+    db_copy_elements(out, values, count, 8, !DB_LITTLE_ENDIAN);
+    db_meta(builder->data)->size += count * 8;
+    return 0;
+}
+
+int db_builder_append_uint64_be_array(db_builder builder, const uint64_t* values, size_t count) {
+    DB_ASSERT(builder && "db_builder_append_uint64_be_array: builder cannot be NULL");
+    DB_ASSERT((values || count == 0) && "db_builder_append_uint64_be_array: values cannot be NULL when count > 0");
+    
+    if (count > SIZE_MAX / 8) return -1;
+    char* out = db_internal_reserve(&builder->data, &builder->capacity, count * 8, &builder->policy);
+    if (!out) return -1;
+    
+    db_copy_elements(out, values, count, 8, DB_LITTLE_ENDIAN);
+    db_meta(builder->data)->size += count * 8;
+    return 0;
+}
+
+ssize_t db_builder_readv(db_builder builder, int fd, size_t max_bytes) {
+    DB_ASSERT(builder && "db_builder_readv: builder cannot be NULL");
+    DB_ASSERT(fd >= 0 && "db_builder_readv: invalid file descriptor");
+    
+    if (db_internal_ensure_unique(&builder->data) != 0) return -1;
+    builder->capacity = db_meta(builder->data)->capacity;
+    
+    size_t current_size = db_meta(builder->data)->size;
+    size_t spare = builder->capacity - current_size;
+    
+#ifdef _WIN32
+    // No readv - make sure there's room and read straight into the tail
+    size_t read_size = max_bytes ? max_bytes : (spare ? spare : DB_READV_CHUNK_SIZE);
+    if (db_internal_ensure_capacity(&builder->data, &builder->capacity, current_size + read_size, &builder->policy) != 0) {
+        return -1;
+    }
+    ssize_t bytes_read = db_read(fd, builder->data + current_size, (unsigned int)read_size);
+    if (bytes_read > 0) {
+        db_meta(builder->data)->size = current_size + (size_t)bytes_read;
+    }
+    return bytes_read;
+#else
+    struct iovec iov[2];
+    size_t tail_len = spare;
+    size_t chunk_len = DB_READV_CHUNK_SIZE;
+    
+    if (max_bytes) {
+        if (tail_len > max_bytes) tail_len = max_bytes;
+        chunk_len = max_bytes - tail_len;
+        if (chunk_len > DB_READV_CHUNK_SIZE) chunk_len = DB_READV_CHUNK_SIZE;
+    }
+    
+    if (chunk_len > 0 && !builder->readv_chunk) {
+        builder->readv_chunk = (char*)DB_MALLOC(DB_READV_CHUNK_SIZE);
+        if (!builder->readv_chunk) {
+            if (tail_len == 0) return -1;
+            chunk_len = 0;  // Read into the spare capacity only
+        }
+    }
+    char* chunk = builder->readv_chunk;
     
-    if (size == 0) {
-        return db_retain(buf);  // Return retained original if nothing to append
+    int iovcnt = 0;
+    if (tail_len > 0) {
+        iov[iovcnt].iov_base = builder->data + current_size;
+        iov[iovcnt].iov_len = tail_len;
+        iovcnt++;
+    }
+    if (chunk_len > 0) {
+        iov[iovcnt].iov_base = chunk;
+        iov[iovcnt].iov_len = chunk_len;
+        iovcnt++;
     }
     
-    size_t old_size = db_meta(buf)->size;
-    size_t new_size = old_size + size;
-    db_buffer result = db_new(new_size);
-    // db_new now asserts on allocation failure
+    ssize_t bytes_read = readv(fd, iov, iovcnt);
+    if (bytes_read <= 0) return bytes_read;
     
-    // Copy original buffer
-    if (old_size > 0) {
-        memcpy(result, buf, old_size);
-    }
-    // Append new data
-    memcpy(result + old_size, data, size);
+    size_t in_tail = (size_t)bytes_read < tail_len ? (size_t)bytes_read : tail_len;
+    db_meta(builder->data)->size = current_size + in_tail;
     
-    // Set the final size
-    db_meta(result)->size = new_size;
+    // Whatever didn't fit is appended from the chunk (grows the builder)
+    if ((size_t)bytes_read > in_tail) {
+        if (db_internal_append(&builder->data, &builder->capacity, chunk, (size_t)bytes_read - in_tail, &builder->policy) != 0) {
+            return -1;
+        }
+    }
     
-    return result;
+    return bytes_read;
+#endif
 }
 
-// Internal helper functions for builder (similar to ds_stringbuilder helpers)
+// Reader implementation
 
-/**
- * @brief Internal function to ensure buffer has exclusive access
- * @param builder_data Pointer to builder's data pointer
- * @return 0 on success, -1 on failure
- */
-static int db_internal_ensure_unique(db_buffer* builder_data) {
-    if (!*builder_data) return -1;
+db_reader db_reader_new(db_buffer buf) {
+    DB_ASSERT(buf && "db_reader_new: buf cannot be NULL");
     
-    if (db_refcount(*builder_data) <= 1) {
-        return 0; // Already unique
+    return db_reader_new_range(buf, 0, db_meta(buf)->size);
+}
+
+db_reader db_reader_new_range(db_buffer buf, size_t offset, size_t length) {
+    DB_ASSERT(buf && "db_reader_new_range: buf cannot be NULL");
+    
+    size_t buf_size = db_meta(buf)->size;
+    if (offset > buf_size || length > buf_size - offset) {
+        return NULL; // Invalid bounds
     }
     
-    // Need to create our own copy
-    size_t current_size = db_size(*builder_data);
-    db_buffer new_buf = db_new_with_data(*builder_data, current_size);
-    // db_new_with_data now asserts on allocation failure
+    struct db_reader_internal* reader = (struct db_reader_internal*)DB_MALLOC(sizeof(struct db_reader_internal));
+    DB_ASSERT(reader && "db_reader_new_range: memory allocation failed");
     
-    db_release(builder_data);
-    *builder_data = new_buf;
-    return 0;
+    reader->refcount = DB_REFCOUNT_INIT(1);
+    reader->buf = db_retain(buf);  // Keep a reference to the buffer
+    reader->data = buf + offset;   // Read the range in place, no copy
+    reader->size = length;
+    reader->position = 0;
+    
+    return reader;
 }
 
-/**
- * @brief Internal function to ensure buffer has enough capacity
- * @param builder_data Pointer to builder's data pointer  
- * @param builder_capacity Pointer to builder's capacity
- * @param required_capacity Required capacity in bytes
- * @return 0 on success, -1 on failure
- */
-static int db_internal_ensure_capacity(db_buffer* builder_data, size_t* builder_capacity, size_t required_capacity) {
-    if (*builder_capacity >= required_capacity) {
-        return 0; // Already have enough capacity
-    }
+db_reader db_reader_retain(db_reader reader) {
+    DB_ASSERT(reader && "db_reader_retain: reader cannot be NULL");
+    DB_REFCOUNT_RETAIN(&reader->refcount);
+    return reader;
+}
+
+void db_reader_release(db_reader* reader_ptr) {
+    DB_ASSERT(reader_ptr && "db_reader_release: reader_ptr cannot be NULL");
+    if (!*reader_ptr) return;
     
-    size_t new_capacity = *builder_capacity;
-    if (new_capacity == 0) {
-        new_capacity = 16; // Initial capacity
-    }
+    db_reader reader = *reader_ptr;
+    *reader_ptr = NULL;
     
-    while (new_capacity < required_capacity) {
-        new_capacity *= 2; // Double the capacity
+    if (DB_REFCOUNT_DECREMENT(&reader->refcount) == 0) {
+        // Reference count reached 0, free the reader and release buffer
+        db_release(&reader->buf);
+        DB_FREE(reader);
     }
+}
+
+void db_reader_free(db_reader* reader_ptr) {
+    // Legacy function - just call the new release function
+    db_reader_release(reader_ptr);
+}
+
+size_t db_reader_position(db_reader reader) {
+    DB_ASSERT(reader && "reader cannot be NULL");
+    return reader->position;
+}
+
+size_t db_reader_remaining(db_reader reader) {
+    DB_ASSERT(reader && "reader cannot be NULL");
+    return (reader->position < reader->size) ? (reader->size - reader->position) : 0;
+}
+
+bool db_reader_can_read(db_reader reader, size_t bytes) {
+    DB_ASSERT(reader && "reader cannot be NULL");
+    return db_reader_remaining(reader) >= bytes;
+}
+
+void db_reader_seek(db_reader reader, size_t position) {
+    DB_ASSERT(reader && "reader cannot be NULL");
+    DB_ASSERT(position <= reader->size && "db_reader_seek: cannot seek past buffer end");
+    reader->position = position;
+}
+
+db_cursor db_cursor_from_buffer(db_buffer buf) {
+    DB_ASSERT(buf && "db_cursor_from_buffer: buf cannot be NULL");
     
-    // Use realloc for efficient buffer growth
-    db_internal* meta = db_meta(*builder_data);
+    db_cursor c;
+    c.begin = (const uint8_t*)buf;
+    c.cur = c.begin;
+    c.end = c.begin + db_meta(buf)->size;
+    return c;
+}
+
+db_cursor db_reader_cursor(db_reader reader) {
+    DB_ASSERT(reader && "reader cannot be NULL");
     
-    // Calculate new block size (metadata + data)
-    size_t new_block_size = sizeof(db_internal) + new_capacity;
+    db_cursor c;
+    c.begin = (const uint8_t*)reader->data;
+    c.cur = c.begin + reader->position;
+    c.end = c.begin + reader->size;
+    return c;
+}
+
+const void* db_reader_peek(db_reader reader, size_t size) {
+    DB_ASSERT(reader && "reader cannot be NULL");
     
-    // Realloc the entire block (metadata + data)
-    db_internal* new_meta = (db_internal*)DB_REALLOC(meta, new_block_size);
-    DB_ASSERT(new_meta && "db_internal_ensure_capacity: memory reallocation failed");
+    if (!db_reader_can_read(reader, size)) return NULL;
+    return reader->data + reader->position;
+}
+
+const void* db_read_borrow(db_reader reader, size_t size) {
+    DB_ASSERT(reader && "reader cannot be NULL");
     
-    // Update capacity (size remains the same)
-    new_meta->capacity = new_capacity;
+    if (!db_reader_can_read(reader, size)) return NULL;
+    const char* field = reader->data + reader->position;
+    reader->position += size;
+    return field;
+}
+
+db_buffer db_read_slice(db_reader reader, size_t size) {
+    DB_ASSERT(reader && "reader cannot be NULL");
     
-    // Update the buffer pointer to point to data portion
-    *builder_data = (db_buffer)((char*)new_meta + sizeof(db_internal));
-    *builder_capacity = new_capacity;
-    return 0;
+    if (!db_reader_can_read(reader, size)) return NULL;
+    size_t offset = (size_t)(reader->data - reader->buf) + reader->position;
+    db_buffer slice = db_slice(reader->buf, offset, size);
+    reader->position += size;
+    return slice;
 }
 
-/**
- * @brief Internal function to append data to builder buffer (mutable)
- * @param builder_data Pointer to builder's data pointer
- * @param builder_capacity Pointer to builder's capacity
- * @param data Data to append
- * @param size Size of data to append
- * @return 0 on success, -1 on failure
- */
-static int db_internal_append(db_buffer* builder_data, size_t* builder_capacity, const void* data, size_t size) {
-    if (size == 0) return 0;
+uint8_t db_read_uint8(db_reader reader) {
+    DB_ASSERT(reader && "reader cannot be NULL");
+    DB_ASSERT(db_reader_can_read(reader, 1) && "db_read_uint8: insufficient data available");
     
-    if (db_internal_ensure_unique(builder_data) != 0) {
-        return -1;
-    }
+    uint8_t value = *(uint8_t*)(reader->data + reader->position);
+    reader->position += 1;
     
-    size_t current_size = db_size(*builder_data);
-    size_t needed_capacity = current_size + size;
+    return value;
+}
+
+uint16_t db_read_uint16_le(db_reader reader) {
+    DB_ASSERT(reader && "reader cannot be NULL");
+    DB_ASSERT(db_reader_can_read(reader, 2) && "insufficient data available");
     
-    if (db_internal_ensure_capacity(builder_data, builder_capacity, needed_capacity) != 0) {
-        return -1;
-    }
+    const uint8_t* ptr = (const uint8_t*)(reader->data + reader->position);
+    uint16_t value = (uint16_t)ptr[0] | ((uint16_t)ptr[1] << 8);
+    reader->position += 2;
     
-    // Append the data
-    memcpy(*builder_data + current_size, data, size);
-    db_meta(*builder_data)->size = current_size + size;
+    return value;
+}
+
+uint16_t db_read_uint16_be(db_reader reader) {
+    DB_ASSERT(reader && "reader cannot be NULL");
+    DB_ASSERT(db_reader_can_read(reader, 2) && "insufficient data available");
     
-    return 0;
+    const uint8_t* ptr = (const uint8_t*)(reader->data + reader->position);
+    uint16_t value = ((uint16_t)ptr[0] << 8) | (uint16_t)ptr[1];
+    reader->position += 2;
+    
+    return value;
 }
 
-db_buffer db_concat(db_buffer buf1, db_buffer buf2) {
-    DB_ASSERT(buf1 && "db_concat: buf1 cannot be NULL");
-    DB_ASSERT(buf2 && "db_concat: buf2 cannot be NULL");
+uint32_t db_read_uint32_le(db_reader reader) {
+    DB_ASSERT(reader && "reader cannot be NULL");
+    DB_ASSERT(db_reader_can_read(reader, 4) && "insufficient data available");
     
-    size_t size1 = db_meta(buf1)->size;
-    size_t size2 = db_meta(buf2)->size;
-    size_t total_size = size1 + size2;
+    const uint8_t* ptr = (const uint8_t*)(reader->data + reader->position);
+    uint32_t value = (uint32_t)ptr[0] | 
+                    ((uint32_t)ptr[1] << 8) | 
+                    ((uint32_t)ptr[2] << 16) | 
+                    ((uint32_t)ptr[3] << 24);
+    reader->position += 4;
     
-    if (total_size == 0) return db_new(0);
+    return value;
+}
+
+uint32_t db_read_uint32_be(db_reader reader) {
+    DB_ASSERT(reader && "reader cannot be NULL");
+    DB_ASSERT(db_reader_can_read(reader, 4) && "insufficient data available");
     
-    db_buffer result = db_new(total_size);
-    // db_new now asserts on allocation failure
+    const uint8_t* ptr = (const uint8_t*)(reader->data + reader->position);
+    uint32_t value = ((uint32_t)ptr[0] << 24) | 
+                    ((uint32_t)ptr[1] << 16) | 
+                    ((uint32_t)ptr[2] << 8) | 
+                    (uint32_t)ptr[3];
+    reader->position += 4;
     
-    if (size1 > 0) {
-        memcpy(result, buf1, size1);
-    }
+    return value;
+}
+
+uint64_t db_read_uint64_le(db_reader reader) {
+    DB_ASSERT(reader && "reader cannot be NULL");
+    DB_ASSERT(db_reader_can_read(reader, 8) && "insufficient data available");
     
-    if (size2 > 0) {
-        memcpy(result + size1, buf2, size2);
-    }
+    const uint8_t* ptr = (const uint8_t*)(reader->data + reader->position);
+    uint64_t value = (uint64_t)ptr[0] | 
+                    ((uint64_t)ptr[1] << 8) | 
+                    ((uint64_t)ptr[2] << 16) | 
+                    ((uint64_t)ptr[3] << 24) |
+                    ((uint64_t)ptr[4] << 32) | 
+                    ((uint64_t)ptr[5] << 40) | 
+                    ((uint64_t)ptr[6] << 48) | 
+                    ((uint64_t)ptr[7] << 56);
+    reader->position += 8;
     
-    db_meta(result)->size = total_size;
-    return result;
+    return value;
 }
 
-db_buffer db_concat_many(db_buffer* buffers, size_t count) {
-    if (!buffers || count == 0) return db_new(0);
+uint64_t db_read_uint64_be(db_reader reader) {
+    DB_ASSERT(reader && "reader cannot be NULL");
+    DB_ASSERT(db_reader_can_read(reader, 8) && "insufficient data available");
     
-    // Calculate total size
-    size_t total_size = 0;
-    for (size_t i = 0; i < count; i++) {
-        if (buffers[i]) {
-            total_size += db_meta(buffers[i])->size;
-        }
-    }
+    const uint8_t* ptr = (const uint8_t*)(reader->data + reader->position);
+    uint64_t value = ((uint64_t)ptr[0] << 56) | 
+                    ((uint64_t)ptr[1] << 48) | 
+                    ((uint64_t)ptr[2] << 40) | 
+                    ((uint64_t)ptr[3] << 32) |
+                    ((uint64_t)ptr[4] << 24) | 
+                    ((uint64_t)ptr[5] << 16) | 
+                    ((uint64_t)ptr[6] << 8) | 
+                    (uint64_t)ptr[7];
+    reader->position += 8;
     
-    db_buffer result = db_new(total_size);
-    // db_new now asserts on allocation failure
+    return value;
+}
+
+void db_read_bytes(db_reader reader, void* data, size_t size) {
+    DB_ASSERT(reader && "reader cannot be NULL");
+    DB_ASSERT((data || size == 0) && "db_read_bytes: data cannot be NULL when size > 0");
+    DB_ASSERT(db_reader_can_read(reader, size) && "db_read_bytes: insufficient data available");
     
-    size_t offset = 0;
-    for (size_t i = 0; i < count; i++) {
-        if (buffers[i]) {
-            size_t size = db_meta(buffers[i])->size;
-            if (size > 0) {
-                memcpy(result + offset, buffers[i], size);
-                offset += size;
-            }
-        }
+    if (size > 0) {
+        memcpy(data, reader->data + reader->position, size);
+        reader->position += size;
     }
-    
-    db_meta(result)->size = total_size;
-    return result;
 }
 
-bool db_equals(db_buffer buf1, db_buffer buf2) {
-    DB_ASSERT(buf1 && "db_equals: buf1 cannot be NULL");
-    DB_ASSERT(buf2 && "db_equals: buf2 cannot be NULL");
-    
-    if (buf1 == buf2) return true;
-    
-    size_t size1 = db_meta(buf1)->size;
-    size_t size2 = db_meta(buf2)->size;
-    if (size1 != size2) return false;
+void db_read_uint16_le_array(db_reader reader, uint16_t* values, size_t count) {
+    DB_ASSERT(reader && "reader cannot be NULL");
+    DB_ASSERT((values || count == 0) && "db_read_uint16_le_array: values cannot be NULL when count > 0");
+    DB_ASSERT(count <= SIZE_MAX / 2 && db_reader_can_read(reader, count * 2) &&
+              "db_read_uint16_le_array: insufficient data available");
     
-    return memcmp(buf1, buf2, size1) == 0;
+    db_copy_elements(values, reader->data + reader->position, count, 2, !DB_LITTLE_ENDIAN);
+    reader->position += count * 2;
 }
 
-int db_compare(db_buffer buf1, db_buffer buf2) {
-    DB_ASSERT(buf1 && "db_compare: buf1 cannot be NULL");
-    DB_ASSERT(buf2 && "db_compare: buf2 cannot be NULL");
-    
-    if (buf1 == buf2) return 0;
-    
-    size_t size1 = db_meta(buf1)->size;
-    size_t size2 = db_meta(buf2)->size;
-    size_t min_size = size1 < size2 ? size1 : size2;
-    
-    int result = memcmp(buf1, buf2, min_size);
-    
-    if (result != 0) return result;
+void db_read_uint16_be_array(db_reader reader, uint16_t* values, size_t count) {
+    DB_ASSERT(reader && "reader cannot be NULL");
+    DB_ASSERT((values || count == 0) && "db_read_uint16_be_array: values cannot be NULL when count > 0");
+    DB_ASSERT(count <= SIZE_MAX / 2 && db_reader_can_read(reader, count * 2) &&
+              "db_read_uint16_be_array: insufficient data available");
     
-    // Contents are equal up to min_size, compare sizes
-    if (size1 < size2) return -1;
-    if (size1 > size2) return 1;
-    return 0;
+    db_copy_elements(values, reader->data + reader->position, count, 2, DB_LITTLE_ENDIAN);
+    reader->position += count * 2;
 }
 
-// I/O operations - basic implementation
-#ifdef _WIN32
-#include <io.h>
-#define db_read read
-#define db_write write
-#else
-#include <unistd.h>
-#define db_read read  
-#define db_write write
-#endif
-
-ssize_t db_read_fd(db_buffer* buf_ptr, int fd, size_t max_bytes) {
-    DB_ASSERT(buf_ptr && *buf_ptr && "db_read_fd: buf_ptr and *buf_ptr cannot be NULL");
-    DB_ASSERT(fd >= 0 && "db_read_fd: invalid file descriptor");
-    
-    // Read data into a temporary buffer first
-    size_t read_size = max_bytes == 0 ? 4096 : max_bytes;
-    char* temp_buffer = (char*)DB_MALLOC(read_size);
-    DB_ASSERT(temp_buffer && "db_read_fd: memory allocation failed");
-    
-    ssize_t bytes_read = db_read(fd, temp_buffer, read_size);
-    if (bytes_read > 0) {
-        // Create new buffer with appended data (immutable operation)
-        db_buffer new_buf = db_append(*buf_ptr, temp_buffer, bytes_read);
-        if (new_buf) {
-            db_release(buf_ptr);  // Release old buffer
-            *buf_ptr = new_buf;   // Update with new buffer
-        } else {
-            bytes_read = -1;  // Failed to append
-        }
-    }
+void db_read_uint32_le_array(db_reader reader, uint32_t* values, size_t count) {
+    DB_ASSERT(reader && "reader cannot be NULL");
+    DB_ASSERT((values || count == 0) && "db_read_uint32_le_array: values cannot be NULL when count > 0");
+    DB_ASSERT(count <= SIZE_MAX / 4 && db_reader_can_read(reader, count * 4) &&
+              "db_read_uint32_le_array: insufficient data available");
     
-    DB_FREE(temp_buffer);
-    return bytes_read;
+    db_copy_elements(values, reader->data + reader->position, count, 4, !DB_LITTLE_ENDIAN);
+    reader->position += count * 4;
 }
 
-ssize_t db_write_fd(db_buffer buf, int fd) {
-    DB_ASSERT(buf && "db_write_fd: buf cannot be NULL");
-    DB_ASSERT(fd >= 0 && "db_write_fd: invalid file descriptor");
-    size_t size = db_meta(buf)->size;
-    if (size == 0) return 0;
+void db_read_uint32_be_array(db_reader reader, uint32_t* values, size_t count) {
+    DB_ASSERT(reader && "reader cannot be NULL");
+    DB_ASSERT((values || count == 0) && "db_read_uint32_be_array: values cannot be NULL when count > 0");
+    DB_ASSERT(count <= SIZE_MAX / 4 && db_reader_can_read(reader, count * 4) &&
+              "db_read_uint32_be_array: insufficient data available");
     
-    return db_write(fd, buf, size);
+    db_copy_elements(values, reader->data + reader->position, count, 4, DB_LITTLE_ENDIAN);
+    reader->position += count * 4;
 }
 
-db_buffer db_read_file(const char* filename) {
-    if (!filename) return NULL; // Allow NULL filename as runtime error
-    
-    FILE* file = fopen(filename, "rb");
-    if (!file) return NULL;
+void db_read_uint64_le_array(db_reader reader, uint64_t* values, size_t count) {
+    DB_ASSERT(reader && "reader cannot be NULL");
+    DB_ASSERT((values || count == 0) && "db_read_uint64_le_array: values cannot be NULL when count > 0");
+    DB_ASSERT(count <= SIZE_MAX / 8 && db_reader_can_read(reader, count * 8) &&
+              "db_read_uint64_le_array: insufficient data available");
     
-    // Get file size
-    fseek(file, 0, SEEK_END);
-    long file_size = ftell(file);
-    fseek(file, 0, SEEK_SET);
+    db_copy_elements(values, reader->data + reader->position, count, 8, !DB_LITTLE_ENDIAN);
+    reader->position += count * 8;
+}
+
+void db_read_uint64_be_array(db_reader reader, uint64_t* values, size_t count) {
+    DB_ASSERT(reader && "reader cannot be NULL");
+    DB_ASSERT((values || count == 0) && "db_read_uint64_be_array: values cannot be NULL when count > 0");
+    DB_ASSERT(count <= SIZE_MAX / 8 && db_reader_can_read(reader, count * 8) &&
+              "db_read_uint64_be_array: insufficient data available");
     
-    if (file_size < 0) {
-        fclose(file);
-        return NULL;
+    db_copy_elements(values, reader->data + reader->position, count, 8, DB_LITTLE_ENDIAN);
+    reader->position += count * 8;
+}
+
+// Varint decoding
+
+/**
+ * @brief Decode a varint from at least 10 readable bytes without bounds checks
+ * @private
+ * @return Encoded length in bytes, or 0 if the varint is malformed
+ */
+static size_t db_varint_decode_fast(const uint8_t* p, uint64_t* value) {
+    uint64_t word = db_load_le64(p);
+    uint64_t stops = ~word & 0x8080808080808080ull;
+    
+    // Gather the 7-bit groups of the first 8 bytes into 56 contiguous bits
+    uint64_t bits = stops ? db_ctz64(stops) + 1 : 64;
+    uint64_t x = (bits == 64 ? word : word & ((1ull << bits) - 1)) & 0x7f7f7f7f7f7f7f7full;
+    x = ((x & 0x7f007f007f007f00ull) >> 1) | (x & 0x007f007f007f007full);
+    x = ((x & 0x3fff00003fff0000ull) >> 2) | (x & 0x00003fff00003fffull);
+    x = ((x & 0x0fffffff00000000ull) >> 4) | (x & 0x000000000fffffffull);
+    
+    if (stops) {
+        *value = x;
+        return (size_t)(bits / 8);
     }
     
-    db_buffer buf = db_new(file_size);
-    if (!buf) {
-        fclose(file);
-        return NULL;
+    // 9 or 10 bytes; the tenth may only carry the top bit
+    if (!(p[8] & 0x80)) {
+        *value = x | ((uint64_t)p[8] << 56);
+        return 9;
     }
-    
-    size_t bytes_read = fread(buf, 1, file_size, file);
-    fclose(file);
-    
-    db_meta(buf)->size = bytes_read;
-    return buf;
+    if (p[9] > 1) return 0;
+    *value = x | ((uint64_t)(p[8] & 0x7f) << 56) | ((uint64_t)p[9] << 63);
+    return 10;
 }
 
-bool db_write_file(db_buffer buf, const char* filename) {
-    DB_ASSERT(buf && "db_write_file: buf cannot be NULL");
-    if (!filename) return false;
-    
-    FILE* file = fopen(filename, "wb");
-    if (!file) return false;
-    
-    bool success = true;
-    size_t size = db_meta(buf)->size;
-    if (size > 0) {
-        size_t written = fwrite(buf, 1, size, file);
-        success = (written == size);
+/**
+ * @brief Decode a varint with bounds checks
+ * @private
+ * @return Encoded length in bytes, or 0 if truncated or malformed
+ */
+static size_t db_varint_decode(const uint8_t* p, size_t available, uint64_t* value) {
+    if (available >= 10) {
+        return db_varint_decode_fast(p, value);
     }
     
-    fclose(file);
-    return success;
+    uint64_t result = 0;
+    for (size_t i = 0; i < available; i++) {
+        uint64_t byte = p[i];
+        result |= (byte & 0x7f) << (7 * i);
+        if (!(byte & 0x80)) {
+            *value = result;
+            return i + 1;
+        }
+    }
+    return 0;
 }
 
-// Utility functions
-db_buffer db_to_hex(db_buffer buf, bool uppercase) {
-    DB_ASSERT(buf && "db_to_hex: buf cannot be NULL");
-    
-    size_t size = db_meta(buf)->size;
-    if (size == 0) return db_new_with_data("", 0);
-    
-    size_t hex_size = size * 2;
-    db_buffer hex_buf = db_new(hex_size);
-    // db_new now asserts on allocation failure
-    
-    const char* hex_chars = uppercase ? "0123456789ABCDEF" : "0123456789abcdef";
-    const uint8_t* data = (const uint8_t*)buf;
-    char* hex_data = hex_buf;
+uint64_t db_read_varint_u64(db_reader reader) {
+    DB_ASSERT(reader && "reader cannot be NULL");
     
-    for (size_t i = 0; i < size; i++) {
-        hex_data[i * 2] = hex_chars[data[i] >> 4];
-        hex_data[i * 2 + 1] = hex_chars[data[i] & 0x0F];
-    }
+    uint64_t value = 0;
+    size_t length = db_varint_decode((const uint8_t*)reader->data + reader->position,
+                                     reader->size - reader->position, &value);
+    DB_ASSERT(length && "db_read_varint_u64: truncated or malformed varint");
+    reader->position += length;
     
-    db_meta(hex_buf)->size = hex_size;
-    return hex_buf;
+    return value;
 }
 
-static int hex_char_to_value(char c) {
-    if (c >= '0' && c <= '9') return c - '0';
-    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
-    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
-    return -1;
+int64_t db_read_varint_s64(db_reader reader) {
+    uint64_t zigzag = db_read_varint_u64(reader);
+    return (int64_t)(zigzag >> 1) ^ -(int64_t)(zigzag & 1);
 }
 
-db_buffer db_from_hex(const char* hex_string, size_t length) {
-    if (!hex_string || length % 2 != 0) return NULL; // Runtime validation
-    
-    size_t byte_length = length / 2;
-    db_buffer buf = db_new(byte_length);
-    // db_new now asserts on allocation failure
+size_t db_read_varints_u64(db_reader reader, uint64_t* values, size_t count) {
+    DB_ASSERT(reader && "reader cannot be NULL");
+    DB_ASSERT((values || count == 0) && "db_read_varints_u64: values cannot be NULL when count > 0");
     
-    uint8_t* data = (uint8_t*)buf;
+    const uint8_t* data = (const uint8_t*)reader->data;
+    size_t position = reader->position;
+    size_t done = 0;
     
-    for (size_t i = 0; i < byte_length; i++) {
-        int high = hex_char_to_value(hex_string[i * 2]);
-        int low = hex_char_to_value(hex_string[i * 2 + 1]);
+    while (done < count) {
+        const uint8_t* p = data + position;
+        size_t available = reader->size - position;
         
-        if (high < 0 || low < 0) {
-            db_release(&buf);
-            return NULL;
+#if DB_SIMD_SSE2
+        // 16 bytes without continuation bits are 16 single-byte varints
+        if (available >= 16 && count - done >= 16 &&
+            _mm_movemask_epi8(_mm_loadu_si128((const __m128i*)p)) == 0) {
+            for (size_t k = 0; k < 16; k++) values[done + k] = p[k];
+            done += 16;
+            position += 16;
+            continue;
+        }
+#endif
+        if (available >= 8 && count - done >= 8 && !(db_load_le64(p) & 0x8080808080808080ull)) {
+            for (size_t k = 0; k < 8; k++) values[done + k] = p[k];
+            done += 8;
+            position += 8;
+            continue;
         }
         
-        data[i] = (uint8_t)((high << 4) | low);
+        size_t length = db_varint_decode(p, available, &values[done]);
+        if (!length) break;
+        done++;
+        position += length;
     }
     
-    db_meta(buf)->size = byte_length;
-    return buf;
+    reader->position = position;
+    return done;
 }
 
-void db_debug_print(db_buffer buf, const char* label) {
-    const char* name = label ? label : "buffer";
+// Chain implementation
+
+struct db_chain_internal {
+    db_refcount_t refcount;  // Reference count for the chain itself
+    db_buffer* segments;     // Ring of retained segments
+    size_t head;             // Ring index of the first segment
+    size_t count;            // Number of segments
+    size_t capacity;         // Ring capacity (power of two)
+    size_t size;             // Total bytes across all segments
+};
+
+static inline db_buffer* db_chain_slot(struct db_chain_internal* chain, size_t index) {
+    return &chain->segments[(chain->head + index) & (chain->capacity - 1)];
+}
+
+/**
+ * @brief Make room for one more segment in the chain's ring
+ * @private
+ */
+static void db_chain_reserve(struct db_chain_internal* chain) {
+    if (chain->count < chain->capacity) return;
     
-    if (!buf) {
-        printf("%s: NULL\n", name);
-        return;
+    size_t new_capacity = chain->capacity ? chain->capacity * 2 : 8;
+    db_buffer* segments = (db_buffer*)DB_MALLOC(new_capacity * sizeof(db_buffer));
+    DB_ASSERT(segments && "db_chain: memory allocation failed");
+    
+    // Unwrap the ring into the new array
+    for (size_t i = 0; i < chain->count; i++) {
+        segments[i] = *db_chain_slot(chain, i);
     }
     
-    db_internal* meta = db_meta(buf);
-    size_t size = meta->size;
-    size_t capacity = meta->capacity;
-    int refcount = DB_REFCOUNT_LOAD(&meta->refcount);
+    DB_FREE(chain->segments);
+    chain->segments = segments;
+    chain->capacity = new_capacity;
+    chain->head = 0;
+}
+
+db_chain db_chain_new(void) {
+    struct db_chain_internal* chain = (struct db_chain_internal*)DB_MALLOC(sizeof(struct db_chain_internal));
+    DB_ASSERT(chain && "db_chain_new: memory allocation failed");
     
-    printf("%s: size=%zu, capacity=%zu, refcount=%d\n",
-           name, size, capacity, refcount);
+    chain->refcount = DB_REFCOUNT_INIT(1);
+    chain->segments = NULL;
+    chain->head = 0;
+    chain->count = 0;
+    chain->capacity = 0;
+    chain->size = 0;
     
-    // Print first few bytes as hex
-    if (size > 0) {
-        printf("  data: ");
-        const uint8_t* data = (const uint8_t*)buf;
-        size_t print_size = size < 16 ? size : 16;
-        
-        for (size_t i = 0; i < print_size; i++) {
-            printf("%02x ", data[i]);
-        }
-        
-        if (size > 16) {
-            printf("... (%zu more bytes)", size - 16);
-        }
-        printf("\n");
-    }
+    return chain;
 }
 
-// Builder and Reader Implementation
-
-struct db_builder_internal {
-    db_refcount_t refcount;  // Reference count for the builder itself
-    db_buffer data;          // Points to buffer data (same layout as db_buffer)
-    size_t capacity;         // Capacity for growth (size is in metadata)
-};
-
-struct db_reader_internal {
-    db_refcount_t refcount;  // Reference count for the reader itself
-    db_buffer buf;           // Buffer being read (retained reference)
-    size_t position;         // Current read position
-};
-
-// Builder implementation
+db_chain db_chain_retain(db_chain chain) {
+    DB_ASSERT(chain && "db_chain_retain: chain cannot be NULL");
+    DB_REFCOUNT_RETAIN(&chain->refcount);
+    return chain;
+}
 
-db_builder db_builder_new(size_t initial_capacity) {
-    struct db_builder_internal* builder = (struct db_builder_internal*)DB_MALLOC(sizeof(struct db_builder_internal));
-    DB_ASSERT(builder && "db_builder_new: memory allocation failed");
-    
-    db_buffer buf = db_new(initial_capacity);
-    // db_new asserts on allocation failure
+void db_chain_release(db_chain* chain_ptr) {
+    DB_ASSERT(chain_ptr && "db_chain_release: chain_ptr cannot be NULL");
+    if (!*chain_ptr) return;
     
-    builder->refcount = DB_REFCOUNT_INIT(1);
-    builder->data = buf;  // Take ownership of newly created buffer
-    builder->capacity = initial_capacity;
+    db_chain chain = *chain_ptr;
+    *chain_ptr = NULL;
     
-    return builder;
+    if (DB_REFCOUNT_DECREMENT(&chain->refcount) == 0) {
+        // Reference count reached 0, release segments and free the chain
+        for (size_t i = 0; i < chain->count; i++) {
+            db_release(db_chain_slot(chain, i));
+        }
+        DB_FREE(chain->segments);
+        DB_FREE(chain);
+    }
 }
 
-db_builder db_builder_from_buffer(db_buffer buf) {
-    DB_ASSERT(buf && "db_builder_from_buffer: buf cannot be NULL");
+void db_chain_append(db_chain chain, db_buffer buf) {
+    DB_ASSERT(chain && "db_chain_append: chain cannot be NULL");
+    DB_ASSERT(buf && "db_chain_append: buf cannot be NULL");
     
-    struct db_builder_internal* builder = (struct db_builder_internal*)DB_MALLOC(sizeof(struct db_builder_internal));
-    DB_ASSERT(builder && "db_builder_from_buffer: memory allocation failed");
-    
-    // Make a copy of the buffer to preserve immutability
-    builder->data = db_new_with_data(buf, db_size(buf));
-    builder->refcount = DB_REFCOUNT_INIT(1);
-    builder->capacity = db_capacity(buf);
+    db_chain_reserve(chain);
+    *db_chain_slot(chain, chain->count) = db_retain(buf);
+    chain->count++;
+    chain->size += db_meta(buf)->size;
+}
+
+void db_chain_prepend(db_chain chain, db_buffer buf) {
+    DB_ASSERT(chain && "db_chain_prepend: chain cannot be NULL");
+    DB_ASSERT(buf && "db_chain_prepend: buf cannot be NULL");
     
-    return builder;
+    db_chain_reserve(chain);
+    chain->head = (chain->head - 1) & (chain->capacity - 1);
+    chain->segments[chain->head] = db_retain(buf);
+    chain->count++;
+    chain->size += db_meta(buf)->size;
 }
 
-db_builder db_builder_retain(db_builder builder) {
-    DB_ASSERT(builder && "db_builder_retain: builder cannot be NULL");
-    DB_REFCOUNT_INCREMENT(&builder->refcount);
-    return builder;
+size_t db_chain_size(db_chain chain) {
+    DB_ASSERT(chain && "db_chain_size: chain cannot be NULL");
+    return chain->size;
 }
 
-void db_builder_release(db_builder* builder_ptr) {
-    DB_ASSERT(builder_ptr && "db_builder_release: builder_ptr cannot be NULL");
-    if (!*builder_ptr) return;
+size_t db_chain_count(db_chain chain) {
+    DB_ASSERT(chain && "db_chain_count: chain cannot be NULL");
+    return chain->count;
+}
+
+db_buffer db_chain_segment(db_chain chain, size_t index) {
+    DB_ASSERT(chain && "db_chain_segment: chain cannot be NULL");
+    DB_ASSERT(index < chain->count && "db_chain_segment: index out of range");
+    return *db_chain_slot(chain, index);
+}
+
+db_buffer db_chain_flatten(db_chain chain) {
+    DB_ASSERT(chain && "db_chain_flatten: chain cannot be NULL");
     
-    db_builder builder = *builder_ptr;
-    *builder_ptr = NULL;
+    if (chain->count == 0) return db_new(0);
+    if (chain->count == 1) return db_retain(*db_chain_slot(chain, 0));
     
-    if (DB_REFCOUNT_DECREMENT(&builder->refcount) == 0) {
-        // Reference count reached 0, free the builder and release buffer
-        db_release(&builder->data);
-        DB_FREE(builder);
+    db_buffer flat = db_new_ex(chain->size, db_buffer_allocator(*db_chain_slot(chain, 0)));
+    size_t offset = 0;
+    for (size_t i = 0; i < chain->count; i++) {
+        db_buffer* slot = db_chain_slot(chain, i);
+        size_t size = db_meta(*slot)->size;
+        if (size > 0) {
+            memcpy(flat + offset, *slot, size);
+            offset += size;
+        }
+        db_release(slot);
     }
+    db_meta(flat)->size = offset;
+    DB_STATS_ADD(bytes_copied, offset);
+    
+    // Keep the joined buffer so later calls are free
+    chain->head = 0;
+    chain->count = 1;
+    chain->segments[0] = flat;
+    
+    return db_retain(flat);
 }
 
-db_buffer db_builder_finish(db_builder* builder_ptr) {
-    DB_ASSERT(builder_ptr && "db_builder_finish: builder_ptr cannot be NULL");
-    DB_ASSERT(*builder_ptr && "db_builder_finish: builder cannot be NULL");
+ssize_t db_chain_write_fd(db_chain chain, int fd) {
+    DB_ASSERT(chain && "db_chain_write_fd: chain cannot be NULL");
+    DB_ASSERT(fd >= 0 && "db_chain_write_fd: invalid file descriptor");
     
-    struct db_builder_internal* builder = *builder_ptr;
-    db_buffer result = builder->data;
+    if (chain->size == 0) return 0;
     
-    // Invalidate the builder - don't release the buffer, it's being returned
-    builder->data = NULL;
-    DB_FREE(builder);
-    *builder_ptr = NULL;
+#ifdef _WIN32
+    // No writev - write segments one by one, stop at the first short write
+    ssize_t total = 0;
+    for (size_t i = 0; i < chain->count; i++) {
+        db_buffer seg = *db_chain_slot(chain, i);
+        size_t size = db_meta(seg)->size;
+        if (size == 0) continue;
+        ssize_t written = db_write(fd, seg, (unsigned int)size);
+        if (written < 0) return total > 0 ? total : -1;
+        total += written;
+        if ((size_t)written < size) break;
+    }
+    return total;
+#else
+    struct iovec iov[64];
+    size_t max_iov = sizeof(iov) / sizeof(iov[0]) < IOV_MAX ? sizeof(iov) / sizeof(iov[0]) : IOV_MAX;
+    int iovcnt = 0;
+    
+    for (size_t i = 0; i < chain->count && (size_t)iovcnt < max_iov; i++) {
+        db_buffer seg = *db_chain_slot(chain, i);
+        size_t size = db_meta(seg)->size;
+        if (size == 0) continue;
+        iov[iovcnt].iov_base = seg;
+        iov[iovcnt].iov_len = size;
+        iovcnt++;
+    }
     
-    return result;
-}
-
-size_t db_builder_size(db_builder builder) {
-    DB_ASSERT(builder && "db_builder_size: builder cannot be NULL");
-    return db_size(builder->data);
+    return writev(fd, iov, iovcnt);
+#endif
 }
 
-size_t db_builder_capacity(db_builder builder) {
-    DB_ASSERT(builder && "db_builder_capacity: builder cannot be NULL");
-    return builder->capacity;
+static db_buffer db_chain_segment_at(const void* ctx, size_t index) {
+    return *db_chain_slot((struct db_chain_internal*)ctx, index);
 }
 
-void db_builder_clear(db_builder builder) {
-    DB_ASSERT(builder && "db_builder_clear: builder cannot be NULL");
+ssize_t db_chain_write_fdv(db_chain chain, int fd, db_write_cursor* cursor) {
+    DB_ASSERT(chain && "db_chain_write_fdv: chain cannot be NULL");
+    DB_ASSERT(cursor && "db_chain_write_fdv: cursor cannot be NULL");
+    DB_ASSERT(fd >= 0 && "db_chain_write_fdv: invalid file descriptor");
     
-    // Always create a new empty buffer (since buffers are immutable)
-    db_release(&builder->data);
-    builder->data = db_new(builder->capacity);
+    return db_internal_writev(fd, db_chain_segment_at, chain, chain->count, cursor);
 }
 
+// Queue implementation
+#if DB_ATOMIC_REFCOUNT
 
+#define DB_CACHE_LINE 64
 
-int db_builder_append_uint8(db_builder builder, uint8_t value) {
-    DB_ASSERT(builder && "db_builder_append_uint8: builder cannot be NULL");
-    
-    return db_internal_append(&builder->data, &builder->capacity, &value, 1);
+/**
+ * @brief Round a queue capacity up to a power of two
+ * @private
+ */
+static size_t db_queue_capacity(size_t capacity, size_t minimum) {
+    size_t rounded = minimum;
+    while (rounded < capacity) {
+        DB_ASSERT(rounded <= SIZE_MAX / 2 && "db_queue: capacity too large");
+        rounded <<= 1;
+    }
+    return rounded;
 }
 
-int db_builder_append_uint16_le(db_builder builder, uint16_t value) {
-    DB_ASSERT(builder && "db_builder_append_uint16_le: builder cannot be NULL");
+// Producer and consumer indices live on their own cache lines, each next to
+// that side's cached copy of the other index, so the two threads only touch
+// each other's line when the cached view says the queue is full or empty.
+struct db_spsc_internal {
+    db_refcount_t refcount;
+    size_t mask;
+    db_buffer* slots;
+    char pad0[DB_CACHE_LINE];
+    _Atomic size_t tail;       // Next slot to fill (written by the producer)
+    size_t cached_head;        // Producer's last view of head
+    char pad1[DB_CACHE_LINE];
+    _Atomic size_t head;       // Next slot to drain (written by the consumer)
+    size_t cached_tail;        // Consumer's last view of tail
+    char pad2[DB_CACHE_LINE];
+};
+
+db_spsc db_spsc_new(size_t capacity) {
+    DB_ASSERT(capacity > 0 && "db_spsc_new: capacity must be > 0");
     
-    uint8_t bytes[2] = {
-        (uint8_t)(value & 0xFF),
-        (uint8_t)((value >> 8) & 0xFF)
-    };
+    struct db_spsc_internal* queue = (struct db_spsc_internal*)DB_MALLOC(sizeof(struct db_spsc_internal));
+    DB_ASSERT(queue && "db_spsc_new: memory allocation failed");
     
-    return db_internal_append(&builder->data, &builder->capacity, bytes, 2);
-}
-
-int db_builder_append_uint16_be(db_builder builder, uint16_t value) {
-    DB_ASSERT(builder && "db_builder_append_uint16_be: builder cannot be NULL");
+    size_t slots = db_queue_capacity(capacity, 1);
+    queue->slots = (db_buffer*)DB_MALLOC(slots * sizeof(db_buffer));
+    DB_ASSERT(queue->slots && "db_spsc_new: memory allocation failed");
     
-    uint8_t bytes[2] = {
-        (uint8_t)((value >> 8) & 0xFF),
-        (uint8_t)(value & 0xFF)
-    };
+    queue->refcount = DB_REFCOUNT_INIT(1);
+    queue->mask = slots - 1;
+    atomic_init(&queue->tail, 0);
+    atomic_init(&queue->head, 0);
+    queue->cached_head = 0;
+    queue->cached_tail = 0;
     
-    return db_internal_append(&builder->data, &builder->capacity, bytes, 2);
+    return queue;
 }
 
-int db_builder_append_uint32_le(db_builder builder, uint32_t value) {
-    DB_ASSERT(builder && "db_builder_append_uint32_le: builder cannot be NULL");
-    
-    uint8_t bytes[4] = {
-        (uint8_t)(value & 0xFF),
-        (uint8_t)((value >> 8) & 0xFF),
-        (uint8_t)((value >> 16) & 0xFF),
-        (uint8_t)((value >> 24) & 0xFF)
-    };
-    
-    return db_internal_append(&builder->data, &builder->capacity, bytes, 4);
+db_spsc db_spsc_retain(db_spsc queue) {
+    DB_ASSERT(queue && "db_spsc_retain: queue cannot be NULL");
+    DB_REFCOUNT_RETAIN(&queue->refcount);
+    return queue;
 }
 
-int db_builder_append_uint32_be(db_builder builder, uint32_t value) {
-    DB_ASSERT(builder && "db_builder_append_uint32_be: builder cannot be NULL");
+void db_spsc_release(db_spsc* queue_ptr) {
+    DB_ASSERT(queue_ptr && "db_spsc_release: queue_ptr cannot be NULL");
+    if (!*queue_ptr) return;
     
-    uint8_t bytes[4] = {
-        (uint8_t)((value >> 24) & 0xFF),
-        (uint8_t)((value >> 16) & 0xFF),
-        (uint8_t)((value >> 8) & 0xFF),
-        (uint8_t)(value & 0xFF)
-    };
+    db_spsc queue = *queue_ptr;
+    *queue_ptr = NULL;
     
-    return db_internal_append(&builder->data, &builder->capacity, bytes, 4);
+    if (DB_REFCOUNT_DECREMENT(&queue->refcount) == 0) {
+        db_buffer buf;
+        while ((buf = db_spsc_pop(queue)) != NULL) {
+            db_release(&buf);
+        }
+        DB_FREE(queue->slots);
+        DB_FREE(queue);
+    }
 }
 
-int db_builder_append_uint64_le(db_builder builder, uint64_t value) {
-    DB_ASSERT(builder && "db_builder_append_uint64_le: builder cannot be NULL");
+size_t db_spsc_push_batch(db_spsc queue, const db_buffer* buffers, size_t count) {
+    DB_ASSERT(queue && "db_spsc_push_batch: queue cannot be NULL");
+    DB_ASSERT((buffers || count == 0) && "db_spsc_push_batch: buffers cannot be NULL when count > 0");
+    
+    size_t tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+    size_t capacity = queue->mask + 1;
+    size_t space = capacity - (tail - queue->cached_head);
+    if (space < count) {
+        queue->cached_head = atomic_load_explicit(&queue->head, memory_order_acquire);
+        space = capacity - (tail - queue->cached_head);
+    }
     
-    uint8_t bytes[8] = {
-        (uint8_t)(value & 0xFF),
-        (uint8_t)((value >> 8) & 0xFF),
-        (uint8_t)((value >> 16) & 0xFF),
-        (uint8_t)((value >> 24) & 0xFF),
-        (uint8_t)((value >> 32) & 0xFF),
-        (uint8_t)((value >> 40) & 0xFF),
-        (uint8_t)((value >> 48) & 0xFF),
-        (uint8_t)((value >> 56) & 0xFF)
-    };
+    size_t n = count < space ? count : space;
+    for (size_t i = 0; i < n; i++) {
+        DB_ASSERT(buffers[i] && "db_spsc_push_batch: buffers cannot contain NULL");
+        queue->slots[(tail + i) & queue->mask] = db_share(buffers[i]);
+    }
     
-    return db_internal_append(&builder->data, &builder->capacity, bytes, 8);
+    // Publish the slots in one store
+    atomic_store_explicit(&queue->tail, tail + n, memory_order_release);
+    return n;
 }
 
-int db_builder_append_uint64_be(db_builder builder, uint64_t value) {
-    DB_ASSERT(builder && "db_builder_append_uint64_be: builder cannot be NULL");
-    
-    uint8_t bytes[8] = {
-        (uint8_t)((value >> 56) & 0xFF),
-        (uint8_t)((value >> 48) & 0xFF),
-        (uint8_t)((value >> 40) & 0xFF),
-        (uint8_t)((value >> 32) & 0xFF),
-        (uint8_t)((value >> 24) & 0xFF),
-        (uint8_t)((value >> 16) & 0xFF),
-        (uint8_t)((value >> 8) & 0xFF),
-        (uint8_t)(value & 0xFF)
-    };
-    
-    return db_internal_append(&builder->data, &builder->capacity, bytes, 8);
+bool db_spsc_push(db_spsc queue, db_buffer buf) {
+    DB_ASSERT(buf && "db_spsc_push: buf cannot be NULL");
+    return db_spsc_push_batch(queue, &buf, 1) == 1;
 }
 
-int db_builder_append(db_builder builder, const void* data, size_t size) {
-    DB_ASSERT(builder && "db_builder_append: builder cannot be NULL");
-    DB_ASSERT((data || size == 0) && "db_builder_append: data cannot be NULL when size > 0");
+size_t db_spsc_pop_batch(db_spsc queue, db_buffer* out, size_t max) {
+    DB_ASSERT(queue && "db_spsc_pop_batch: queue cannot be NULL");
+    DB_ASSERT((out || max == 0) && "db_spsc_pop_batch: out cannot be NULL when max > 0");
     
-    if (size == 0) return 0;
+    size_t head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    size_t available = queue->cached_tail - head;
+    if (available < max) {
+        queue->cached_tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+        available = queue->cached_tail - head;
+    }
+    
+    size_t n = max < available ? max : available;
+    for (size_t i = 0; i < n; i++) {
+        out[i] = queue->slots[(head + i) & queue->mask];
+    }
     
-    return db_internal_append(&builder->data, &builder->capacity, data, size);
+    // Hand the slots back to the producer
+    atomic_store_explicit(&queue->head, head + n, memory_order_release);
+    return n;
 }
 
-int db_builder_append_cstring(db_builder builder, const char* str) {
-    DB_ASSERT(builder && "db_builder_append_cstring: builder cannot be NULL");
-    DB_ASSERT(str && "db_builder_append_cstring: str cannot be NULL");
-    
-    size_t len = strlen(str);
-    return db_builder_append(builder, str, len);
+db_buffer db_spsc_pop(db_spsc queue) {
+    db_buffer buf = NULL;
+    db_spsc_pop_batch(queue, &buf, 1);
+    return buf;
 }
 
-int db_builder_append_buffer(db_builder builder, db_buffer buf) {
-    DB_ASSERT(builder && "db_builder_append_buffer: builder cannot be NULL");
-    DB_ASSERT(buf && "db_builder_append_buffer: buf cannot be NULL");
-    
-    return db_builder_append(builder, buf, db_size(buf));
+size_t db_spsc_size(db_spsc queue) {
+    DB_ASSERT(queue && "db_spsc_size: queue cannot be NULL");
+    size_t head = atomic_load_explicit(&queue->head, memory_order_acquire);
+    size_t tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+    return tail - head;
 }
 
-// Reader implementation
+size_t db_spsc_capacity(db_spsc queue) {
+    DB_ASSERT(queue && "db_spsc_capacity: queue cannot be NULL");
+    return queue->mask + 1;
+}
 
-db_reader db_reader_new(db_buffer buf) {
-    DB_ASSERT(buf && "db_reader_new: buf cannot be NULL");
+// Bounded MPMC queue after Dmitry Vyukov's design: each cell carries a
+// sequence number that says whether it is free for position p (seq == p) or
+// holds the value pushed at p (seq == p + 1). Producers and consumers claim
+// positions with a CAS on their own index, then hand the cell over with a
+// release store of its sequence.
+typedef struct db_mpmc_cell {
+    _Atomic size_t sequence;
+    db_buffer buf;
+} db_mpmc_cell;
+
+struct db_mpmc_internal {
+    db_refcount_t refcount;
+    size_t mask;
+    db_mpmc_cell* cells;
+    char pad0[DB_CACHE_LINE];
+    _Atomic size_t enqueue_pos;
+    char pad1[DB_CACHE_LINE];
+    _Atomic size_t dequeue_pos;
+    char pad2[DB_CACHE_LINE];
+};
+
+db_mpmc db_mpmc_new(size_t capacity) {
+    DB_ASSERT(capacity > 0 && "db_mpmc_new: capacity must be > 0");
     
-    struct db_reader_internal* reader = (struct db_reader_internal*)DB_MALLOC(sizeof(struct db_reader_internal));
-    DB_ASSERT(reader && "db_reader_new: memory allocation failed");
+    struct db_mpmc_internal* queue = (struct db_mpmc_internal*)DB_MALLOC(sizeof(struct db_mpmc_internal));
+    DB_ASSERT(queue && "db_mpmc_new: memory allocation failed");
     
-    reader->refcount = DB_REFCOUNT_INIT(1);
-    reader->buf = db_retain(buf);  // Keep a reference to the buffer
-    reader->position = 0;
+    size_t cells = db_queue_capacity(capacity, 2);
+    queue->cells = (db_mpmc_cell*)DB_MALLOC(cells * sizeof(db_mpmc_cell));
+    DB_ASSERT(queue->cells && "db_mpmc_new: memory allocation failed");
     
-    return reader;
+    for (size_t i = 0; i < cells; i++) {
+        atomic_init(&queue->cells[i].sequence, i);
+        queue->cells[i].buf = NULL;
+    }
+    queue->refcount = DB_REFCOUNT_INIT(1);
+    queue->mask = cells - 1;
+    atomic_init(&queue->enqueue_pos, 0);
+    atomic_init(&queue->dequeue_pos, 0);
+    
+    return queue;
 }
 
-db_reader db_reader_retain(db_reader reader) {
-    DB_ASSERT(reader && "db_reader_retain: reader cannot be NULL");
-    DB_REFCOUNT_INCREMENT(&reader->refcount);
-    return reader;
+db_mpmc db_mpmc_retain(db_mpmc queue) {
+    DB_ASSERT(queue && "db_mpmc_retain: queue cannot be NULL");
+    DB_REFCOUNT_RETAIN(&queue->refcount);
+    return queue;
 }
 
-void db_reader_release(db_reader* reader_ptr) {
-    DB_ASSERT(reader_ptr && "db_reader_release: reader_ptr cannot be NULL");
-    if (!*reader_ptr) return;
+void db_mpmc_release(db_mpmc* queue_ptr) {
+    DB_ASSERT(queue_ptr && "db_mpmc_release: queue_ptr cannot be NULL");
+    if (!*queue_ptr) return;
     
-    db_reader reader = *reader_ptr;
-    *reader_ptr = NULL;
+    db_mpmc queue = *queue_ptr;
+    *queue_ptr = NULL;
     
-    if (DB_REFCOUNT_DECREMENT(&reader->refcount) == 0) {
-        // Reference count reached 0, free the reader and release buffer
-        db_release(&reader->buf);
-        DB_FREE(reader);
+    if (DB_REFCOUNT_DECREMENT(&queue->refcount) == 0) {
+        db_buffer buf;
+        while ((buf = db_mpmc_pop(queue)) != NULL) {
+            db_release(&buf);
+        }
+        DB_FREE(queue->cells);
+        DB_FREE(queue);
     }
 }
 
-void db_reader_free(db_reader* reader_ptr) {
-    // Legacy function - just call the new release function
-    db_reader_release(reader_ptr);
+size_t db_mpmc_push_batch(db_mpmc queue, const db_buffer* buffers, size_t count) {
+    DB_ASSERT(queue && "db_mpmc_push_batch: queue cannot be NULL");
+    DB_ASSERT((buffers || count == 0) && "db_mpmc_push_batch: buffers cannot be NULL when count > 0");
+    if (count == 0) return 0;
+    
+    size_t pos = atomic_load_explicit(&queue->enqueue_pos, memory_order_relaxed);
+    size_t n;
+    for (;;) {
+        // Count the free cells in a row starting at pos
+        n = 0;
+        while (n < count) {
+            db_mpmc_cell* cell = &queue->cells[(pos + n) & queue->mask];
+            size_t seq = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+            if (seq != pos + n) break;
+            n++;
+        }
+        
+        if (n == 0) {
+            db_mpmc_cell* cell = &queue->cells[pos & queue->mask];
+            intptr_t diff = (intptr_t)atomic_load_explicit(&cell->sequence, memory_order_acquire) - (intptr_t)pos;
+            if (diff < 0) return 0;  // Full: the cell still holds last lap's value
+            pos = atomic_load_explicit(&queue->enqueue_pos, memory_order_relaxed);
+            continue;  // Another producer got there first
+        }
+        
+        // On failure pos is reloaded with the current enqueue position
+        if (atomic_compare_exchange_weak_explicit(&queue->enqueue_pos, &pos, pos + n,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+            break;
+        }
+    }
+    
+    for (size_t i = 0; i < n; i++) {
+        DB_ASSERT(buffers[i] && "db_mpmc_push_batch: buffers cannot contain NULL");
+        db_mpmc_cell* cell = &queue->cells[(pos + i) & queue->mask];
+        cell->buf = db_share(buffers[i]);
+        atomic_store_explicit(&cell->sequence, pos + i + 1, memory_order_release);
+    }
+    return n;
 }
 
-size_t db_reader_position(db_reader reader) {
-    DB_ASSERT(reader && "reader cannot be NULL");
-    return reader->position;
+bool db_mpmc_push(db_mpmc queue, db_buffer buf) {
+    DB_ASSERT(buf && "db_mpmc_push: buf cannot be NULL");
+    return db_mpmc_push_batch(queue, &buf, 1) == 1;
 }
 
-size_t db_reader_remaining(db_reader reader) {
-    DB_ASSERT(reader && "reader cannot be NULL");
-    size_t buffer_size = db_meta(reader->buf)->size;
-    return (reader->position < buffer_size) ? (buffer_size - reader->position) : 0;
+size_t db_mpmc_pop_batch(db_mpmc queue, db_buffer* out, size_t max) {
+    DB_ASSERT(queue && "db_mpmc_pop_batch: queue cannot be NULL");
+    DB_ASSERT((out || max == 0) && "db_mpmc_pop_batch: out cannot be NULL when max > 0");
+    if (max == 0) return 0;
+    
+    size_t pos = atomic_load_explicit(&queue->dequeue_pos, memory_order_relaxed);
+    size_t n;
+    for (;;) {
+        // Count the filled cells in a row starting at pos
+        n = 0;
+        while (n < max) {
+            db_mpmc_cell* cell = &queue->cells[(pos + n) & queue->mask];
+            size_t seq = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+            if (seq != pos + n + 1) break;
+            n++;
+        }
+        
+        if (n == 0) {
+            db_mpmc_cell* cell = &queue->cells[pos & queue->mask];
+            intptr_t diff = (intptr_t)atomic_load_explicit(&cell->sequence, memory_order_acquire) - (intptr_t)(pos + 1);
+            if (diff < 0) return 0;  // Empty: the cell hasn't been filled for this lap
+            pos = atomic_load_explicit(&queue->dequeue_pos, memory_order_relaxed);
+            continue;  // Another consumer got there first
+        }
+        
+        if (atomic_compare_exchange_weak_explicit(&queue->dequeue_pos, &pos, pos + n,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+            break;
+        }
+    }
+    
+    for (size_t i = 0; i < n; i++) {
+        db_mpmc_cell* cell = &queue->cells[(pos + i) & queue->mask];
+        out[i] = cell->buf;
+        cell->buf = NULL;
+        // Free the cell for the producer one lap ahead
+        atomic_store_explicit(&cell->sequence, pos + i + queue->mask + 1, memory_order_release);
+    }
+    return n;
 }
 
-bool db_reader_can_read(db_reader reader, size_t bytes) {
-    DB_ASSERT(reader && "reader cannot be NULL");
-    return db_reader_remaining(reader) >= bytes;
+db_buffer db_mpmc_pop(db_mpmc queue) {
+    db_buffer buf = NULL;
+    db_mpmc_pop_batch(queue, &buf, 1);
+    return buf;
 }
 
-void db_reader_seek(db_reader reader, size_t position) {
-    DB_ASSERT(reader && "reader cannot be NULL");
-    size_t buffer_size = db_meta(reader->buf)->size;
-    DB_ASSERT(position <= buffer_size && "db_reader_seek: cannot seek past buffer end");
-    reader->position = position;
+size_t db_mpmc_size(db_mpmc queue) {
+    DB_ASSERT(queue && "db_mpmc_size: queue cannot be NULL");
+    size_t dequeue = atomic_load_explicit(&queue->dequeue_pos, memory_order_acquire);
+    size_t enqueue = atomic_load_explicit(&queue->enqueue_pos, memory_order_acquire);
+    // Claimed positions can briefly run ahead on either side
+    if (enqueue <= dequeue) return 0;
+    size_t size = enqueue - dequeue;
+    return size > queue->mask + 1 ? queue->mask + 1 : size;
 }
 
-uint8_t db_read_uint8(db_reader reader) {
-    DB_ASSERT(reader && "reader cannot be NULL");
-    DB_ASSERT(db_reader_can_read(reader, 1) && "db_read_uint8: insufficient data available");
-    
-    uint8_t value = *(uint8_t*)(reader->buf + reader->position);
-    reader->position += 1;
-    
-    return value;
+size_t db_mpmc_capacity(db_mpmc queue) {
+    DB_ASSERT(queue && "db_mpmc_capacity: queue cannot be NULL");
+    return queue->mask + 1;
 }
 
-uint16_t db_read_uint16_le(db_reader reader) {
-    DB_ASSERT(reader && "reader cannot be NULL");
-    DB_ASSERT(db_reader_can_read(reader, 2) && "insufficient data available");
-    
-    const uint8_t* ptr = (const uint8_t*)(reader->buf + reader->position);
-    uint16_t value = (uint16_t)ptr[0] | ((uint16_t)ptr[1] << 8);
-    reader->position += 2;
-    
-    return value;
+#endif // DB_ATOMIC_REFCOUNT
+
+// Parallel bulk operations
+#define DB_PARALLEL_DEFAULT_THRESHOLD (4 * 1024 * 1024)
+#define DB_PARALLEL_DEFAULT_CHUNK (1024 * 1024)
+
+/**
+ * @brief Pick the chunk size for a parallel run, or 0 to stay serial
+ * @private
+ */
+static size_t db_parallel_chunk(const db_parallel_config* config, size_t size) {
+    if (!config || !config->executor) return 0;
+    size_t threshold = config->threshold ? config->threshold : DB_PARALLEL_DEFAULT_THRESHOLD;
+    size_t chunk = config->chunk_size ? config->chunk_size : DB_PARALLEL_DEFAULT_CHUNK;
+    if (size < threshold || size <= chunk) return 0;
+    return chunk;
 }
 
-uint16_t db_read_uint16_be(db_reader reader) {
-    DB_ASSERT(reader && "reader cannot be NULL");
-    DB_ASSERT(db_reader_can_read(reader, 2) && "insufficient data available");
-    
-    const uint8_t* ptr = (const uint8_t*)(reader->buf + reader->position);
-    uint16_t value = ((uint16_t)ptr[0] << 8) | (uint16_t)ptr[1];
-    reader->position += 2;
+typedef struct db_concat_job {
+    db_buffer* buffers;
+    size_t* offsets;           // offsets[i] is where buffers[i] starts in the output; offsets[count] is the total
+    size_t count;
+    size_t chunk;
+    char* out;
+} db_concat_job;
+
+static void db_concat_task(void* arg, size_t index) {
+    db_concat_job* job = (db_concat_job*)arg;
+    size_t start = index * job->chunk;
+    size_t end = job->offsets[job->count] - start < job->chunk ? job->offsets[job->count] : start + job->chunk;
+    
+    // Find the last buffer starting at or before this chunk
+    size_t lo = 0, hi = job->count;
+    while (hi - lo > 1) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (job->offsets[mid] <= start) lo = mid; else hi = mid;
+    }
     
-    return value;
+    for (size_t i = lo; i < job->count && job->offsets[i] < end; i++) {
+        size_t from = job->offsets[i] > start ? job->offsets[i] : start;
+        size_t to = job->offsets[i + 1] < end ? job->offsets[i + 1] : end;
+        if (to > from) {
+            memcpy(job->out + from, job->buffers[i] + (from - job->offsets[i]), to - from);
+        }
+    }
 }
 
-uint32_t db_read_uint32_le(db_reader reader) {
-    DB_ASSERT(reader && "reader cannot be NULL");
-    DB_ASSERT(db_reader_can_read(reader, 4) && "insufficient data available");
+db_buffer db_concat_many_parallel(db_buffer* buffers, size_t count, const db_parallel_config* config) {
+    if (!buffers || count == 0) return db_new(0);
     
-    const uint8_t* ptr = (const uint8_t*)(reader->buf + reader->position);
-    uint32_t value = (uint32_t)ptr[0] | 
-                    ((uint32_t)ptr[1] << 8) | 
-                    ((uint32_t)ptr[2] << 16) | 
-                    ((uint32_t)ptr[3] << 24);
-    reader->position += 4;
+    size_t total_size = 0;
+    db_buffer first = NULL;
+    for (size_t i = 0; i < count; i++) {
+        if (buffers[i]) {
+            if (!first) first = buffers[i];
+            total_size += db_meta(buffers[i])->size;
+        }
+    }
     
-    return value;
+    size_t chunk = db_parallel_chunk(config, total_size);
+    if (chunk == 0) return db_concat_many(buffers, count);
+    
+    size_t* offsets = (size_t*)DB_MALLOC((count + 1) * sizeof(size_t));
+    DB_ASSERT(offsets && "db_concat_many_parallel: memory allocation failed");
+    size_t offset = 0;
+    for (size_t i = 0; i < count; i++) {
+        offsets[i] = offset;
+        if (buffers[i]) offset += db_meta(buffers[i])->size;
+    }
+    offsets[count] = offset;
+    
+    db_buffer result = db_new_ex(total_size, first ? db_buffer_allocator(first) : NULL);
+    db_concat_job job = { buffers, offsets, count, chunk, result };
+    config->executor->run(config->executor->user, db_concat_task, &job, (total_size + chunk - 1) / chunk);
+    DB_FREE(offsets);
+    DB_STATS_ADD(bytes_copied, total_size);
+    
+    db_meta(result)->size = total_size;
+    return result;
 }
 
-uint32_t db_read_uint32_be(db_reader reader) {
-    DB_ASSERT(reader && "reader cannot be NULL");
-    DB_ASSERT(db_reader_can_read(reader, 4) && "insufficient data available");
+typedef struct db_hex_job {
+    const uint8_t* data;
+    size_t size;
+    size_t chunk;
+    char* out;
+    bool uppercase;
+} db_hex_job;
+
+static void db_hex_task(void* arg, size_t index) {
+    db_hex_job* job = (db_hex_job*)arg;
+    size_t start = index * job->chunk;
+    size_t length = job->size - start < job->chunk ? job->size - start : job->chunk;
+    db_internal_hex_encode(job->data + start, length, job->out + start * 2, job->uppercase);
+}
+
+db_buffer db_to_hex_parallel(db_buffer buf, bool uppercase, const db_parallel_config* config) {
+    DB_ASSERT(buf && "db_to_hex_parallel: buf cannot be NULL");
     
-    const uint8_t* ptr = (const uint8_t*)(reader->buf + reader->position);
-    uint32_t value = ((uint32_t)ptr[0] << 24) | 
-                    ((uint32_t)ptr[1] << 16) | 
-                    ((uint32_t)ptr[2] << 8) | 
-                    (uint32_t)ptr[3];
-    reader->position += 4;
+    size_t size = db_meta(buf)->size;
+    size_t chunk = db_parallel_chunk(config, size);
+    if (chunk == 0) return db_to_hex(buf, uppercase);
     
-    return value;
+    db_buffer hex_buf = db_new(size * 2);
+    db_hex_job job = { (const uint8_t*)buf, size, chunk, hex_buf, uppercase };
+    config->executor->run(config->executor->user, db_hex_task, &job, (size + chunk - 1) / chunk);
+    
+    db_meta(hex_buf)->size = size * 2;
+    return hex_buf;
 }
 
-uint64_t db_read_uint64_le(db_reader reader) {
-    DB_ASSERT(reader && "reader cannot be NULL");
-    DB_ASSERT(db_reader_can_read(reader, 8) && "insufficient data available");
+typedef struct db_equals_job {
+    const char* a;
+    const char* b;
+    size_t size;
+    size_t chunk;
+    bool* differs;             // One flag per chunk, so tasks never share a write
+} db_equals_job;
+
+static void db_equals_task(void* arg, size_t index) {
+    db_equals_job* job = (db_equals_job*)arg;
+    size_t start = index * job->chunk;
+    size_t length = job->size - start < job->chunk ? job->size - start : job->chunk;
+    job->differs[index] = memcmp(job->a + start, job->b + start, length) != 0;
+}
+
+bool db_equals_parallel(db_buffer buf1, db_buffer buf2, const db_parallel_config* config) {
+    DB_ASSERT(buf1 && "db_equals_parallel: buf1 cannot be NULL");
+    DB_ASSERT(buf2 && "db_equals_parallel: buf2 cannot be NULL");
+    
+    size_t size = db_meta(buf1)->size;
+    size_t chunk = db_parallel_chunk(config, size);
+    if (chunk == 0 || buf1 == buf2 || size != db_meta(buf2)->size) return db_equals(buf1, buf2);
+#if DB_CACHE_HASH
+    uint64_t hash1 = DB_HASH_LOAD(&db_meta(buf1)->hash);
+    uint64_t hash2 = DB_HASH_LOAD(&db_meta(buf2)->hash);
+    if (hash1 && hash2 && hash1 != hash2) return false;
+#endif
     
-    const uint8_t* ptr = (const uint8_t*)(reader->buf + reader->position);
-    uint64_t value = (uint64_t)ptr[0] | 
-                    ((uint64_t)ptr[1] << 8) | 
-                    ((uint64_t)ptr[2] << 16) | 
-                    ((uint64_t)ptr[3] << 24) |
-                    ((uint64_t)ptr[4] << 32) | 
-                    ((uint64_t)ptr[5] << 40) | 
-                    ((uint64_t)ptr[6] << 48) | 
-                    ((uint64_t)ptr[7] << 56);
-    reader->position += 8;
+    size_t tasks = (size + chunk - 1) / chunk;
+    bool* differs = (bool*)DB_MALLOC(tasks * sizeof(bool));
+    DB_ASSERT(differs && "db_equals_parallel: memory allocation failed");
+    db_equals_job job = { buf1, buf2, size, chunk, differs };
+    config->executor->run(config->executor->user, db_equals_task, &job, tasks);
     
-    return value;
+    bool equal = true;
+    for (size_t i = 0; i < tasks && equal; i++) {
+        equal = !differs[i];
+    }
+    DB_FREE(differs);
+    return equal;
 }
 
-uint64_t db_read_uint64_be(db_reader reader) {
-    DB_ASSERT(reader && "reader cannot be NULL");
-    DB_ASSERT(db_reader_can_read(reader, 8) && "insufficient data available");
-    
-    const uint8_t* ptr = (const uint8_t*)(reader->buf + reader->position);
-    uint64_t value = ((uint64_t)ptr[0] << 56) | 
-                    ((uint64_t)ptr[1] << 48) | 
-                    ((uint64_t)ptr[2] << 40) | 
-                    ((uint64_t)ptr[3] << 32) |
-                    ((uint64_t)ptr[4] << 24) | 
-                    ((uint64_t)ptr[5] << 16) | 
-                    ((uint64_t)ptr[6] << 8) | 
-                    (uint64_t)ptr[7];
-    reader->position += 8;
+#if DB_THREAD_POOL
+#include <pthread.h>
+
+struct db_thread_pool_internal {
+    db_executor executor;      // user points back at the pool
+    pthread_mutex_t run_lock;  // Serializes runs from different callers
+    pthread_mutex_t lock;      // Guards everything below
+    pthread_cond_t work_ready;
+    pthread_cond_t work_done;
+    db_task_fn task;
+    void* arg;
+    size_t count;
+    size_t next;               // Next task index to claim
+    size_t finished;
+    bool stopping;
+    unsigned thread_count;
+    pthread_t* threads;
+};
+
+/**
+ * @brief Claim and run tasks until none are left (called with lock held)
+ * @private
+ */
+static void db_thread_pool_drain(struct db_thread_pool_internal* pool) {
+    while (pool->next < pool->count) {
+        size_t index = pool->next++;
+        pthread_mutex_unlock(&pool->lock);
+        pool->task(pool->arg, index);
+        pthread_mutex_lock(&pool->lock);
+        if (++pool->finished == pool->count) {
+            pthread_cond_signal(&pool->work_done);
+        }
+    }
+}
+
+static void* db_thread_pool_worker(void* user) {
+    struct db_thread_pool_internal* pool = (struct db_thread_pool_internal*)user;
+    pthread_mutex_lock(&pool->lock);
+    for (;;) {
+        while (!pool->stopping && pool->next >= pool->count) {
+            pthread_cond_wait(&pool->work_ready, &pool->lock);
+        }
+        if (pool->stopping) break;
+        db_thread_pool_drain(pool);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+static void db_thread_pool_run(void* user, db_task_fn task, void* arg, size_t count) {
+    struct db_thread_pool_internal* pool = (struct db_thread_pool_internal*)user;
+    if (count == 0) return;
+    
+    pthread_mutex_lock(&pool->run_lock);
+    pthread_mutex_lock(&pool->lock);
+    pool->task = task;
+    pool->arg = arg;
+    pool->count = count;
+    pool->next = 0;
+    pool->finished = 0;
+    pthread_cond_broadcast(&pool->work_ready);
+    
+    // Help out instead of idling, then wait for tasks still running elsewhere
+    db_thread_pool_drain(pool);
+    while (pool->finished < pool->count) {
+        pthread_cond_wait(&pool->work_done, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    pthread_mutex_unlock(&pool->run_lock);
+}
+
+db_thread_pool db_thread_pool_new(unsigned threads) {
+    if (threads == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cpus > 1 ? (unsigned)(cpus - 1) : 0;
+    }
     
-    return value;
+    struct db_thread_pool_internal* pool =
+        (struct db_thread_pool_internal*)DB_MALLOC(sizeof(struct db_thread_pool_internal));
+    DB_ASSERT(pool && "db_thread_pool_new: memory allocation failed");
+    pool->threads = threads ? (pthread_t*)DB_MALLOC(threads * sizeof(pthread_t)) : NULL;
+    DB_ASSERT((pool->threads || threads == 0) && "db_thread_pool_new: memory allocation failed");
+    
+    pool->executor.run = db_thread_pool_run;
+    pool->executor.user = pool;
+    pthread_mutex_init(&pool->run_lock, NULL);
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->work_ready, NULL);
+    pthread_cond_init(&pool->work_done, NULL);
+    pool->task = NULL;
+    pool->arg = NULL;
+    pool->count = 0;
+    pool->next = 0;
+    pool->finished = 0;
+    pool->stopping = false;
+    pool->thread_count = 0;
+    
+    // Callers run tasks too, so a pool that got fewer threads still makes progress
+    for (unsigned i = 0; i < threads; i++) {
+        if (pthread_create(&pool->threads[i], NULL, db_thread_pool_worker, pool) != 0) break;
+        pool->thread_count = i + 1;
+    }
+    return pool;
 }
 
-void db_read_bytes(db_reader reader, void* data, size_t size) {
-    DB_ASSERT(reader && "reader cannot be NULL");
-    DB_ASSERT((data || size == 0) && "db_read_bytes: data cannot be NULL when size > 0");
-    DB_ASSERT(db_reader_can_read(reader, size) && "db_read_bytes: insufficient data available");
+const db_executor* db_thread_pool_executor(db_thread_pool pool) {
+    DB_ASSERT(pool && "db_thread_pool_executor: pool cannot be NULL");
+    return &pool->executor;
+}
+
+unsigned db_thread_pool_size(db_thread_pool pool) {
+    DB_ASSERT(pool && "db_thread_pool_size: pool cannot be NULL");
+    return pool->thread_count;
+}
+
+void db_thread_pool_release(db_thread_pool* pool_ptr) {
+    DB_ASSERT(pool_ptr && "db_thread_pool_release: pool_ptr cannot be NULL");
+    if (!*pool_ptr) return;
     
-    if (size > 0) {
-        memcpy(data, reader->buf + reader->position, size);
-        reader->position += size;
+    db_thread_pool pool = *pool_ptr;
+    *pool_ptr = NULL;
+    
+    pthread_mutex_lock(&pool->lock);
+    pool->stopping = true;
+    pthread_cond_broadcast(&pool->work_ready);
+    pthread_mutex_unlock(&pool->lock);
+    for (unsigned i = 0; i < pool->thread_count; i++) {
+        pthread_join(pool->threads[i], NULL);
     }
+    
+    pthread_cond_destroy(&pool->work_done);
+    pthread_cond_destroy(&pool->work_ready);
+    pthread_mutex_destroy(&pool->lock);
+    pthread_mutex_destroy(&pool->run_lock);
+    DB_FREE(pool->threads);
+    DB_FREE(pool);
 }
 
+#endif // DB_THREAD_POOL
+
 #endif // DB_IMPLEMENTATION
 
 #endif // DYNAMIC_BUFFER_H
\ No newline at end of file
@@ -4,6 +4,11 @@
 #include <string.h>
 #include <unistd.h>
 #include <stdlib.h>
+#include <fcntl.h>
+#if DB_ATOMIC_REFCOUNT
+#include <pthread.h>
+#include <sched.h>
+#endif
 
 void setUp(void) {
     // Set up function called before each test
@@ -34,6 +39,28 @@ void test_db_new_creates_buffer_with_capacity(void) {
     db_release(&buf);
 }
 
+void test_db_header_keeps_data_aligned(void) {
+    // Small keys: header size decides how many fit per cache line
+#if DB_COMPACT_HEADER
+    TEST_ASSERT_EQUAL(DB_CACHE_HASH ? 24 : 16, sizeof(db_internal));
+#endif
+    TEST_ASSERT_EQUAL(0, sizeof(db_internal) % 8);
+    
+    db_buffer key = db_new_with_data("user:1234", 9);
+    TEST_ASSERT_EQUAL(0, (uintptr_t)key % 8);
+    TEST_ASSERT_EQUAL(9, db_size(key));
+    
+    // Growth past DB_MAX_CAPACITY fails cleanly instead of truncating the size
+    db_builder builder = db_builder_from_buffer(key);
+    if (DB_MAX_CAPACITY < SIZE_MAX) {
+        TEST_ASSERT_NULL(db_builder_reserve(builder, DB_MAX_CAPACITY));
+    }
+    TEST_ASSERT_NOT_NULL(db_builder_reserve(builder, 100));
+    TEST_ASSERT_EQUAL(9, db_builder_size(builder));
+    db_builder_release(&builder);
+    db_release(&key);
+}
+
 void test_db_new_with_data_copies_data(void) {
     const char* test_data = "Hello, World!";
     size_t data_len = strlen(test_data);
@@ -81,6 +108,211 @@ void test_db_new_from_owned_data_takes_ownership(void) {
     db_release(&buf);
 }
 
+static int external_free_calls = 0;
+
+static void count_external_free(void* block, void* user) {
+    TEST_ASSERT_EQUAL_PTR(user, block);
+    external_free_calls++;
+    free(block);
+}
+
+void test_db_new_from_external_adopts_memory(void) {
+    char* block = malloc(DB_EXTERNAL_HEADER_SIZE + 16);
+    memcpy(block + DB_EXTERNAL_HEADER_SIZE, "Payload", 7);
+    external_free_calls = 0;
+    
+    db_buffer buf = db_new_from_external(block, 7, 16, count_external_free, block);
+    TEST_ASSERT_EQUAL_PTR(block + DB_EXTERNAL_HEADER_SIZE, buf);  // No copy
+    TEST_ASSERT_EQUAL(7, db_size(buf));
+    TEST_ASSERT_EQUAL(16, db_capacity(buf));
+    TEST_ASSERT_EQUAL_MEMORY("Payload", buf, 7);
+    
+    db_buffer shared = db_retain(buf);
+    TEST_ASSERT_EQUAL(2, db_refcount(buf));
+    db_release(&shared);
+    TEST_ASSERT_EQUAL(0, external_free_calls);
+    
+    db_release(&buf);
+    TEST_ASSERT_EQUAL(1, external_free_calls);
+}
+
+typedef struct {
+    int allocs;
+    int frees;
+    size_t live_bytes;
+} counting_allocator_state;
+
+static void* counting_alloc(void* user, size_t size) {
+    counting_allocator_state* state = (counting_allocator_state*)user;
+    state->allocs++;
+    state->live_bytes += size;
+    return malloc(size);
+}
+
+static void counting_free(void* user, void* ptr, size_t size) {
+    counting_allocator_state* state = (counting_allocator_state*)user;
+    state->frees++;
+    state->live_bytes -= size;
+    free(ptr);
+}
+
+void test_db_new_ex_uses_custom_allocator(void) {
+    counting_allocator_state state = {0, 0, 0};
+    db_allocator allocator = {counting_alloc, NULL, counting_free, &state};
+    
+    db_buffer buf = db_new_with_data_ex("Hello", 5, &allocator);
+    TEST_ASSERT_EQUAL(1, state.allocs);
+    TEST_ASSERT_EQUAL(5, db_size(buf));
+    TEST_ASSERT_EQUAL_MEMORY("Hello", buf, 5);
+    
+    // Builder growth without a realloc callback falls back to alloc + free
+    db_builder builder = db_builder_new_ex(4, &allocator);
+    TEST_ASSERT_EQUAL(0, db_builder_append_buffer(builder, buf));
+    TEST_ASSERT_EQUAL(0, db_builder_append_cstring(builder, " World"));
+    db_buffer built = db_builder_finish(&builder);
+    TEST_ASSERT_EQUAL_MEMORY("Hello World", built, 11);
+    
+    db_release(&buf);
+    db_release(&built);
+    TEST_ASSERT_EQUAL(state.allocs, state.frees);
+    TEST_ASSERT_EQUAL(0, state.live_bytes);
+}
+
+void test_db_small_pool_recycles_blocks(void) {
+    const db_allocator* pool = db_small_pool_allocator();
+    TEST_ASSERT_NOT_NULL(pool);
+    
+    db_buffer first = db_new_ex(150, pool);
+    TEST_ASSERT_EQUAL(150, db_capacity(first));
+    char* first_data = first;
+    db_release(&first);
+    
+    // Same size class (256 bytes with any header layout) comes straight back
+    // from the thread's free list
+    db_buffer second = db_new_ex(200, pool);
+    TEST_ASSERT_EQUAL_PTR(first_data, second);
+    TEST_ASSERT_EQUAL(200, db_capacity(second));
+    db_release(&second);
+    
+    // Oversized blocks fall through to the general allocator
+    db_buffer large = db_new_ex(1 << 16, pool);
+    TEST_ASSERT_EQUAL(1 << 16, db_capacity(large));
+    db_release(&large);
+    
+    db_small_pool_trim();
+}
+
+void test_db_arena_allocates_and_resets(void) {
+    db_arena arena = db_arena_new(1024);
+    const db_allocator* a = db_arena_allocator(arena);
+    
+    db_buffer request = db_new_with_data_ex("GET /index", 10, a);
+    size_t used_after_new = db_arena_used(arena);
+    TEST_ASSERT(used_after_new > 0);
+    
+    // Derived buffers come from the same arena
+    db_buffer path = db_slice_from(request, 4);
+    db_buffer line = db_concat(request, path);
+    TEST_ASSERT(db_arena_used(arena) > used_after_new);
+    TEST_ASSERT_EQUAL_MEMORY("/index", path, 6);
+    TEST_ASSERT_EQUAL_MEMORY("GET /index/index", line, 16);
+    
+    // Refcounting still works, release just doesn't free
+    db_buffer shared = db_retain(request);
+    TEST_ASSERT_EQUAL(2, db_refcount(request));
+    db_release(&shared);
+    
+    // Builder growth and oversized blocks
+    db_builder builder = db_builder_new_ex(8, a);
+    for (int i = 0; i < 600; i++) {
+        TEST_ASSERT_EQUAL(0, db_builder_append_uint32_le(builder, (uint32_t)i));
+    }
+    db_buffer built = db_builder_finish(&builder);
+    TEST_ASSERT_EQUAL(2400, db_size(built));
+    db_reader reader = db_reader_new_range(built, 2396, 4);
+    TEST_ASSERT_EQUAL(599, db_read_uint32_le(reader));
+    db_reader_release(&reader);
+    
+    db_release(&request);
+    db_release(&path);
+    db_release(&line);
+    db_release(&built);
+    
+    db_arena_reset(arena);
+    TEST_ASSERT_EQUAL(0, db_arena_used(arena));
+    
+    db_buffer again = db_new_ex(16, a);
+    TEST_ASSERT_EQUAL(16, db_capacity(again));
+    db_release(&again);
+    
+    db_arena_release(&arena);
+    TEST_ASSERT_NULL(arena);
+}
+
+void test_db_pool_recycles_buffers(void) {
+    db_pool_config config = {4096, 2, 3, 0};
+    db_pool pool = db_pool_new(&config);
+    TEST_ASSERT_EQUAL(2, db_pool_idle(pool));
+    
+    db_buffer buf = db_pool_acquire(pool);
+    TEST_ASSERT_EQUAL(0, db_size(buf));
+    TEST_ASSERT_EQUAL(4096, db_capacity(buf));
+    TEST_ASSERT_EQUAL(1, db_pool_idle(pool));
+    TEST_ASSERT_EQUAL(0, db_append_inplace(&buf, "data", 4));
+    
+    // Release hands the block back, and the next acquire reuses it
+    db_buffer first = buf;
+    db_release(&buf);
+    TEST_ASSERT_EQUAL(2, db_pool_idle(pool));
+    buf = db_pool_acquire(pool);
+    TEST_ASSERT_EQUAL_PTR(first, buf);
+    TEST_ASSERT_EQUAL(0, db_size(buf));
+    db_release(&buf);
+    
+    // Idle blocks are capped at the high watermark
+    db_buffer many[5];
+    for (int i = 0; i < 5; i++) many[i] = db_pool_acquire(pool);
+    TEST_ASSERT_EQUAL(0, db_pool_idle(pool));
+    for (int i = 0; i < 5; i++) db_release(&many[i]);
+    TEST_ASSERT_EQUAL(3, db_pool_idle(pool));
+    db_pool_trim(pool);
+    TEST_ASSERT_EQUAL(2, db_pool_idle(pool));
+    
+    // Growing past the pool capacity returns the pool block right away
+    buf = db_pool_acquire(pool);
+    char big[5000] = {0};
+    TEST_ASSERT_EQUAL(0, db_append_inplace(&buf, big, sizeof(big)));
+    TEST_ASSERT_EQUAL(2, db_pool_idle(pool));
+    db_release(&buf);
+    TEST_ASSERT_EQUAL(2, db_pool_idle(pool));
+    
+    db_pool_release(&pool);
+    TEST_ASSERT_NULL(pool);
+}
+
+void test_db_pool_thread_cache(void) {
+    db_pool_config config = {256, 0, 1, 2};
+    db_pool pool = db_pool_new(&config);
+    TEST_ASSERT_EQUAL(0, db_pool_idle(pool));
+    
+    db_buffer bufs[4];
+    for (int i = 0; i < 4; i++) bufs[i] = db_pool_acquire(pool);
+    for (int i = 0; i < 4; i++) db_release(&bufs[i]);
+    TEST_ASSERT_EQUAL(3, db_pool_idle(pool));  // 2 cached by this thread + 1 shared
+    
+    // A second pool takes over this thread's cache
+    db_pool other = db_pool_new(&config);
+    db_buffer buf = db_pool_acquire(other);
+    db_release(&buf);
+    TEST_ASSERT_EQUAL(1, db_pool_idle(pool));
+    TEST_ASSERT_EQUAL(1, db_pool_idle(other));
+    
+    db_pool_trim_thread();
+    TEST_ASSERT_EQUAL(0, db_pool_idle(other));
+    db_pool_release(&other);
+    db_pool_release(&pool);
+}
+
 // Test reference counting
 void test_db_retain_increases_refcount(void) {
     db_buffer buf = db_new(10);
@@ -98,6 +330,49 @@ void test_db_retain_increases_refcount(void) {
     db_release(&buf2);
 }
 
+#if DB_ATOMIC_REFCOUNT
+static void* retain_release_worker(void* arg) {
+    db_buffer buf = (db_buffer)arg;
+    for (int i = 0; i < 100000; i++) {
+        db_buffer ref = db_retain(buf);
+        db_release(&ref);
+    }
+    return NULL;
+}
+#endif
+
+void test_db_share_switches_to_atomic_refcount(void) {
+    db_buffer buf = db_new_with_data("shared", 6);
+    TEST_ASSERT_EQUAL(DB_ATOMIC_REFCOUNT && !DB_LOCAL_REFCOUNT, db_is_shared(buf));
+    
+    // Local counting behaves exactly like the atomic kind on one thread
+    db_buffer ref = db_retain(buf);
+    TEST_ASSERT_EQUAL(2, db_refcount(buf));
+    db_release(&ref);
+    TEST_ASSERT_EQUAL(1, db_refcount(buf));
+    
+    TEST_ASSERT_EQUAL_PTR(buf, db_share(buf));
+    TEST_ASSERT_EQUAL(DB_ATOMIC_REFCOUNT, db_is_shared(buf));
+    db_share(buf);  // Sharing twice is harmless
+    
+    // Copies made for writing belong to the writing thread again
+    db_buffer copy = db_slice(buf, 1, 3);
+    TEST_ASSERT_EQUAL(DB_ATOMIC_REFCOUNT && !DB_LOCAL_REFCOUNT, db_is_shared(copy));
+    db_release(&copy);
+    
+#if DB_ATOMIC_REFCOUNT
+    pthread_t threads[4];
+    for (int i = 0; i < 4; i++) {
+        TEST_ASSERT_EQUAL(0, pthread_create(&threads[i], NULL, retain_release_worker, buf));
+    }
+    for (int i = 0; i < 4; i++) {
+        pthread_join(threads[i], NULL);
+    }
+#endif
+    TEST_ASSERT_EQUAL(1, db_refcount(buf));
+    db_release(&buf);
+}
+
 // test_db_retain_handles_null removed - db_retain now requires non-NULL buffer
 
 void test_db_release_handles_null(void) {
@@ -187,6 +462,23 @@ void test_db_slice_to_creates_prefix(void) {
     db_release(&buf);
 }
 
+void test_db_slice_full_range_shares_buffer(void) {
+    db_buffer buf = db_new_with_data("Hello", 5);
+    
+    db_buffer whole = db_slice(buf, 0, 5);
+    TEST_ASSERT_EQUAL(buf, whole);
+    TEST_ASSERT_EQUAL(2, db_refcount(buf));
+    
+    db_buffer suffix = db_slice_from(buf, 0);
+    TEST_ASSERT_EQUAL(buf, suffix);
+    TEST_ASSERT_EQUAL(3, db_refcount(buf));
+    
+    db_release(&whole);
+    db_release(&suffix);
+    TEST_ASSERT_EQUAL(1, db_refcount(buf));
+    db_release(&buf);
+}
+
 // Test buffer modification
 // Mutable operation tests removed - buffers are now immutable
 
@@ -239,6 +531,44 @@ void test_db_append_works_with_shared_buffer(void) {
     db_release(&buf3);
 }
 
+void test_db_append_inplace_grows_unique_buffer(void) {
+    db_buffer buf = db_new_with_data("ab", 2);
+    
+    TEST_ASSERT_EQUAL(0, db_append_inplace(&buf, "cde", 3));
+    TEST_ASSERT_EQUAL(5, db_size(buf));
+    TEST_ASSERT(db_capacity(buf) > 5);  // Geometric spare capacity
+    
+    // Spare capacity is used without moving the buffer
+    db_buffer before = buf;
+    size_t spare = db_capacity(buf) - db_size(buf);
+    for (size_t i = 0; i < spare; i++) {
+        TEST_ASSERT_EQUAL(0, db_append_inplace(&buf, "x", 1));
+    }
+    TEST_ASSERT_EQUAL_PTR(before, buf);
+    TEST_ASSERT_EQUAL_MEMORY("abcdex", buf, 6);
+    TEST_ASSERT_EQUAL(1, db_refcount(buf));
+    
+    db_release(&buf);
+}
+
+void test_db_append_inplace_copies_shared_buffer(void) {
+    db_buffer buf = db_new(64);
+    TEST_ASSERT_EQUAL(0, db_append_inplace(&buf, "Hello", 5));
+    db_buffer shared = db_retain(buf);
+    
+    TEST_ASSERT_EQUAL(0, db_append_inplace(&buf, " World", 6));
+    TEST_ASSERT(buf != shared);
+    TEST_ASSERT_EQUAL_MEMORY("Hello World", buf, 11);
+    
+    // Other holder still sees the original contents
+    TEST_ASSERT_EQUAL(5, db_size(shared));
+    TEST_ASSERT_EQUAL(1, db_refcount(shared));
+    TEST_ASSERT_EQUAL(1, db_refcount(buf));
+    
+    db_release(&buf);
+    db_release(&shared);
+}
+
 // test_db_clear_empties_buffer removed - db_clear no longer exists (buffers are immutable)
 
 // Test concatenation
@@ -307,6 +637,166 @@ void test_db_compare_returns_correct_order(void) {
     db_release(&buf3);
 }
 
+void test_db_mismatch_finds_first_difference(void) {
+    char data[70];
+    for (size_t i = 0; i < sizeof(data); i++) data[i] = (char)('a' + i % 26);
+    db_buffer base = db_new_with_data(data, sizeof(data));
+    
+    // Every position, so SIMD blocks, word steps and the byte tail are all hit
+    for (size_t at = 0; at < sizeof(data); at++) {
+        char changed[70];
+        memcpy(changed, data, sizeof(data));
+        changed[at] ^= 0x20;
+        db_buffer other = db_new_with_data(changed, sizeof(changed));
+        TEST_ASSERT_EQUAL(at, db_mismatch(base, other));
+        TEST_ASSERT_EQUAL(at, db_mismatch(other, base));
+        db_release(&other);
+    }
+    
+    // Prefixes and identical buffers give the shorter size
+    db_buffer prefix = db_new_with_data(data, 40);
+    TEST_ASSERT_EQUAL(40, db_mismatch(base, prefix));
+    TEST_ASSERT_EQUAL(70, db_mismatch(base, base));
+    db_buffer empty = db_new(0);
+    TEST_ASSERT_EQUAL(0, db_mismatch(base, empty));
+    
+    db_release(&empty);
+    db_release(&prefix);
+    db_release(&base);
+}
+
+static size_t naive_find(const char* data, size_t size, size_t offset, const char* needle, size_t needle_size) {
+    for (size_t i = offset; i + needle_size <= size; i++) {
+        if (memcmp(data + i, needle, needle_size) == 0) return i;
+    }
+    return DB_NOT_FOUND;
+}
+
+void test_db_find_matches_naive_search(void) {
+    // Small alphabet so partial matches are common; long enough for SIMD blocks
+    char data[300];
+    uint32_t seed = 12345;
+    for (size_t i = 0; i < sizeof(data); i++) {
+        seed = seed * 1103515245u + 12345u;
+        data[i] = (char)('a' + (seed >> 16) % 3);
+    }
+    db_buffer buf = db_new_with_data(data, sizeof(data));
+    
+    for (size_t needle_size = 1; needle_size <= 12; needle_size++) {
+        for (size_t start = 0; start + needle_size <= sizeof(data); start += 37) {
+            const char* needle = data + start;
+            for (size_t offset = 0; offset < sizeof(data); offset += 29) {
+                TEST_ASSERT_EQUAL(naive_find(data, sizeof(data), offset, needle, needle_size),
+                                  db_find(buf, offset, needle, needle_size));
+            }
+        }
+    }
+    TEST_ASSERT_EQUAL(DB_NOT_FOUND, db_find(buf, 0, "d", 1));
+    TEST_ASSERT_EQUAL(5, db_find(buf, 5, "", 0));
+    
+    // Byte and set searches
+    TEST_ASSERT_EQUAL(naive_find(data, sizeof(data), 10, "c", 1), db_find_byte(buf, 10, 'c'));
+    TEST_ASSERT_EQUAL(DB_NOT_FOUND, db_find_byte(buf, sizeof(data), 'a'));
+    db_release(&buf);
+    
+    char text[100];
+    memset(text, 'x', sizeof(text));
+    text[70] = '\n';
+    text[90] = '\r';
+    buf = db_new_with_data(text, sizeof(text));
+    TEST_ASSERT_EQUAL(70, db_find_any(buf, 0, "\r\n", 2));
+    TEST_ASSERT_EQUAL(90, db_find_any(buf, 71, "\r\n", 2));
+    TEST_ASSERT_EQUAL(DB_NOT_FOUND, db_find_any(buf, 91, "\r\n", 2));
+    TEST_ASSERT_EQUAL(70, db_find_any(buf, 0, "\n\r0123456789abcdefghij", 22));  // Table path
+    db_release(&buf);
+}
+
+void test_db_split_iterates_pieces(void) {
+    db_buffer buf = db_new_with_data("GET / HTTP/1.1\r\nHost: x\r\n\r\nbody", 31);
+    const char* expected[] = {"GET / HTTP/1.1", "Host: x", "", "body"};
+    
+    db_split split;
+    db_split_init(&split, buf, "\r\n", 2);
+    const char* piece;
+    size_t size;
+    size_t count = 0;
+    while (db_split_next(&split, &piece, &size)) {
+        TEST_ASSERT_TRUE(count < 4);
+        TEST_ASSERT_EQUAL(strlen(expected[count]), size);
+        if (size) TEST_ASSERT_EQUAL_MEMORY(expected[count], piece, size);
+        TEST_ASSERT_TRUE(piece >= buf && piece + size <= buf + db_size(buf));  // In place
+        count++;
+    }
+    TEST_ASSERT_EQUAL(4, count);
+    TEST_ASSERT_FALSE(db_split_next(&split, &piece, &size));
+    
+    // A trailing delimiter yields a final empty piece
+    db_buffer lines = db_new_with_data("a\nb\n", 4);
+    db_split_init(&split, lines, "\n", 1);
+    count = 0;
+    while (db_split_next(&split, &piece, &size)) count++;
+    TEST_ASSERT_EQUAL(3, count);
+    TEST_ASSERT_EQUAL(0, size);
+    
+    db_release(&lines);
+    db_release(&buf);
+}
+
+void test_db_crc32c_known_vectors(void) {
+    db_buffer digits = db_new_with_data("123456789", 9);
+    TEST_ASSERT_EQUAL_HEX32(0xE3069283u, db_crc32c(digits));
+    db_release(&digits);
+    
+    // RFC 3720 B.4: 32 bytes of zeros
+    uint8_t zeros[32] = {0};
+    TEST_ASSERT_EQUAL_HEX32(0x8A9136AAu, db_crc32c_update(0, zeros, sizeof(zeros)));
+    
+    // Streaming in uneven pieces gives the same result
+    uint8_t data[1000];
+    for (size_t i = 0; i < sizeof(data); i++) data[i] = (uint8_t)(i * 7 + 3);
+    uint32_t crc = 0;
+    for (size_t i = 0; i < sizeof(data); i += 13) {
+        crc = db_crc32c_update(crc, data + i, i + 13 <= sizeof(data) ? 13 : sizeof(data) - i);
+    }
+    TEST_ASSERT_EQUAL_HEX32(db_crc32c_update(0, data, sizeof(data)), crc);
+}
+
+void test_db_hash_matches_xxh64(void) {
+    TEST_ASSERT_EQUAL_HEX64(0xEF46DB3751D8E999ull, db_xxhash64("", 0, 0));
+    TEST_ASSERT_EQUAL_HEX64(0x44BC2CF5AD770999ull, db_xxhash64("abc", 3, 0));
+    TEST_ASSERT_EQUAL_HEX64(0x0B242D361FDA71BCull,
+                            db_xxhash64("The quick brown fox jumps over the lazy dog", 43, 0));
+    
+    uint8_t data[1000];
+    for (size_t i = 0; i < sizeof(data); i++) data[i] = (uint8_t)(i * 7 + 3);
+    TEST_ASSERT_EQUAL_HEX64(0x5F235FA033F1A3FBull, db_xxhash64(data, sizeof(data), 0));
+    TEST_ASSERT_EQUAL_HEX64(0x1353F82A690FA165ull, db_xxhash64(data, 37, 12345));
+    
+    // db_hash is stable and follows in-place changes
+    db_buffer buf = db_new(64);
+    TEST_ASSERT_EQUAL(0, db_append_inplace(&buf, data, 37));
+    uint64_t first = db_hash(buf);
+    TEST_ASSERT_EQUAL_HEX64(db_xxhash64(data, 37, 0), first);
+    TEST_ASSERT_EQUAL_HEX64(first, db_hash(buf));
+    
+    db_buffer other = db_new_with_data(data, 37);
+    TEST_ASSERT_TRUE(db_equals(buf, other));
+    
+    TEST_ASSERT_EQUAL(0, db_append_inplace(&buf, "x", 1));
+    TEST_ASSERT_EQUAL_HEX64(db_xxhash64(buf, 38, 0), db_hash(buf));
+    
+    // Same size, different bytes, both hashed
+    db_buffer a = db_new_with_data("left", 4);
+    db_buffer b = db_new_with_data("righ", 4);
+    TEST_ASSERT_NOT_EQUAL(db_hash(a), db_hash(b));
+    TEST_ASSERT_FALSE(db_equals(a, b));
+    
+    db_release(&a);
+    db_release(&b);
+    db_release(&other);
+    db_release(&buf);
+}
+
 // Test utility functions
 void test_db_to_hex_converts_correctly(void) {
     uint8_t data[] = { 0x48, 0x65, 0x6C, 0x6C, 0x6F };  // "Hello"
@@ -341,6 +831,174 @@ void test_db_from_hex_handles_invalid_input(void) {
     TEST_ASSERT_NULL(db_from_hex(NULL, 10));         // NULL string
 }
 
+void test_db_hex_matches_reference_across_lengths(void) {
+    // Exercise SIMD blocks and scalar tails of every length
+    uint8_t data[300];
+    char expected[600];
+    const char* digits = "0123456789abcdef";
+    for (size_t i = 0; i < sizeof(data); i++) data[i] = (uint8_t)(i * 37 + 11);
+    
+    for (size_t len = 0; len <= sizeof(data); len += (len < 70 ? 1 : 23)) {
+        for (size_t i = 0; i < len; i++) {
+            expected[i * 2] = digits[data[i] >> 4];
+            expected[i * 2 + 1] = digits[data[i] & 0x0F];
+        }
+        db_buffer buf = db_new_with_data(data, len);
+        db_buffer hex = db_to_hex(buf, false);
+        TEST_ASSERT_EQUAL(len * 2, db_size(hex));
+        if (len) TEST_ASSERT_EQUAL_MEMORY(expected, hex, len * 2);
+        
+        db_buffer upper = db_to_hex(buf, true);
+        db_buffer back = db_from_hex(upper, db_size(upper));
+        TEST_ASSERT_NOT_NULL(back);
+        TEST_ASSERT_TRUE(db_equals(buf, back));
+        
+        db_release(&buf);
+        db_release(&hex);
+        db_release(&upper);
+        db_release(&back);
+    }
+}
+
+void test_db_from_hex_rejects_invalid_char_anywhere(void) {
+    char hex[200];
+    for (size_t i = 0; i < sizeof(hex); i++) hex[i] = "0aF9"[i % 4];
+    
+    db_buffer ok = db_from_hex(hex, sizeof(hex));
+    TEST_ASSERT_NOT_NULL(ok);
+    db_release(&ok);
+    
+    const char bad_chars[] = {'g', 'G', '/', ':', '@', '`', ' ', '\0', (char)0x80, (char)0xC6};
+    for (size_t pos = 0; pos < sizeof(hex); pos++) {
+        for (size_t b = 0; b < sizeof(bad_chars); b++) {
+            char saved = hex[pos];
+            hex[pos] = bad_chars[b];
+            TEST_ASSERT_NULL(db_from_hex(hex, sizeof(hex)));
+            hex[pos] = saved;
+        }
+    }
+}
+
+void test_db_base64_matches_rfc4648_vectors(void) {
+    const char* plain[] = {"", "f", "fo", "foo", "foob", "fooba", "foobar"};
+    const char* standard[] = {"", "Zg==", "Zm8=", "Zm9v", "Zm9vYg==", "Zm9vYmE=", "Zm9vYmFy"};
+    const char* url[] = {"", "Zg", "Zm8", "Zm9v", "Zm9vYg", "Zm9vYmE", "Zm9vYmFy"};
+    
+    db_buffer empty = db_from_base64("", 0, DB_BASE64_STANDARD);
+    TEST_ASSERT_NOT_NULL(empty);
+    TEST_ASSERT_EQUAL(0, db_size(empty));
+    db_buffer empty_text = db_to_base64(empty, DB_BASE64_STANDARD);
+    TEST_ASSERT_EQUAL(0, db_size(empty_text));
+    db_release(&empty_text);
+    db_release(&empty);
+    
+    for (size_t i = 1; i < 7; i++) {
+        db_buffer buf = db_new_with_data(plain[i], strlen(plain[i]));
+        db_buffer encoded = db_to_base64(buf, DB_BASE64_STANDARD);
+        TEST_ASSERT_EQUAL(strlen(standard[i]), db_size(encoded));
+        TEST_ASSERT_EQUAL_MEMORY(standard[i], encoded, db_size(encoded));
+        db_buffer encoded_url = db_to_base64(buf, DB_BASE64_URL);
+        TEST_ASSERT_EQUAL(strlen(url[i]), db_size(encoded_url));
+        TEST_ASSERT_EQUAL_MEMORY(url[i], encoded_url, db_size(encoded_url));
+        
+        // Padding is optional on input for either alphabet
+        db_buffer decoded = db_from_base64(standard[i], strlen(standard[i]), DB_BASE64_URL);
+        TEST_ASSERT_NOT_NULL(decoded);
+        TEST_ASSERT_TRUE(db_equals(buf, decoded));
+        db_release(&decoded);
+        decoded = db_from_base64(url[i], strlen(url[i]), DB_BASE64_STANDARD);
+        TEST_ASSERT_NOT_NULL(decoded);
+        TEST_ASSERT_TRUE(db_equals(buf, decoded));
+        
+        db_release(&decoded);
+        db_release(&encoded_url);
+        db_release(&encoded);
+        db_release(&buf);
+    }
+    
+    // The two alphabets differ only in sextets 62 and 63
+    db_buffer high = db_new_with_data("\xfb\xff\xbf", 3);
+    db_buffer text = db_to_base64(high, DB_BASE64_STANDARD);
+    TEST_ASSERT_EQUAL_MEMORY("+/+/", text, 4);
+    TEST_ASSERT_NULL(db_from_base64("-_-_", 4, DB_BASE64_STANDARD));
+    db_release(&text);
+    text = db_to_base64(high, DB_BASE64_URL);
+    TEST_ASSERT_EQUAL_MEMORY("-_-_", text, 4);
+    TEST_ASSERT_NULL(db_from_base64("+/+/", 4, DB_BASE64_URL));
+    db_release(&text);
+    db_release(&high);
+    
+    TEST_ASSERT_NULL(db_from_base64("Zm9vY", 5, DB_BASE64_STANDARD));  // Dangling sextet
+    TEST_ASSERT_NULL(db_from_base64("Zg=v", 4, DB_BASE64_STANDARD));   // Padding mid-group
+    TEST_ASSERT_NULL(db_from_base64("Zm 9v", 5, DB_BASE64_STANDARD));
+    TEST_ASSERT_NULL(db_from_base64(NULL, 0, DB_BASE64_STANDARD));
+}
+
+void test_db_base64_roundtrips_across_lengths(void) {
+    // Long enough for the SIMD blocks plus every tail length
+    uint8_t data[300];
+    for (size_t i = 0; i < sizeof(data); i++) data[i] = (uint8_t)(i * 97 + 13);
+    
+    for (size_t len = 0; len <= sizeof(data); len++) {
+        db_buffer buf = db_new_with_data(data, len);
+        for (int alphabet = DB_BASE64_STANDARD; alphabet <= DB_BASE64_URL; alphabet++) {
+            db_buffer text = db_to_base64(buf, (db_base64_alphabet)alphabet);
+            db_buffer back = db_from_base64(text, db_size(text), (db_base64_alphabet)alphabet);
+            TEST_ASSERT_NOT_NULL(back);
+            TEST_ASSERT_TRUE(db_equals(buf, back));
+            
+            // A bad character anywhere is caught, inside or outside SIMD blocks
+            if (len % 37 == 0 && db_size(text) > 0) {
+                for (size_t pos = 0; pos < db_size(text); pos += 7) {
+                    char saved = text[pos];
+                    text[pos] = (char)0xC6;
+                    TEST_ASSERT_NULL(db_from_base64(text, db_size(text), (db_base64_alphabet)alphabet));
+                    text[pos] = saved;
+                }
+            }
+            db_release(&back);
+            db_release(&text);
+        }
+        db_release(&buf);
+    }
+}
+
+void test_builder_append_base64_streams(void) {
+    uint8_t data[200];
+    for (size_t i = 0; i < sizeof(data); i++) data[i] = (uint8_t)(i * 31 + 7);
+    db_buffer whole = db_new_with_data(data, sizeof(data));
+    db_buffer expected = db_to_base64(whole, DB_BASE64_URL);
+    
+    // Pieces of 1..5 bytes leave every possible partial group behind
+    db_builder builder = db_builder_new(0);
+    TEST_ASSERT_EQUAL(0, db_builder_append_cstring(builder, "token="));
+    db_base64_stream stream = DB_BASE64_STREAM_INIT(DB_BASE64_URL);
+    size_t offset = 0;
+    for (size_t piece = 1; offset < sizeof(data); piece = piece % 5 + 1) {
+        size_t n = piece < sizeof(data) - offset ? piece : sizeof(data) - offset;
+        TEST_ASSERT_EQUAL(0, db_builder_append_base64(builder, &stream, data + offset, n));
+        offset += n;
+    }
+    TEST_ASSERT_EQUAL(0, db_builder_flush_base64(builder, &stream));
+    TEST_ASSERT_EQUAL(0, stream.pending_size);
+    db_buffer built = db_builder_finish(&builder);
+    TEST_ASSERT_EQUAL(6 + db_size(expected), db_size(built));
+    TEST_ASSERT_EQUAL_MEMORY("token=", built, 6);
+    TEST_ASSERT_EQUAL_MEMORY(expected, built + 6, db_size(expected));
+    db_release(&built);
+    
+    // Without a stream the data is one padded message
+    builder = db_builder_new(0);
+    TEST_ASSERT_EQUAL(0, db_builder_append_base64(builder, NULL, "fooba", 5));
+    built = db_builder_finish(&builder);
+    TEST_ASSERT_EQUAL(8, db_size(built));
+    TEST_ASSERT_EQUAL_MEMORY("Zm9vYmE=", built, 8);
+    
+    db_release(&built);
+    db_release(&expected);
+    db_release(&whole);
+}
+
 void test_db_debug_print_doesnt_crash(void) {
     db_buffer buf = db_new_with_data("Hello", 5);
     
@@ -352,6 +1010,46 @@ void test_db_debug_print_doesnt_crash(void) {
     db_release(&buf);
 }
 
+void test_db_stats_counts_allocations_and_copies(void) {
+    db_stats_reset();
+    db_stats before = db_stats_snapshot();
+    
+    db_buffer buf = db_new_with_data("Hello, World!", 13);
+    db_buffer slice = db_slice(buf, 0, 5);
+    db_buffer joined = db_concat(buf, slice);
+    db_buffer shared = db_retain(buf);
+    TEST_ASSERT_EQUAL(0, db_append_inplace(&shared, "!", 1));  // Copy-on-write, then growth
+    
+    db_stats during = db_stats_snapshot();
+    db_release(&buf);
+    db_release(&slice);
+    db_release(&joined);
+    db_release(&shared);
+    db_stats after = db_stats_snapshot();
+    
+#if DB_STATS
+    TEST_ASSERT_EQUAL_UINT64(4, after.allocations);
+    TEST_ASSERT_EQUAL_UINT64(4, after.frees);
+    TEST_ASSERT_EQUAL_UINT64(1, after.cow_copies);
+    TEST_ASSERT_TRUE(after.reallocs >= 1);
+    TEST_ASSERT_EQUAL_UINT64(5 + 18 + 13, after.bytes_copied);  // slice + concat + copy-on-write
+    TEST_ASSERT_TRUE(during.live_bytes - before.live_bytes >= 13 + 5 + 18 + 14);
+    TEST_ASSERT_EQUAL_INT64(before.live_bytes, after.live_bytes);
+    TEST_ASSERT_EQUAL_INT64(during.peak_live_bytes, after.peak_live_bytes);
+    
+    db_stats_reset();
+    db_stats cleared = db_stats_snapshot();
+    TEST_ASSERT_EQUAL_UINT64(0, cleared.allocations);
+    TEST_ASSERT_EQUAL_UINT64(0, cleared.bytes_copied);
+    TEST_ASSERT_EQUAL_INT64(after.live_bytes, cleared.peak_live_bytes);
+#else
+    TEST_ASSERT_EQUAL_UINT64(0, before.allocations);
+    TEST_ASSERT_EQUAL_UINT64(0, during.allocations);
+    TEST_ASSERT_EQUAL_UINT64(0, after.bytes_copied);
+    TEST_ASSERT_EQUAL_INT64(0, after.peak_live_bytes);
+#endif
+}
+
 // Test edge cases and error conditions
 
 void test_large_buffer_operations(void) {
@@ -451,6 +1149,16 @@ void test_builder_from_buffer(void) {
     
     db_release(&buf);
     db_release(&result);
+    
+    // A source buffer with spare capacity must not lend it to the copy
+    db_buffer roomy = db_new(64);
+    TEST_ASSERT_EQUAL(0, db_append_inplace(&roomy, "abc", 3));
+    builder = db_builder_from_buffer(roomy);
+    TEST_ASSERT_EQUAL(0, db_builder_append(builder, "defghijklmnop", 13));
+    result = db_builder_finish(&builder);
+    TEST_ASSERT_EQUAL_MEMORY("abcdefghijklmnop", result, 16);
+    db_release(&roomy);
+    db_release(&result);
 }
 
 void test_builder_clear_operations(void) {
@@ -471,6 +1179,52 @@ void test_builder_clear_operations(void) {
     db_release(&buf);
 }
 
+void test_builder_clear_reuses_buffer(void) {
+    db_builder builder = db_builder_new(64);
+    char* first = (char*)db_builder_reserve(builder, 0);
+    
+    for (int i = 0; i < 3; i++) {
+        TEST_ASSERT_EQUAL(0, db_builder_append_cstring(builder, "message"));
+        db_builder_clear(builder);
+        TEST_ASSERT_EQUAL(0, db_builder_size(builder));
+        TEST_ASSERT_EQUAL(64, db_builder_capacity(builder));
+    }
+    
+    // Same storage every round, no reallocation
+    TEST_ASSERT_EQUAL_PTR(first, db_builder_reserve(builder, 0));
+    db_builder_release(&builder);
+}
+
+void test_builder_from_buffer_take(void) {
+    // Unique buffer is adopted as-is, spare capacity included
+    db_buffer buf = db_new(32);
+    TEST_ASSERT_EQUAL(0, db_append_inplace(&buf, "abc", 3));
+    db_buffer original = buf;
+    
+    db_builder builder = db_builder_from_buffer_take(&buf);
+    TEST_ASSERT_NULL(buf);
+    TEST_ASSERT_EQUAL(32, db_builder_capacity(builder));
+    TEST_ASSERT_EQUAL(0, db_builder_append(builder, "de", 2));
+    
+    db_buffer result = db_builder_finish(&builder);
+    TEST_ASSERT_EQUAL_PTR(original, result);
+    TEST_ASSERT_EQUAL_MEMORY("abcde", result, 5);
+    
+    // Shared buffer is copied and the other holder is left alone
+    db_buffer other = db_retain(result);
+    builder = db_builder_from_buffer_take(&result);
+    TEST_ASSERT_NULL(result);
+    TEST_ASSERT_EQUAL(1, db_refcount(other));
+    TEST_ASSERT_EQUAL(0, db_builder_append(builder, "f", 1));
+    
+    result = db_builder_finish(&builder);
+    TEST_ASSERT_EQUAL_MEMORY("abcdef", result, 6);
+    TEST_ASSERT_EQUAL(5, db_size(other));
+    
+    db_release(&result);
+    db_release(&other);
+}
+
 // Reader API Tests
 
 void test_reader_basic_operations(void) {
@@ -566,6 +1320,105 @@ void test_reader_seek_operations(void) {
     db_release(&buf);
 }
 
+void test_reader_range_reads_in_place(void) {
+    uint8_t test_data[] = {0x00, 0x00, 0x00, 0x02, 0xAB, 0xCD, 0xFF};
+    db_buffer buf = db_new_with_data(test_data, sizeof(test_data));
+    
+    // Frame payload: 2 bytes starting at offset 4
+    db_reader frame = db_reader_new_range(buf, 4, 2);
+    TEST_ASSERT_NOT_NULL(frame);
+    TEST_ASSERT_EQUAL(2, db_refcount(buf));  // Reader retains the parent
+    TEST_ASSERT_EQUAL(0, db_reader_position(frame));
+    TEST_ASSERT_EQUAL(2, db_reader_remaining(frame));
+    TEST_ASSERT_EQUAL(0xABCD, db_read_uint16_be(frame));
+    TEST_ASSERT_FALSE(db_reader_can_read(frame, 1));
+    
+    db_reader_seek(frame, 1);
+    TEST_ASSERT_EQUAL(0xCD, db_read_uint8(frame));
+    
+    // Out of bounds ranges are rejected
+    TEST_ASSERT_NULL(db_reader_new_range(buf, 8, 0));
+    TEST_ASSERT_NULL(db_reader_new_range(buf, 4, 4));
+    
+    db_reader_release(&frame);
+    TEST_ASSERT_EQUAL(1, db_refcount(buf));
+    db_release(&buf);
+}
+
+void test_reader_borrowed_reads(void) {
+    db_buffer buf = db_new_with_data("\x05hello\x05world", 12);
+    db_reader reader = db_reader_new(buf);
+    
+    // Peek doesn't move, borrow points into the buffer and advances
+    const uint8_t* prefix = (const uint8_t*)db_reader_peek(reader, 1);
+    TEST_ASSERT_EQUAL_PTR(buf, prefix);
+    TEST_ASSERT_EQUAL(0, db_reader_position(reader));
+    
+    size_t length = db_read_uint8(reader);
+    const char* field = (const char*)db_read_borrow(reader, length);
+    TEST_ASSERT_EQUAL_PTR(buf + 1, field);
+    TEST_ASSERT_EQUAL_MEMORY("hello", field, 5);
+    
+    // Slices of part of the buffer are copies that outlive the reader
+    length = db_read_uint8(reader);
+    db_buffer word = db_read_slice(reader, length);
+    TEST_ASSERT_EQUAL(5, db_size(word));
+    TEST_ASSERT_EQUAL_MEMORY("world", word, 5);
+    
+    // Running past the end gives NULL and consumes nothing
+    TEST_ASSERT_NULL(db_reader_peek(reader, 1));
+    TEST_ASSERT_NULL(db_read_borrow(reader, 1));
+    TEST_ASSERT_NULL(db_read_slice(reader, 1));
+    TEST_ASSERT_EQUAL(12, db_reader_position(reader));
+    db_reader_release(&reader);
+    
+    // A slice covering the whole buffer shares it
+    reader = db_reader_new(buf);
+    db_buffer whole = db_read_slice(reader, 12);
+    TEST_ASSERT_EQUAL_PTR(buf, whole);
+    TEST_ASSERT_EQUAL(3, db_refcount(buf));
+    db_reader_release(&reader);
+    
+    db_release(&whole);
+    db_release(&word);
+    db_release(&buf);
+}
+
+void test_cursor_unchecked_reads(void) {
+    db_builder builder = db_builder_new(0);
+    for (uint32_t i = 0; i < 10; i++) {
+        TEST_ASSERT_EQUAL(0, db_builder_append_uint32_le(builder, i));
+        TEST_ASSERT_EQUAL(0, db_builder_append_uint16_be(builder, (uint16_t)(i * 3)));
+        TEST_ASSERT_EQUAL(0, db_builder_append_uint64_be(builder, (uint64_t)i << 40));
+    }
+    TEST_ASSERT_EQUAL(0, db_builder_append_cstring(builder, "end"));
+    db_buffer buf = db_builder_finish(&builder);
+    
+    db_cursor c = db_cursor_from_buffer(buf);
+    TEST_ASSERT_EQUAL(db_size(buf), db_cursor_remaining(&c));
+    for (uint32_t i = 0; db_cursor_has(&c, 14); i++) {
+        TEST_ASSERT_EQUAL_UINT32(i, db_cursor_read_uint32_le(&c));
+        TEST_ASSERT_EQUAL_UINT16(i * 3, db_cursor_read_uint16_be(&c));
+        TEST_ASSERT_EQUAL_UINT64((uint64_t)i << 40, db_cursor_read_uint64_be(&c));
+    }
+    TEST_ASSERT_EQUAL_MEMORY("end", db_cursor_read_ptr(&c, 3), 3);
+    TEST_ASSERT_EQUAL(0, db_cursor_remaining(&c));
+    
+    // Cursor from a reader starts at its position and hands progress back
+    db_reader reader = db_reader_new_range(buf, 14, 14);
+    db_read_uint32_le(reader);
+    c = db_reader_cursor(reader);
+    TEST_ASSERT_EQUAL(4, db_cursor_position(&c));
+    TEST_ASSERT_EQUAL_UINT16(3, db_cursor_read_uint16_be(&c));
+    db_cursor_skip(&c, 8);
+    TEST_ASSERT_FALSE(db_cursor_has(&c, 1));
+    db_reader_seek(reader, db_cursor_position(&c));
+    TEST_ASSERT_EQUAL(0, db_reader_remaining(reader));
+    
+    db_reader_release(&reader);
+    db_release(&buf);
+}
+
 void test_builder_reader_roundtrip(void) {
     // Build a complex buffer
     db_builder builder = db_builder_new(64);
@@ -593,6 +1446,122 @@ void test_builder_reader_roundtrip(void) {
     db_release(&buf);
 }
 
+void test_varint_roundtrip(void) {
+    const uint64_t unsigned_values[] = {
+        0, 1, 127, 128, 300, 16383, 16384, (1ull << 35) - 1, 1ull << 56, (1ull << 63) - 1, 1ull << 63, UINT64_MAX
+    };
+    const int64_t signed_values[] = {0, -1, 1, -64, 64, INT64_MIN, INT64_MAX};
+    const size_t unsigned_count = sizeof(unsigned_values) / sizeof(unsigned_values[0]);
+    const size_t signed_count = sizeof(signed_values) / sizeof(signed_values[0]);
+    
+    db_builder builder = db_builder_new(0);
+    for (size_t i = 0; i < unsigned_count; i++) {
+        TEST_ASSERT_EQUAL(0, db_builder_append_varint_u64(builder, unsigned_values[i]));
+    }
+    for (size_t i = 0; i < signed_count; i++) {
+        TEST_ASSERT_EQUAL(0, db_builder_append_varint_s64(builder, signed_values[i]));
+    }
+    db_buffer buf = db_builder_finish(&builder);
+    
+    // Known encodings: 300 -> ac 02, zigzag(-1) -> 01, UINT64_MAX is 10 bytes
+    TEST_ASSERT_EQUAL_MEMORY("\x00\x01\x7f\x80\x01\xac\x02", buf, 7);
+    
+    // Values near the end go through the bounds-checked path
+    db_reader reader = db_reader_new(buf);
+    for (size_t i = 0; i < unsigned_count; i++) {
+        TEST_ASSERT_EQUAL_UINT64(unsigned_values[i], db_read_varint_u64(reader));
+    }
+    for (size_t i = 0; i < signed_count; i++) {
+        TEST_ASSERT_EQUAL_INT64(signed_values[i], db_read_varint_s64(reader));
+    }
+    TEST_ASSERT_EQUAL(0, db_reader_remaining(reader));
+    
+    db_reader_release(&reader);
+    db_release(&buf);
+}
+
+void test_read_varints_bulk(void) {
+    uint64_t expected[100];
+    db_builder builder = db_builder_new(0);
+    for (size_t i = 0; i < 100; i++) {
+        // Runs of single-byte values broken up by longer ones
+        expected[i] = (i % 23 == 22) ? (uint64_t)i << 40 : i % 100;
+        TEST_ASSERT_EQUAL(0, db_builder_append_varint_u64(builder, expected[i]));
+    }
+    TEST_ASSERT_EQUAL(0, db_builder_append_uint8(builder, 0x80));  // Truncated trailer
+    db_buffer buf = db_builder_finish(&builder);
+    
+    uint64_t values[101];
+    db_reader reader = db_reader_new(buf);
+    TEST_ASSERT_EQUAL(100, db_read_varints_u64(reader, values, 101));
+    TEST_ASSERT_EQUAL_UINT64_ARRAY(expected, values, 100);
+    TEST_ASSERT_EQUAL(1, db_reader_remaining(reader));  // Stopped in front of it
+    db_reader_release(&reader);
+    db_release(&buf);
+    
+    // An eleven byte varint is rejected even with plenty of data left
+    db_buffer bad = db_new_with_data("\xff\xff\xff\xff\xff\xff\xff\xff\xff\x7f\x00\x00", 12);
+    reader = db_reader_new(bad);
+    TEST_ASSERT_EQUAL(0, db_read_varints_u64(reader, values, 1));
+    TEST_ASSERT_EQUAL(0, db_reader_position(reader));
+    db_reader_release(&reader);
+    db_release(&bad);
+}
+
+void test_typed_array_roundtrip(void) {
+    uint16_t u16[37];
+    uint32_t u32[37];
+    uint64_t u64[37];
+    for (size_t i = 0; i < 37; i++) {
+        u16[i] = (uint16_t)(0x0102 * (i + 1));
+        u32[i] = 0x01020304u * (uint32_t)(i + 1);
+        u64[i] = 0x0102030405060708ull * (i + 1);
+    }
+    
+    // Odd count exercises SIMD blocks and the scalar tail
+    db_builder builder = db_builder_new(0);
+    TEST_ASSERT_EQUAL(0, db_builder_append_uint16_le_array(builder, u16, 37));
+    TEST_ASSERT_EQUAL(0, db_builder_append_uint16_be_array(builder, u16, 37));
+    TEST_ASSERT_EQUAL(0, db_builder_append_uint32_le_array(builder, u32, 37));
+    TEST_ASSERT_EQUAL(0, db_builder_append_uint32_be_array(builder, u32, 37));
+    TEST_ASSERT_EQUAL(0, db_builder_append_uint64_le_array(builder, u64, 37));
+    TEST_ASSERT_EQUAL(0, db_builder_append_uint64_be_array(builder, u64, 37));
+    TEST_ASSERT_EQUAL(0, db_builder_append_uint32_be_array(builder, NULL, 0));
+    db_buffer buf = db_builder_finish(&builder);
+    TEST_ASSERT_EQUAL(37 * (2 + 2 + 4 + 4 + 8 + 8), db_size(buf));
+    
+    // Same bytes as the single-value readers
+    db_reader reader = db_reader_new(buf);
+    for (size_t i = 0; i < 37; i++) TEST_ASSERT_EQUAL_HEX16(u16[i], db_read_uint16_le(reader));
+    for (size_t i = 0; i < 37; i++) TEST_ASSERT_EQUAL_HEX16(u16[i], db_read_uint16_be(reader));
+    for (size_t i = 0; i < 37; i++) TEST_ASSERT_EQUAL_HEX32(u32[i], db_read_uint32_le(reader));
+    for (size_t i = 0; i < 37; i++) TEST_ASSERT_EQUAL_HEX32(u32[i], db_read_uint32_be(reader));
+    for (size_t i = 0; i < 37; i++) TEST_ASSERT_EQUAL_HEX64(u64[i], db_read_uint64_le(reader));
+    for (size_t i = 0; i < 37; i++) TEST_ASSERT_EQUAL_HEX64(u64[i], db_read_uint64_be(reader));
+    db_reader_release(&reader);
+    
+    uint16_t r16[37];
+    uint32_t r32[37];
+    uint64_t r64[37];
+    reader = db_reader_new(buf);
+    db_read_uint16_le_array(reader, r16, 37);
+    TEST_ASSERT_EQUAL_HEX16_ARRAY(u16, r16, 37);
+    db_read_uint16_be_array(reader, r16, 37);
+    TEST_ASSERT_EQUAL_HEX16_ARRAY(u16, r16, 37);
+    db_read_uint32_le_array(reader, r32, 37);
+    TEST_ASSERT_EQUAL_HEX32_ARRAY(u32, r32, 37);
+    db_read_uint32_be_array(reader, r32, 37);
+    TEST_ASSERT_EQUAL_HEX32_ARRAY(u32, r32, 37);
+    db_read_uint64_le_array(reader, r64, 37);
+    TEST_ASSERT_EQUAL_HEX64_ARRAY(u64, r64, 37);
+    db_read_uint64_be_array(reader, r64, 37);
+    TEST_ASSERT_EQUAL_HEX64_ARRAY(u64, r64, 37);
+    TEST_ASSERT_EQUAL(0, db_reader_remaining(reader));
+    db_reader_release(&reader);
+    
+    db_release(&buf);
+}
+
 // Missing core function tests
 void test_db_core_functions(void) {
     db_buffer buf = db_new_with_data("Hello", 5);
@@ -855,6 +1824,58 @@ void test_builder_capacity_growth(void) {
     db_release(&result);
 }
 
+void test_builder_growth_policy(void) {
+    db_growth_policy policy = {0};
+    policy.initial_capacity = 1000;
+    policy.growth_factor = 1.5;
+    policy.max_growth_step = 4096;
+    
+    db_builder builder = db_builder_new(0);
+    db_builder_set_policy(builder, &policy);
+    
+    // First growth jumps straight to the initial size, then 1.5x
+    TEST_ASSERT_EQUAL(0, db_builder_append_uint8(builder, 1));
+    TEST_ASSERT_EQUAL(1000, db_builder_capacity(builder));
+    TEST_ASSERT_NOT_NULL(db_builder_reserve(builder, 1000));
+    TEST_ASSERT_EQUAL(1500, db_builder_capacity(builder));
+    
+    // Large requests grow in capped steps instead of doubling
+    TEST_ASSERT_NOT_NULL(db_builder_reserve(builder, 20000));
+    TEST_ASSERT_TRUE(db_builder_capacity(builder) >= 20001);
+    TEST_ASSERT_TRUE(db_builder_capacity(builder) - 20001 < 4096);
+    
+    // Page rounding sizes the whole block, header included
+    policy.round_to_page = true;
+    db_builder_set_policy(builder, &policy);
+    TEST_ASSERT_NOT_NULL(db_builder_reserve(builder, 30000));
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    TEST_ASSERT_EQUAL(0, (db_builder_capacity(builder) + sizeof(db_internal)) % page);
+    
+    db_builder_release(&builder);
+}
+
+void test_builder_shrink_on_finish(void) {
+    db_growth_policy policy = {0};
+    policy.shrink_on_finish = true;
+    
+    db_builder builder = db_builder_new(256);
+    db_builder_set_policy(builder, &policy);
+    TEST_ASSERT_EQUAL(0, db_builder_append_cstring(builder, "compact"));
+    
+    db_buffer result = db_builder_finish(&builder);
+    TEST_ASSERT_EQUAL(7, db_size(result));
+    TEST_ASSERT_EQUAL(7, db_capacity(result));
+    TEST_ASSERT_EQUAL_MEMORY("compact", result, 7);
+    db_release(&result);
+    
+    // Default policy keeps the slack
+    builder = db_builder_new(256);
+    TEST_ASSERT_EQUAL(0, db_builder_append_cstring(builder, "slack"));
+    result = db_builder_finish(&builder);
+    TEST_ASSERT_EQUAL(256, db_capacity(result));
+    db_release(&result);
+}
+
 // I/O function tests
 void test_file_io_operations(void) {
     const char* test_filename = "/tmp/db_test_file.bin";
@@ -877,6 +1898,362 @@ void test_file_io_operations(void) {
     unlink(test_filename);
 }
 
+void test_db_read_file_sizes_buffer_exactly(void) {
+    const char* test_filename = "/tmp/db_test_exact.bin";
+    db_buffer data = db_new(100000);
+    memset(data, 'x', 100000);
+    db_meta(data)->size = 100000;
+    TEST_ASSERT_TRUE(db_write_file(data, test_filename));
+    
+    // The exact size hint must not trigger a growth pass to find EOF
+    db_buffer read_buf = db_read_file(test_filename);
+    TEST_ASSERT_NOT_NULL(read_buf);
+    TEST_ASSERT_EQUAL(100000, db_size(read_buf));
+    TEST_ASSERT_EQUAL(db_size(read_buf), db_capacity(read_buf));
+    TEST_ASSERT_TRUE(db_equals(data, read_buf));
+    db_release(&read_buf);
+    
+    db_buffer empty = db_new(0);
+    TEST_ASSERT_TRUE(db_write_file(empty, test_filename));
+    read_buf = db_read_file(test_filename);
+    TEST_ASSERT_NOT_NULL(read_buf);
+    TEST_ASSERT_EQUAL(0, db_size(read_buf));
+    TEST_ASSERT_EQUAL(0, db_capacity(read_buf));
+    
+    db_release(&read_buf);
+    db_release(&empty);
+    db_release(&data);
+    unlink(test_filename);
+}
+
+void test_db_map_file_maps_without_copy(void) {
+    const char* test_filename = "/tmp/db_test_map.bin";
+    db_builder builder = db_builder_new(0);
+    for (uint32_t i = 0; i < 5000; i++) {
+        TEST_ASSERT_EQUAL(0, db_builder_append_uint32_be(builder, i));
+    }
+    db_buffer original = db_builder_finish(&builder);
+    TEST_ASSERT_TRUE(db_write_file(original, test_filename));
+    
+    db_buffer mapped = db_map_file(test_filename, DB_MAP_SEQUENTIAL);
+    TEST_ASSERT_NOT_NULL(mapped);
+    TEST_ASSERT_EQUAL(db_size(original), db_size(mapped));
+    TEST_ASSERT_TRUE(db_equals(original, mapped));
+#if DB_HAVE_MMAP
+    TEST_ASSERT_TRUE(db_map_advise(mapped, 4097, 100, DB_MAP_RANDOM));
+#else
+    TEST_ASSERT_FALSE(db_map_advise(mapped, 4097, 100, DB_MAP_RANDOM));  // Read into the heap instead
+#endif
+    TEST_ASSERT_FALSE(db_map_advise(original, 0, 1, DB_MAP_RANDOM));
+    
+    // Sub-ranges read in place, growth works on a heap copy
+    db_reader reader = db_reader_new_range(mapped, 4 * 4999, 4);
+    TEST_ASSERT_EQUAL(4999, db_read_uint32_be(reader));
+    db_reader_release(&reader);
+    
+    db_buffer grown = db_retain(mapped);
+    TEST_ASSERT_EQUAL(0, db_append_inplace(&grown, "!", 1));
+    TEST_ASSERT_EQUAL(db_size(mapped) + 1, db_size(grown));
+    
+    db_release(&grown);
+    db_release(&mapped);
+    db_release(&original);
+    
+    // Empty and missing files
+    db_buffer empty = db_new(0);
+    TEST_ASSERT_TRUE(db_write_file(empty, test_filename));
+    db_buffer mapped_empty = db_map_file(test_filename, DB_MAP_NORMAL);
+    TEST_ASSERT_NOT_NULL(mapped_empty);
+    TEST_ASSERT_EQUAL(0, db_size(mapped_empty));
+    db_release(&mapped_empty);
+    db_release(&empty);
+    unlink(test_filename);
+    
+    TEST_ASSERT_NULL(db_map_file("/tmp/nonexistent_file_12345.bin", DB_MAP_NORMAL));
+}
+
+void test_db_file_stream_chunks_and_carries_records(void) {
+    const char* test_filename = "/tmp/db_test_stream.txt";
+    db_builder builder = db_builder_new(0);
+    for (int i = 0; i < 300; i++) {
+        char line[32];
+        int length = snprintf(line, sizeof(line), "record %d\n", i);
+        TEST_ASSERT_EQUAL(0, db_builder_append(builder, line, (size_t)length));
+    }
+    TEST_ASSERT_EQUAL(0, db_builder_append(builder, "x", 1));
+    for (int i = 0; i < 200; i++) {
+        TEST_ASSERT_EQUAL(0, db_builder_append(builder, "long", 4));  // Longer than a chunk
+    }
+    TEST_ASSERT_EQUAL(0, db_builder_append(builder, "\ntail", 5));
+    db_buffer original = db_builder_finish(&builder);
+    TEST_ASSERT_TRUE(db_write_file(original, test_filename));
+    
+    // Raw chunks are exactly chunk_size except the last one
+    db_file_stream_options options = {0};
+    options.chunk_size = 100;
+    db_file_stream stream = db_file_stream_open(test_filename, &options);
+    TEST_ASSERT_NOT_NULL(stream);
+    db_buffer chunk;
+    db_buffer joined = db_new(0);
+    while ((chunk = db_file_stream_next(stream)) != NULL) {
+        TEST_ASSERT_TRUE(db_size(chunk) == 100 || db_size(joined) + db_size(chunk) == db_size(original));
+        TEST_ASSERT_EQUAL(0, db_append_inplace(&joined, chunk, db_size(chunk)));
+        db_release(&chunk);
+    }
+    TEST_ASSERT_EQUAL(0, db_file_stream_error(stream));
+    TEST_ASSERT_EQUAL(db_size(original), db_file_stream_position(stream));
+    TEST_ASSERT_TRUE(db_equals(original, joined));
+    db_file_stream_release(&stream);
+    TEST_ASSERT_NULL(stream);
+    db_release(&joined);
+    
+    // With a delimiter every chunk but the last ends on a record boundary
+    db_pool_config config = {0};
+    config.buffer_capacity = 100;
+    db_pool pool = db_pool_new(&config);
+    options.delimiter = "\n";
+    options.delimiter_size = 1;
+    options.drop_behind = true;
+    options.pool = pool;
+    stream = db_file_stream_open(test_filename, &options);
+    joined = db_new(0);
+    size_t largest = 0;
+    while ((chunk = db_file_stream_next(stream)) != NULL) {
+        size_t size = db_size(chunk);
+        TEST_ASSERT_TRUE(size > 0);
+        if (db_size(joined) + size < db_size(original)) {
+            TEST_ASSERT_EQUAL_CHAR('\n', chunk[size - 1]);
+        }
+        if (size > largest) largest = size;
+        TEST_ASSERT_EQUAL(0, db_append_inplace(&joined, chunk, size));
+        TEST_ASSERT_EQUAL(db_size(joined), db_file_stream_position(stream));
+        db_release(&chunk);
+    }
+    TEST_ASSERT_TRUE(largest > 800);
+    TEST_ASSERT_TRUE(db_equals(original, joined));
+    db_file_stream_release(&stream);
+    db_release(&joined);
+    db_pool_release(&pool);
+    
+    // A descriptor that is already past a header streams from there on
+    int fd = open(test_filename, O_RDONLY);
+    TEST_ASSERT_TRUE(fd >= 0);
+    char header[10];
+    TEST_ASSERT_EQUAL(10, read(fd, header, sizeof(header)));
+    options = (db_file_stream_options){0};
+    options.chunk_size = 64;
+    options.drop_behind = true;
+    stream = db_file_stream_from_fd(fd, &options);
+    joined = db_new(0);
+    while ((chunk = db_file_stream_next(stream)) != NULL) {
+        TEST_ASSERT_EQUAL(0, db_append_inplace(&joined, chunk, db_size(chunk)));
+        TEST_ASSERT_EQUAL(db_size(joined), db_file_stream_position(stream));
+        db_release(&chunk);
+    }
+    TEST_ASSERT_EQUAL(db_size(original) - 10, db_size(joined));
+    TEST_ASSERT_EQUAL_MEMORY(original + 10, joined, db_size(joined));
+    db_file_stream_release(&stream);
+    TEST_ASSERT_EQUAL(0, close(fd));  // Still open: from_fd streams don't own the descriptor
+    db_release(&joined);
+    
+    db_release(&original);
+    unlink(test_filename);
+    TEST_ASSERT_NULL(db_file_stream_open("/tmp/nonexistent_file_12345.bin", NULL));
+}
+
+void test_db_read_fd_appends_stream(void) {
+    int fds[2];
+    TEST_ASSERT_EQUAL(0, pipe(fds));
+    
+    db_buffer buf = db_new(0);
+    char chunk[100];
+    memset(chunk, 'z', sizeof(chunk));
+    for (int i = 0; i < 10; i++) {
+        TEST_ASSERT_EQUAL(sizeof(chunk), write(fds[1], chunk, sizeof(chunk)));
+        TEST_ASSERT_EQUAL(sizeof(chunk), db_read_fd(&buf, fds[0], sizeof(chunk)));
+    }
+    TEST_ASSERT_EQUAL(1000, db_size(buf));
+    TEST_ASSERT_EQUAL('z', buf[999]);
+    
+    close(fds[1]);
+    TEST_ASSERT_EQUAL(0, db_read_fd(&buf, fds[0], 0));  // EOF
+    close(fds[0]);
+    db_release(&buf);
+}
+
+#if DB_IO_URING
+void test_uring_batched_reads_and_writes(void) {
+    db_uring ring = db_uring_new(8);
+    if (!ring) TEST_IGNORE_MESSAGE("io_uring not available");
+    
+    const char* filename = "test_uring.bin";
+    int fd = open(filename, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    TEST_ASSERT(fd >= 0);
+    
+    // Four writes at explicit offsets in one submission
+    for (int i = 0; i < 4; i++) {
+        char chunk[1000];
+        memset(chunk, 'a' + i, sizeof(chunk));
+        db_buffer buf = db_new_with_data(chunk, sizeof(chunk));
+        TEST_ASSERT_EQUAL(0, db_uring_write(ring, fd, &buf, (uint64_t)i * 1000, (void*)(intptr_t)i));
+        TEST_ASSERT_NULL(buf);  // Now owned by the ring
+    }
+    TEST_ASSERT_EQUAL(4, db_uring_submit(ring));
+    
+    db_uring_completion done[8];
+    size_t got = 0;
+    while (got < 4) got += db_uring_complete(ring, done + got, 8 - got, 4 - (unsigned)got);
+    for (size_t i = 0; i < 4; i++) {
+        TEST_ASSERT_EQUAL(DB_URING_WRITE, done[i].op);
+        TEST_ASSERT_EQUAL(1000, done[i].result);
+        db_release(&done[i].buf);
+    }
+    TEST_ASSERT_EQUAL(0, db_uring_pending(ring));
+    
+    // Reads append to the buffer's existing contents
+    db_buffer head = db_new_with_data("head:", 5);
+    db_buffer shared = db_retain(head);
+    TEST_ASSERT_EQUAL(0, db_uring_read(ring, fd, &head, 10, 1995, NULL));
+    db_buffer plain = db_new(0);
+    TEST_ASSERT_EQUAL(0, db_uring_read(ring, fd, &plain, 4000, 0, &plain));
+    TEST_ASSERT_EQUAL(2, db_uring_complete(ring, done, 8, 2));  // Submits the queued reads too
+    for (size_t i = 0; i < 2; i++) {
+        if (done[i].user == &plain) {
+            TEST_ASSERT_EQUAL(4000, done[i].result);
+            TEST_ASSERT_EQUAL(4000, db_size(done[i].buf));
+            TEST_ASSERT_EQUAL('a', done[i].buf[0]);
+            TEST_ASSERT_EQUAL('d', done[i].buf[3999]);
+        } else {
+            TEST_ASSERT_EQUAL(10, done[i].result);
+            TEST_ASSERT_EQUAL_MEMORY("head:bbbbbccccc", done[i].buf, 15);
+        }
+        db_release(&done[i].buf);
+    }
+    TEST_ASSERT_EQUAL(5, db_size(shared));  // The shared buffer was copied, not written
+    db_release(&shared);
+    
+    // Registered buffers from a pool
+    db_pool_config config = {4096, 0, 4, 0};
+    db_pool pool = db_pool_new(&config);
+    TEST_ASSERT_EQUAL(0, db_uring_register_pool(ring, pool, 2));
+    TEST_ASSERT_EQUAL(0, db_uring_read_fixed(ring, fd, 100, 0, NULL));
+    TEST_ASSERT_EQUAL(0, db_uring_read_fixed(ring, fd, 8192, 1000, NULL));
+    TEST_ASSERT_EQUAL(-1, db_uring_read_fixed(ring, fd, 100, 0, NULL));  // Both in use
+    TEST_ASSERT_EQUAL(2, db_uring_complete(ring, done, 8, 2));
+    db_buffer fixed = NULL;
+    for (size_t i = 0; i < 2; i++) {
+        TEST_ASSERT_EQUAL(DB_URING_READ, done[i].op);
+        if (done[i].result == 3000) {
+            TEST_ASSERT_EQUAL('b', done[i].buf[0]);
+            fixed = done[i].buf;
+        } else {
+            TEST_ASSERT_EQUAL(100, done[i].result);
+            TEST_ASSERT_EQUAL(100, db_size(done[i].buf));
+            db_release(&done[i].buf);
+        }
+    }
+    TEST_ASSERT_NOT_NULL(fixed);
+    
+    // Writing a registered buffer uses the fixed path; released buffers are reusable
+    TEST_ASSERT_EQUAL(0, db_uring_write(ring, fd, &fixed, 4000, NULL));
+    TEST_ASSERT_EQUAL(0, db_uring_read_fixed(ring, fd, 100, 0, NULL));
+    TEST_ASSERT_EQUAL(2, db_uring_complete(ring, done, 8, 2));
+    for (size_t i = 0; i < 2; i++) {
+        TEST_ASSERT_EQUAL(done[i].op == DB_URING_WRITE ? 3000 : 100, done[i].result);
+        db_release(&done[i].buf);
+    }
+    
+    // Release waits for anything still in flight
+    db_buffer last = db_new(0);
+    TEST_ASSERT_EQUAL(0, db_uring_read(ring, fd, &last, 100, 0, NULL));
+    db_uring_release(&ring);
+    TEST_ASSERT_NULL(ring);
+    db_pool_release(&pool);
+    
+    close(fd);
+    unlink(filename);
+}
+
+void test_uring_release_cancels_in_flight_requests(void) {
+    db_uring ring = db_uring_new(2);
+    if (!ring) TEST_IGNORE_MESSAGE("io_uring not available");
+    
+    int fds[2];
+    TEST_ASSERT_EQUAL(0, pipe(fds));
+    
+    // Reads on an empty pipe stay in flight until cancelled. Filling every slot
+    // submits some of them (the SQ is smaller) and leaves the rest queued.
+    db_buffer bufs[16];
+    size_t count = 0;
+    for (; count < 16; count++) {
+        bufs[count] = db_new(64);
+        db_buffer request = db_retain(bufs[count]);
+        if (db_uring_read(ring, fds[0], &request, 64, 0, NULL) != 0) {
+            db_release(&request);
+            db_release(&bufs[count]);
+            break;
+        }
+    }
+    TEST_ASSERT_TRUE(count >= 2 && count < 16);
+    TEST_ASSERT_EQUAL(count, db_uring_pending(ring));
+    
+    db_uring_release(&ring);
+    TEST_ASSERT_NULL(ring);
+    for (size_t i = 0; i < count; i++) {
+        TEST_ASSERT_EQUAL(1, db_refcount(bufs[i]));
+        db_release(&bufs[i]);
+    }
+    close(fds[0]);
+    close(fds[1]);
+}
+#endif
+
+void test_builder_readv_fills_tail_and_overflow(void) {
+    int fds[2];
+    TEST_ASSERT_EQUAL(0, pipe(fds));
+    
+    char payload[3000];
+    for (size_t i = 0; i < sizeof(payload); i++) payload[i] = (char)(i % 251);
+    TEST_ASSERT_EQUAL(sizeof(payload), write(fds[1], payload, sizeof(payload)));
+    
+    // 16 bytes of spare capacity, the rest spills into the overflow chunk
+    db_builder builder = db_builder_new(20);
+    TEST_ASSERT_EQUAL(0, db_builder_append(builder, "head", 4));
+    TEST_ASSERT_EQUAL(sizeof(payload), db_builder_readv(builder, fds[0], 0));
+    TEST_ASSERT_EQUAL(4 + sizeof(payload), db_builder_size(builder));
+    
+    close(fds[1]);
+    TEST_ASSERT_EQUAL(0, db_builder_readv(builder, fds[0], 0));  // EOF
+    close(fds[0]);
+    
+    db_buffer result = db_builder_finish(&builder);
+    TEST_ASSERT_EQUAL_MEMORY("head", result, 4);
+    TEST_ASSERT_EQUAL_MEMORY(payload, result + 4, sizeof(payload));
+    db_release(&result);
+}
+
+void test_builder_reserve_and_commit(void) {
+    db_builder builder = db_builder_new(4);
+    TEST_ASSERT_EQUAL(0, db_builder_append(builder, "ab", 2));
+    
+    // Reserve more than the spare capacity, write less than reserved
+    char* out = (char*)db_builder_reserve(builder, 10);
+    TEST_ASSERT_NOT_NULL(out);
+    TEST_ASSERT_TRUE(db_builder_capacity(builder) >= 12);
+    memcpy(out, "cdef", 4);
+    TEST_ASSERT_EQUAL(0, db_builder_commit(builder, 4));
+    TEST_ASSERT_EQUAL(6, db_builder_size(builder));
+    
+    // Committing past the capacity is rejected and leaves the size alone
+    TEST_ASSERT_EQUAL(-1, db_builder_commit(builder, db_builder_capacity(builder)));
+    TEST_ASSERT_EQUAL(6, db_builder_size(builder));
+    
+    db_buffer result = db_builder_finish(&builder);
+    TEST_ASSERT_EQUAL(6, db_size(result));
+    TEST_ASSERT_EQUAL_MEMORY("abcdef", result, 6);
+    db_release(&result);
+}
+
 void test_file_io_nonexistent_file(void) {
     // Test reading non-existent file
     db_buffer buf = db_read_file("/tmp/nonexistent_file_12345.bin");
@@ -890,19 +2267,381 @@ void test_file_io_nonexistent_file(void) {
     db_release(&test_buf);
 }
 
+// Chain tests
+void test_chain_append_prepend_and_flatten(void) {
+    db_buffer header = db_new_with_data("HDR:", 4);
+    db_buffer body = db_new_with_data("body", 4);
+    db_buffer trailer = db_new_with_data(";END", 4);
+    
+    db_chain chain = db_chain_new();
+    TEST_ASSERT_EQUAL(0, db_chain_count(chain));
+    db_chain_append(chain, body);
+    db_chain_append(chain, trailer);
+    db_chain_prepend(chain, header);
+    
+    TEST_ASSERT_EQUAL(3, db_chain_count(chain));
+    TEST_ASSERT_EQUAL(12, db_chain_size(chain));
+    TEST_ASSERT_EQUAL_PTR(header, db_chain_segment(chain, 0));
+    TEST_ASSERT_EQUAL_PTR(trailer, db_chain_segment(chain, 2));
+    TEST_ASSERT_EQUAL(2, db_refcount(body));  // Chain holds a reference
+    
+    db_buffer flat = db_chain_flatten(chain);
+    TEST_ASSERT_EQUAL_MEMORY("HDR:body;END", flat, 12);
+    TEST_ASSERT_EQUAL(1, db_chain_count(chain));
+    TEST_ASSERT_EQUAL(1, db_refcount(body));  // Segments dropped after flatten
+    
+    db_buffer again = db_chain_flatten(chain);
+    TEST_ASSERT_EQUAL_PTR(flat, again);  // No second copy
+    
+    db_release(&again);
+    db_release(&flat);
+    db_chain_release(&chain);
+    TEST_ASSERT_NULL(chain);
+    db_release(&header);
+    db_release(&body);
+    db_release(&trailer);
+}
+
+void test_chain_ring_growth_and_writev(void) {
+    db_chain chain = db_chain_new();
+    char expected[40];
+    
+    // Mix prepends and appends across ring growth
+    for (int i = 0; i < 20; i++) {
+        char c = (char)('a' + i);
+        db_buffer seg = db_new_with_data(&c, 1);
+        if (i % 2) db_chain_append(chain, seg);
+        else db_chain_prepend(chain, seg);
+        db_release(&seg);
+    }
+    for (int i = 0; i < 10; i++) expected[i] = (char)('a' + 18 - 2 * i);
+    for (int i = 0; i < 10; i++) expected[10 + i] = (char)('b' + 2 * i);
+    
+    int fds[2];
+    TEST_ASSERT_EQUAL(0, pipe(fds));
+    TEST_ASSERT_EQUAL(20, db_chain_write_fd(chain, fds[1]));
+    TEST_ASSERT_EQUAL(20, read(fds[0], expected + 20, 20));
+    TEST_ASSERT_EQUAL_MEMORY(expected, expected + 20, 20);
+    close(fds[0]);
+    close(fds[1]);
+    
+    db_chain_release(&chain);
+}
+
+void test_write_fdv_resumes_partial_writes(void) {
+    int fds[2];
+    TEST_ASSERT_EQUAL(0, pipe(fds));
+    TEST_ASSERT_EQUAL(0, fcntl(fds[1], F_SETFL, fcntl(fds[1], F_GETFL) | O_NONBLOCK));
+    
+    // More than a pipe can hold, so the first call must stop early
+    db_buffer bufs[4];
+    size_t total = 0;
+    for (int i = 0; i < 4; i++) {
+        size_t size = i == 2 ? 0 : 40000;
+        bufs[i] = db_new(size);
+        for (size_t j = 0; j < size; j++) {
+            char c = (char)('A' + i);
+            TEST_ASSERT_EQUAL(0, db_append_inplace(&bufs[i], &c, 1));
+        }
+        total += size;
+    }
+    
+    db_write_cursor cursor = DB_WRITE_CURSOR_INIT;
+    size_t sent = 0;
+    size_t received = 0;
+    char* out = malloc(total);
+    
+    while (cursor.index < 4) {
+        ssize_t n = db_write_fdv(fds[1], bufs, 4, &cursor);
+        TEST_ASSERT(n >= 0);
+        sent += (size_t)n;
+        // Drain what the pipe has so the next call can continue
+        while (received < sent) {
+            ssize_t r = read(fds[0], out + received, sent - received);
+            TEST_ASSERT(r > 0);
+            received += (size_t)r;
+        }
+    }
+    
+    TEST_ASSERT_EQUAL(total, sent);
+    TEST_ASSERT_EQUAL(0, cursor.offset);
+    TEST_ASSERT_EQUAL('A', out[0]);
+    TEST_ASSERT_EQUAL('B', out[40000]);
+    TEST_ASSERT_EQUAL('D', out[total - 1]);
+    
+    // Chains use the same cursor semantics
+    db_chain chain = db_chain_new();
+    db_chain_append(chain, bufs[1]);
+    db_chain_prepend(chain, bufs[2]);
+    db_write_cursor chain_cursor = DB_WRITE_CURSOR_INIT;
+    ssize_t n = db_chain_write_fdv(chain, fds[1], &chain_cursor);
+    TEST_ASSERT(n > 0);
+    TEST_ASSERT_EQUAL(n, read(fds[0], out, (size_t)n));
+    TEST_ASSERT_EQUAL('B', out[0]);
+    db_chain_release(&chain);
+    
+    free(out);
+    for (int i = 0; i < 4; i++) db_release(&bufs[i]);
+    close(fds[0]);
+    close(fds[1]);
+}
+
+#if DB_ATOMIC_REFCOUNT
+void test_spsc_queue_moves_ownership(void) {
+    db_spsc queue = db_spsc_new(3);
+    TEST_ASSERT_EQUAL(4, db_spsc_capacity(queue));
+    TEST_ASSERT_NULL(db_spsc_pop(queue));
+    
+    db_buffer bufs[5];
+    for (int i = 0; i < 5; i++) {
+        char c = (char)('a' + i);
+        bufs[i] = db_new_with_data(&c, 1);
+    }
+    
+    // Pushing moves the reference: no retain, and the buffer is shared
+    TEST_ASSERT_TRUE(db_spsc_push(queue, bufs[0]));
+    TEST_ASSERT_EQUAL(1, db_refcount(bufs[0]));
+    TEST_ASSERT_TRUE(db_is_shared(bufs[0]));
+    TEST_ASSERT_EQUAL(3, db_spsc_push_batch(queue, bufs + 1, 4));  // Only 3 slots left
+    TEST_ASSERT_EQUAL(4, db_spsc_size(queue));
+    TEST_ASSERT_FALSE(db_spsc_push(queue, bufs[4]));
+    
+    db_buffer out[4];
+    TEST_ASSERT_EQUAL(2, db_spsc_pop_batch(queue, out, 2));
+    TEST_ASSERT_EQUAL_PTR(bufs[0], out[0]);
+    TEST_ASSERT_EQUAL_PTR(bufs[1], out[1]);
+    db_release(&out[0]);
+    db_release(&out[1]);
+    
+    // Wraps around the ring
+    TEST_ASSERT_TRUE(db_spsc_push(queue, bufs[4]));
+    db_buffer next = db_spsc_pop(queue);
+    TEST_ASSERT_EQUAL('c', next[0]);
+    db_release(&next);
+    
+    // Releasing the queue releases what it still holds (checked by ASan)
+    db_spsc_release(&queue);
+    TEST_ASSERT_NULL(queue);
+}
+
+typedef struct {
+    db_spsc spsc;
+    db_mpmc mpmc;
+    uint32_t first;
+    uint32_t count;
+    uint64_t sum;
+    uint32_t popped;
+} queue_worker;
+
+static void* spsc_producer(void* arg) {
+    queue_worker* w = (queue_worker*)arg;
+    for (uint32_t i = 0; i < w->count; i++) {
+        db_buffer buf = db_new_with_data(&i, sizeof(i));
+        while (!db_spsc_push(w->spsc, buf)) sched_yield();
+    }
+    return NULL;
+}
+
+void test_spsc_queue_preserves_order_across_threads(void) {
+    queue_worker w = {db_spsc_new(64), NULL, 0, 20000, 0, 0};
+    pthread_t producer;
+    TEST_ASSERT_EQUAL(0, pthread_create(&producer, NULL, spsc_producer, &w));
+    
+    uint32_t expected = 0;
+    db_buffer batch[16];
+    while (expected < w.count) {
+        size_t n = db_spsc_pop_batch(w.spsc, batch, 16);
+        if (n == 0) sched_yield();
+        for (size_t i = 0; i < n; i++) {
+            uint32_t value;
+            memcpy(&value, batch[i], sizeof(value));
+            TEST_ASSERT_EQUAL_UINT32(expected++, value);
+            db_release(&batch[i]);
+        }
+    }
+    
+    pthread_join(producer, NULL);
+    TEST_ASSERT_EQUAL(0, db_spsc_size(w.spsc));
+    db_spsc_release(&w.spsc);
+}
+
+static void* mpmc_producer(void* arg) {
+    queue_worker* w = (queue_worker*)arg;
+    db_buffer batch[4];
+    for (uint32_t i = 0; i < w->count; i += 4) {
+        for (uint32_t k = 0; k < 4; k++) {
+            uint32_t value = w->first + i + k;
+            batch[k] = db_new_with_data(&value, sizeof(value));
+        }
+        size_t pushed = 0;
+        while (pushed < 4) {
+            size_t n = db_mpmc_push_batch(w->mpmc, batch + pushed, 4 - pushed);
+            if (n == 0) sched_yield();
+            pushed += n;
+        }
+    }
+    return NULL;
+}
+
+static void* mpmc_consumer(void* arg) {
+    queue_worker* w = (queue_worker*)arg;
+    while (w->popped < w->count) {
+        db_buffer buf = db_mpmc_pop(w->mpmc);
+        if (!buf) {
+            sched_yield();
+            continue;
+        }
+        uint32_t value;
+        memcpy(&value, buf, sizeof(value));
+        w->sum += value;
+        w->popped++;
+        db_release(&buf);
+    }
+    return NULL;
+}
+
+void test_mpmc_queue_delivers_every_buffer_once(void) {
+    db_mpmc queue = db_mpmc_new(100);
+    TEST_ASSERT_EQUAL(128, db_mpmc_capacity(queue));
+    
+    enum { THREADS = 4, PER_THREAD = 8000 };
+    queue_worker producers[THREADS], consumers[THREADS];
+    pthread_t threads[2 * THREADS];
+    for (int i = 0; i < THREADS; i++) {
+        producers[i] = (queue_worker){NULL, queue, (uint32_t)i * PER_THREAD, PER_THREAD, 0, 0};
+        consumers[i] = (queue_worker){NULL, queue, 0, PER_THREAD, 0, 0};
+        TEST_ASSERT_EQUAL(0, pthread_create(&threads[i], NULL, mpmc_producer, &producers[i]));
+        TEST_ASSERT_EQUAL(0, pthread_create(&threads[THREADS + i], NULL, mpmc_consumer, &consumers[i]));
+    }
+    for (int i = 0; i < 2 * THREADS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    
+    // Every value 0..N-1 arrived exactly once
+    uint64_t total = (uint64_t)THREADS * PER_THREAD;
+    uint64_t sum = 0;
+    for (int i = 0; i < THREADS; i++) sum += consumers[i].sum;
+    TEST_ASSERT_EQUAL_UINT64(total * (total - 1) / 2, sum);
+    TEST_ASSERT_EQUAL(0, db_mpmc_size(queue));
+    TEST_ASSERT_NULL(db_mpmc_pop(queue));
+    
+    // Batches pop in push order
+    db_buffer in[3] = {db_new_with_data("x", 1), db_new_with_data("y", 1), db_new_with_data("z", 1)};
+    TEST_ASSERT_EQUAL(3, db_mpmc_push_batch(queue, in, 3));
+    db_buffer out[8];
+    TEST_ASSERT_EQUAL(3, db_mpmc_pop_batch(queue, out, 8));
+    TEST_ASSERT_EQUAL('x', out[0][0]);
+    TEST_ASSERT_EQUAL('z', out[2][0]);
+    db_release(&out[0]);
+    
+    // Leftovers are released with the queue
+    TEST_ASSERT_EQUAL(2, db_mpmc_push_batch(queue, out + 1, 2));
+    db_mpmc_release(&queue);
+}
+#endif
+
+// Runs tasks in reverse order on the calling thread
+static void reverse_executor_run(void* user, db_task_fn task, void* arg, size_t count) {
+    size_t* runs = (size_t*)user;
+    for (size_t i = count; i-- > 0;) {
+        task(arg, i);
+    }
+    (*runs)++;
+}
+
+static void check_parallel_matches_serial(const db_parallel_config* config) {
+    // Uneven pieces so chunks straddle buffer boundaries, plus NULL and empty entries
+    db_buffer parts[6];
+    size_t sizes[6] = { 3000, 0, 17, 9999, 1, 2048 };
+    for (int i = 0; i < 6; i++) {
+        parts[i] = db_new(sizes[i]);
+        for (size_t j = 0; j < sizes[i]; j++) {
+            parts[i][j] = (char)(j * 31 + (size_t)i);
+        }
+        db_meta(parts[i])->size = sizes[i];
+    }
+    db_buffer with_gap[7] = { parts[0], parts[1], NULL, parts[2], parts[3], parts[4], parts[5] };
+    
+    db_buffer serial = db_concat_many(with_gap, 7);
+    db_buffer parallel = db_concat_many_parallel(with_gap, 7, config);
+    TEST_ASSERT_TRUE(db_equals(serial, parallel));
+    
+    db_buffer hex_serial = db_to_hex(serial, true);
+    db_buffer hex_parallel = db_to_hex_parallel(serial, true, config);
+    TEST_ASSERT_TRUE(db_equals(hex_serial, hex_parallel));
+    
+    TEST_ASSERT_TRUE(db_equals_parallel(serial, parallel, config));
+    parallel[db_size(parallel) - 1] ^= 1;  // Difference in the last chunk only
+    TEST_ASSERT_FALSE(db_equals_parallel(serial, parallel, config));
+    parallel[db_size(parallel) - 1] ^= 1;
+    parallel[0] ^= 1;
+    TEST_ASSERT_FALSE(db_equals_parallel(serial, parallel, config));
+    
+    db_release(&hex_parallel);
+    db_release(&hex_serial);
+    db_release(&parallel);
+    db_release(&serial);
+    for (int i = 0; i < 6; i++) db_release(&parts[i]);
+}
+
+void test_parallel_ops_match_serial_output(void) {
+    size_t runs = 0;
+    db_executor executor = { reverse_executor_run, &runs };
+    db_parallel_config config = {0};
+    config.executor = &executor;
+    config.threshold = 1024;
+    config.chunk_size = 1000;
+    
+    check_parallel_matches_serial(&config);
+    TEST_ASSERT_EQUAL(5, runs);  // concat, hex and three compares
+    
+    // Below the threshold the executor is never used
+    runs = 0;
+    config.threshold = 1 << 20;
+    check_parallel_matches_serial(&config);
+    TEST_ASSERT_EQUAL(0, runs);
+    check_parallel_matches_serial(NULL);
+}
+
+#if DB_THREAD_POOL
+void test_thread_pool_runs_parallel_ops(void) {
+    db_thread_pool pool = db_thread_pool_new(3);
+    TEST_ASSERT_EQUAL(3, db_thread_pool_size(pool));
+    
+    db_parallel_config config = {0};
+    config.executor = db_thread_pool_executor(pool);
+    config.threshold = 1024;
+    config.chunk_size = 64;
+    for (int round = 0; round < 20; round++) {
+        check_parallel_matches_serial(&config);
+    }
+    
+    db_thread_pool_release(&pool);
+    TEST_ASSERT_NULL(pool);
+}
+#endif
+
 int main(void) {
     UNITY_BEGIN();
     
     // Buffer creation tests
     RUN_TEST(test_db_new_creates_empty_buffer);
     RUN_TEST(test_db_new_creates_buffer_with_capacity);
+    RUN_TEST(test_db_header_keeps_data_aligned);
     RUN_TEST(test_db_new_with_data_copies_data);
     RUN_TEST(test_db_new_with_data_handles_null_data);
     RUN_TEST(test_db_new_with_data_rejects_invalid_params);
     RUN_TEST(test_db_new_from_owned_data_takes_ownership);
+    RUN_TEST(test_db_new_from_external_adopts_memory);
+    RUN_TEST(test_db_new_ex_uses_custom_allocator);
+    RUN_TEST(test_db_small_pool_recycles_blocks);
+    RUN_TEST(test_db_arena_allocates_and_resets);
+    RUN_TEST(test_db_pool_recycles_buffers);
+    RUN_TEST(test_db_pool_thread_cache);
     
     // Reference counting tests
     RUN_TEST(test_db_retain_increases_refcount);
+    RUN_TEST(test_db_share_switches_to_atomic_refcount);
     // RUN_TEST(test_db_retain_handles_null); // Removed - function now requires non-NULL
     RUN_TEST(test_db_release_handles_null);
     
@@ -919,10 +2658,13 @@ int main(void) {
     RUN_TEST(test_db_slice_handles_invalid_bounds);
     RUN_TEST(test_db_slice_from_creates_suffix);
     RUN_TEST(test_db_slice_to_creates_prefix);
+    RUN_TEST(test_db_slice_full_range_shares_buffer);
     
     // Modification tests
     RUN_TEST(test_db_append_creates_new_buffer);
     RUN_TEST(test_db_append_handles_empty_data_immutable);
+    RUN_TEST(test_db_append_inplace_grows_unique_buffer);
+    RUN_TEST(test_db_append_inplace_copies_shared_buffer);
     
     // Concatenation tests
     RUN_TEST(test_db_concat_joins_buffers);
@@ -933,25 +2675,50 @@ int main(void) {
     RUN_TEST(test_db_equals_compares_contents);
     // RUN_TEST(test_db_equals_handles_null_buffers); // Removed - function now requires non-NULL
     RUN_TEST(test_db_compare_returns_correct_order);
+    RUN_TEST(test_db_mismatch_finds_first_difference);
+    RUN_TEST(test_db_find_matches_naive_search);
+    RUN_TEST(test_db_split_iterates_pieces);
+    RUN_TEST(test_db_crc32c_known_vectors);
+    RUN_TEST(test_db_hash_matches_xxh64);
     
     // Utility tests
     RUN_TEST(test_db_to_hex_converts_correctly);
     RUN_TEST(test_db_from_hex_converts_correctly);
     RUN_TEST(test_db_from_hex_handles_invalid_input);
+    RUN_TEST(test_db_hex_matches_reference_across_lengths);
+    RUN_TEST(test_db_from_hex_rejects_invalid_char_anywhere);
+    RUN_TEST(test_db_base64_matches_rfc4648_vectors);
+    RUN_TEST(test_db_base64_roundtrips_across_lengths);
     RUN_TEST(test_db_debug_print_doesnt_crash);
+    RUN_TEST(test_db_stats_counts_allocations_and_copies);
     
     // I/O function tests
     RUN_TEST(test_file_io_operations);
     RUN_TEST(test_file_io_nonexistent_file);
+    RUN_TEST(test_db_read_file_sizes_buffer_exactly);
+    RUN_TEST(test_db_read_fd_appends_stream);
+#if DB_IO_URING
+    RUN_TEST(test_uring_batched_reads_and_writes);
+    RUN_TEST(test_uring_release_cancels_in_flight_requests);
+#endif
+    RUN_TEST(test_db_map_file_maps_without_copy);
+    RUN_TEST(test_db_file_stream_chunks_and_carries_records);
+    RUN_TEST(test_builder_readv_fills_tail_and_overflow);
+    RUN_TEST(test_builder_reserve_and_commit);
     
     // Builder API tests
     RUN_TEST(test_builder_basic_operations);
     RUN_TEST(test_builder_write_primitives);
     RUN_TEST(test_builder_write_endianness);
+    RUN_TEST(test_builder_append_base64_streams);
     RUN_TEST(test_builder_from_buffer);
     RUN_TEST(test_builder_clear_operations);
+    RUN_TEST(test_builder_clear_reuses_buffer);
+    RUN_TEST(test_builder_from_buffer_take);
     RUN_TEST(test_builder_append_functions);
     RUN_TEST(test_builder_capacity_growth);
+    RUN_TEST(test_builder_growth_policy);
+    RUN_TEST(test_builder_shrink_on_finish);
     
     // Builder reference counting tests
     RUN_TEST(test_builder_reference_counting);
@@ -965,14 +2732,38 @@ int main(void) {
     RUN_TEST(test_reader_seek_operations);
     RUN_TEST(test_reader_missing_functions);
     RUN_TEST(test_reader_edge_cases);
+    RUN_TEST(test_reader_range_reads_in_place);
+    RUN_TEST(test_reader_borrowed_reads);
+    RUN_TEST(test_cursor_unchecked_reads);
     
     // Reader reference counting tests
     RUN_TEST(test_reader_reference_counting);
     RUN_TEST(test_reader_release_null_handling);
     RUN_TEST(test_reader_free_legacy_compatibility);
     
+    // Chain tests
+    RUN_TEST(test_chain_append_prepend_and_flatten);
+    RUN_TEST(test_chain_ring_growth_and_writev);
+    RUN_TEST(test_write_fdv_resumes_partial_writes);
+#if DB_ATOMIC_REFCOUNT
+    
+    // Queue tests
+    RUN_TEST(test_spsc_queue_moves_ownership);
+    RUN_TEST(test_spsc_queue_preserves_order_across_threads);
+    RUN_TEST(test_mpmc_queue_delivers_every_buffer_once);
+#endif
+    
+    // Parallel bulk operation tests
+    RUN_TEST(test_parallel_ops_match_serial_output);
+#if DB_THREAD_POOL
+    RUN_TEST(test_thread_pool_runs_parallel_ops);
+#endif
+    
     // Builder + Reader integration tests
     RUN_TEST(test_builder_reader_roundtrip);
+    RUN_TEST(test_varint_roundtrip);
+    RUN_TEST(test_read_varints_bulk);
+    RUN_TEST(test_typed_array_roundtrip);
     
     // Edge case tests
     RUN_TEST(test_large_buffer_operations);